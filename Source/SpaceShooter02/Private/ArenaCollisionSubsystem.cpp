@@ -0,0 +1,211 @@
+// Copyright 2024 Richard Skala
+
+#include "ArenaCollisionSubsystem.h"
+
+#include "EngineUtils.h"
+
+#include "LevelBorder.h"
+#include "SpaceShooter02.h"
+#include "SpaceShooterLevelScriptActor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Arena Segment Queries"), STAT_ArenaSegmentQueries, STATGROUP_SpaceShooter);
+
+DEFINE_LOG_CATEGORY_STATIC(LogArenaCollision, Log, All)
+
+namespace
+{
+	// Returns true if the point is inside the box on the XZ plane
+	FORCEINLINE bool IsPointInBoxXZ(const FVector& Point, const FBox& Box)
+	{
+		return Point.X >= Box.Min.X && Point.X <= Box.Max.X && Point.Z >= Box.Min.Z && Point.Z <= Box.Max.Z;
+	}
+}
+
+bool UArenaCollisionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UArenaCollisionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Level borders never move, so their geometry is only read once
+	CacheArenaGeometry();
+}
+
+void UArenaCollisionSubsystem::CacheArenaGeometry()
+{
+	BorderBoxes.Reset();
+	ArenaBounds = FBox(ForceInit);
+
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	for (TActorIterator<ALevelBorder> It(World); It; ++It)
+	{
+		const FBox BorderBox = It->GetBorderBounds();
+		if (BorderBox.IsValid)
+		{
+			BorderBoxes.Add(BorderBox);
+			ArenaBounds += BorderBox;
+		}
+	}
+
+	// Without level borders, fall back to the level bounding box
+	if (BorderBoxes.Num() > 0)
+	{
+		UE_LOG(LogArenaCollision, Log, TEXT("Cached %d level borders. Arena bounds: %s"), BorderBoxes.Num(), *ArenaBounds.ToString());
+	}
+	else if (ASpaceShooterLevelScriptActor* LevelScriptActor = Cast<ASpaceShooterLevelScriptActor>(World->GetLevelScriptActor()))
+	{
+		FVector LevelBoundingBoxPosition, LevelBoundingBoxExtent;
+		LevelScriptActor->GetLevelBoundingBoxPositionAndExtent(LevelBoundingBoxPosition, LevelBoundingBoxExtent);
+		if (!LevelBoundingBoxExtent.IsNearlyZero())
+		{
+			ArenaBounds = FBox::BuildAABB(LevelBoundingBoxPosition, LevelBoundingBoxExtent);
+		}
+		UE_LOG(LogArenaCollision, Warning, TEXT("No level borders found. Arena bounds (level bounding box): %s"), *ArenaBounds.ToString());
+	}
+}
+
+bool UArenaCollisionSubsystem::IsPointInArena(const FVector& Point) const
+{
+	if (ArenaBounds.IsValid && !IsPointInBoxXZ(Point, ArenaBounds))
+	{
+		return false;
+	}
+
+	for (const FBox& BorderBox : BorderBoxes)
+	{
+		if (IsPointInBoxXZ(Point, BorderBox))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool UArenaCollisionSubsystem::SegmentVsArena(const FVector& Start, const FVector& End, FArenaHit& OutHit) const
+{
+	const FVector Delta = End - Start;
+
+	bool bHit = false;
+	float BestTime = 1.0f;
+	FVector BestNormal = FVector::ZeroVector;
+	for (const FBox& BorderBox : BorderBoxes)
+	{
+		float Time;
+		FVector Normal;
+		if (SegmentVsBox(Start, Delta, BorderBox, Time, Normal) && (!bHit || Time < BestTime))
+		{
+			bHit = true;
+			BestTime = Time;
+			BestNormal = Normal;
+		}
+	}
+
+	if (bHit)
+	{
+		OutHit.Time = BestTime;
+		OutHit.ImpactPoint = Start + Delta * BestTime;
+		OutHit.ImpactNormal = BestNormal;
+	}
+
+	return bHit;
+}
+
+int32 UArenaCollisionSubsystem::SegmentsVsArena(TConstArrayView<FVector> Starts, TConstArrayView<FVector> Ends, TArray<FArenaHit>& OutHits) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_ArenaSegmentQueries);
+
+	if (!ensure(Starts.Num() == Ends.Num()))
+	{
+		return 0;
+	}
+
+	int32 NumHits = 0;
+	for (int32 i = 0; i < Starts.Num(); ++i)
+	{
+		FArenaHit Hit;
+		if (SegmentVsArena(Starts[i], Ends[i], Hit))
+		{
+			Hit.SegmentIndex = i;
+			OutHits.Add(Hit);
+			++NumHits;
+		}
+	}
+	return NumHits;
+}
+
+int32 UArenaCollisionSubsystem::PointsOutsideArena(TConstArrayView<FVector> Points, TArray<int32>& OutPointIndices) const
+{
+	int32 NumOutside = 0;
+	for (int32 i = 0; i < Points.Num(); ++i)
+	{
+		if (!IsPointInArena(Points[i]))
+		{
+			OutPointIndices.Add(i);
+			++NumOutside;
+		}
+	}
+	return NumOutside;
+}
+
+bool UArenaCollisionSubsystem::SegmentVsBox(const FVector& Start, const FVector& Delta, const FBox& Box, float& OutTime, FVector& OutNormal)
+{
+	double EnterTime = 0.0;
+	double ExitTime = 1.0;
+	FVector EnterNormal = FVector::ZeroVector;
+
+	// Slabs on the X and Z axes
+	for (const int32 Axis : { 0, 2 })
+	{
+		const double AxisStart = Start[Axis];
+		const double AxisDelta = Delta[Axis];
+		if (FMath::IsNearlyZero(AxisDelta))
+		{
+			// Parallel to this slab. Misses unless already between its planes.
+			if (AxisStart < Box.Min[Axis] || AxisStart > Box.Max[Axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		double NearTime = (Box.Min[Axis] - AxisStart) / AxisDelta;
+		double FarTime = (Box.Max[Axis] - AxisStart) / AxisDelta;
+		double NormalSign = -1.0; // Moving towards +Axis enters through the Min face
+		if (NearTime > FarTime)
+		{
+			Swap(NearTime, FarTime);
+			NormalSign = 1.0;
+		}
+
+		if (NearTime > EnterTime)
+		{
+			EnterTime = NearTime;
+			EnterNormal = FVector::ZeroVector;
+			EnterNormal[Axis] = NormalSign;
+		}
+		ExitTime = FMath::Min(ExitTime, FarTime);
+
+		if (EnterTime > ExitTime)
+		{
+			return false;
+		}
+	}
+
+	// Started inside the box. Push back against the movement.
+	if (EnterNormal.IsZero())
+	{
+		EnterNormal = FVector(-Delta.X, 0.0, -Delta.Z).GetSafeNormal();
+	}
+
+	OutTime = static_cast<float>(EnterTime);
+	OutNormal = EnterNormal;
+	return true;
+}
@@ -0,0 +1,74 @@
+// Copyright 2024 Richard Skala
+
+#include "BulletPatternAsset.h"
+
+namespace
+{
+	// Keeps a looping pattern without delays from starting over several times in one frame
+	static constexpr float MinPatternDurationSeconds = 0.1f;
+}
+
+void UBulletPatternAsset::PostLoad()
+{
+	Super::PostLoad();
+	CompilePattern();
+}
+
+#if WITH_EDITOR
+void UBulletPatternAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	CompilePattern();
+}
+#endif
+
+void UBulletPatternAsset::CompilePattern()
+{
+	Instructions.Reset();
+
+	float StepStartTimeSeconds = 0.0f;
+	for (const FBulletPatternStep& Step : Steps)
+	{
+		const int32 NumBullets = FMath::Max(Step.NumBullets, 1);
+		const int32 NumRepetitions = FMath::Max(Step.Repetitions, 1);
+
+		float LastBulletTimeSeconds = StepStartTimeSeconds;
+		for (int32 Repetition = 0; Repetition < NumRepetitions; ++Repetition)
+		{
+			const float RepetitionTimeSeconds = StepStartTimeSeconds + Repetition * Step.RepeatIntervalSeconds;
+			for (int32 BulletIndex = 0; BulletIndex < NumBullets; ++BulletIndex)
+			{
+				FBulletSpawnInstruction Instruction;
+				Instruction.TimeSeconds = RepetitionTimeSeconds;
+				Instruction.Speed = Step.BulletSpeed;
+
+				float AngleDegrees = Step.AngleOffsetDegrees;
+				switch (Step.Shape)
+				{
+				case EBulletPatternShape::Ring:
+					AngleDegrees += Repetition * Step.AngleStepDegrees + BulletIndex * 360.0f / NumBullets;
+					break;
+				case EBulletPatternShape::Spiral:
+					// Each repetition carries on turning from where the last one stopped
+					Instruction.TimeSeconds += BulletIndex * Step.BulletIntervalSeconds;
+					AngleDegrees += (Repetition * NumBullets + BulletIndex) * Step.AngleStepDegrees;
+					break;
+				case EBulletPatternShape::AimedBurst:
+					Instruction.bAimed = true;
+					AngleDegrees += NumBullets > 1 ? Step.SpreadDegrees * (static_cast<float>(BulletIndex) / (NumBullets - 1) - 0.5f) : 0.0f;
+					break;
+				}
+				Instruction.AngleRadians = FMath::DegreesToRadians(AngleDegrees);
+
+				LastBulletTimeSeconds = FMath::Max(LastBulletTimeSeconds, Instruction.TimeSeconds);
+				Instructions.Add(Instruction);
+			}
+		}
+
+		StepStartTimeSeconds = LastBulletTimeSeconds + Step.DelayAfterSeconds;
+	}
+
+	// A spiral can outlast its repeat interval, so bullets are not always added in time order
+	Instructions.StableSort([](const FBulletSpawnInstruction& A, const FBulletSpawnInstruction& B) { return A.TimeSeconds < B.TimeSeconds; });
+	PatternDurationSeconds = FMath::Max(StepStartTimeSeconds, MinPatternDurationSeconds);
+}
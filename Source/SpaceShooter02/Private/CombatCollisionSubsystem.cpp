@@ -0,0 +1,473 @@
+// Copyright 2024 Richard Skala
+
+#include "CombatCollisionSubsystem.h"
+
+#include "Async/ParallelFor.h"
+
+#include "ArenaCollisionSubsystem.h"
+#include "EnemyBase.h"
+#include "EnemyFlocking.h"
+#include "PlayerShipPawn.h"
+#include "ProjectileBase.h"
+#include "ProjectileManager.h"
+#include "SpaceShooter02.h"
+#include "SpaceShooterPoolSubsystem.h"
+#include "SweptCollision2D.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Grid Build"), STAT_EnemyGridBuild, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Projectile Hit Queries"), STAT_ProjectileHitQueries, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Circle Projectile Kernel"), STAT_CircleProjectileKernel, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Oriented Box Projectile Kernel"), STAT_OrientedBoxProjectileKernel, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Dash Hit Queries"), STAT_DashHitQueries, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Enemy Bullet Hit Queries"), STAT_EnemyBulletHitQueries, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Nearest Enemy Queries"), STAT_NearestEnemyQueries, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Enemy Flocking"), STAT_EnemyFlocking, STATGROUP_SpaceShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies In Grid"), STAT_NumGridEnemies, STATGROUP_SpaceShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Hit Queries"), STAT_NumProjectileHitQueries, STATGROUP_SpaceShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Circle Projectile Hit Tests"), STAT_NumCircleProjectileHitTests, STATGROUP_SpaceShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Oriented Box Projectile Hit Tests"), STAT_NumOrientedBoxProjectileHitTests, STATGROUP_SpaceShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Bullets"), STAT_NumEnemyBullets, STATGROUP_SpaceShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nearest Enemy Queries"), STAT_NumNearestEnemyQueries, STATGROUP_SpaceShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Flocking Enemies"), STAT_NumFlockingEnemies, STATGROUP_SpaceShooter);
+
+DEFINE_LOG_CATEGORY_STATIC(LogCombatCollision, Log, All)
+
+namespace
+{
+	// Minimum number of nearest enemy queries given to one worker
+	static constexpr int32 NearestEnemyQueryBatchSize = 64;
+
+	// Smaller cells would put every enemy in many cells
+	static constexpr float MinEnemyGridCellSize = 10.0f;
+
+	FVector2D ToPlanePosition(const FVector& Position)
+	{
+		// The game is played on the XZ plane
+		return FVector2D(Position.X, Position.Z);
+	}
+}
+
+bool UCombatCollisionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatCollisionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Runs after every actor has ticked, so enemies and projectiles are at their positions for this frame
+	if (!EnemyGrid.IsInitialized() && !InitEnemyGrid())
+	{
+		return;
+	}
+
+	RebuildEnemyGrid();
+	UpdateEnemyFlocking();
+	ResolveDashHits();
+	ResolveProjectileHits();
+	ResolveEnemyBulletHits();
+}
+
+void UCombatCollisionSubsystem::RegisterProjectileManager(AProjectileManager* ProjectileManager)
+{
+	ProjectileManagers.AddUnique(ProjectileManager);
+}
+
+void UCombatCollisionSubsystem::UnregisterProjectileManager(AProjectileManager* ProjectileManager)
+{
+	ProjectileManagers.Remove(ProjectileManager);
+}
+
+int32 UCombatCollisionSubsystem::SweepCircleVsEnemies(const FVector& Start, const FVector& End, float Radius, TArray<FEnemySweepHit>& OutHits) const
+{
+	const int32 NumHitsBefore = OutHits.Num();
+	const FVector2D Start2D = ToPlanePosition(Start);
+	ForEachEnemySweepHit(FCircleProjectileShape{ Radius }, Start2D, ToPlanePosition(End) - Start2D, [&OutHits](int32 EnemyIndex, float Time)
+	{
+		OutHits.Add({ EnemyIndex, Time });
+	});
+	return OutHits.Num() - NumHitsBefore;
+}
+
+AEnemyBase* UCombatCollisionSubsystem::FindNearestEnemy(const FVector& Position, float MaxDistance) const
+{
+	// Enemies destroyed since the grid was built are skipped
+	const int32 EnemyIndex = EnemyGrid.FindNearest(ToPlanePosition(Position), MaxDistance, [this](int32 ItemIndex)
+	{
+		return GridEnemies[ItemIndex]->IsPoolObjectActive();
+	});
+	return EnemyIndex != INDEX_NONE ? GridEnemies[EnemyIndex] : nullptr;
+}
+
+void UCombatCollisionSubsystem::FindNearestEnemies(TConstArrayView<FVector> Positions, float MaxDistance, TArrayView<AEnemyBase*> OutEnemies) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_NearestEnemyQueries);
+
+	if (!ensure(Positions.Num() == OutEnemies.Num()))
+	{
+		return;
+	}
+
+	// Queries only read the grid, so they can run on any thread. Small batches are not worth waking the workers for.
+	ParallelFor(TEXT("FindNearestEnemies"), Positions.Num(), NearestEnemyQueryBatchSize, [this, Positions, MaxDistance, OutEnemies](int32 Index)
+	{
+		OutEnemies[Index] = FindNearestEnemy(Positions[Index], MaxDistance);
+	});
+
+	const int32 NumQueries = Positions.Num();
+	INC_DWORD_STAT_BY(STAT_NumNearestEnemyQueries, NumQueries);
+}
+
+void UCombatCollisionSubsystem::ResetNearestEnemyQueries()
+{
+	NearestEnemyQueryPositions.Reset();
+	NearestEnemyQueryResults.Reset();
+}
+
+void UCombatCollisionSubsystem::RunNearestEnemyQueries(float MaxDistance)
+{
+	NearestEnemyQueryResults.SetNumUninitialized(NearestEnemyQueryPositions.Num(), EAllowShrinking::No);
+	FindNearestEnemies(NearestEnemyQueryPositions, MaxDistance, NearestEnemyQueryResults);
+}
+
+template<typename ShapeType, typename FunctionType>
+int32 UCombatCollisionSubsystem::ForEachEnemySweepHit(const ShapeType& Shape, const FVector2D& Start, const FVector2D& Delta, FunctionType&& Function) const
+{
+	// Only the enemies in the cells around the swept shape can be touched
+	const FVector2D BoundsExtent = Shape.GetBoundsExtent();
+	const FBox2D SweepBounds(
+		FVector2D::Min(Start, Start + Delta) - BoundsExtent,
+		FVector2D::Max(Start, Start + Delta) + BoundsExtent);
+
+	int32 NumHitTests = 0;
+	EnemyGrid.ForEachCandidateInBox(SweepBounds, [this, &Shape, &Start, &Delta, &Function, &NumHitTests](int32 EnemyIndex)
+	{
+		++NumHitTests;
+		float Time = 0.0f;
+		if (Shape.SweepVsBox(Start, Delta, EnemyPositions[EnemyIndex], EnemyHalfExtents[EnemyIndex], Time))
+		{
+			Function(EnemyIndex, Time);
+		}
+	});
+	return NumHitTests;
+}
+
+template<typename ShapeType>
+int32 UCombatCollisionSubsystem::SweepProjectileBatch(const TProjectileBatch<ShapeType>& Batch)
+{
+	int32 NumHitTests = 0;
+	for (int32 i = 0; i < Batch.Num(); ++i)
+	{
+		const int32 ProjectileIndex = Batch.ProjectileIndices[i];
+		NumHitTests += ForEachEnemySweepHit(Batch.Shapes[i], Batch.Starts[i], Batch.Deltas[i], [this, ProjectileIndex](int32 EnemyIndex, float Time)
+		{
+			ProjectileHits.Add({ ProjectileIndex, EnemyIndex, Time });
+		});
+	}
+	return NumHitTests;
+}
+
+bool UCombatCollisionSubsystem::InitEnemyGrid()
+{
+	UArenaCollisionSubsystem* ArenaCollision = UWorld::GetSubsystem<UArenaCollisionSubsystem>(GetWorld());
+	if (ArenaCollision == nullptr || !ArenaCollision->GetArenaBounds().IsValid)
+	{
+		return false;
+	}
+
+	const FBox& ArenaBounds = ArenaCollision->GetArenaBounds();
+	const float CellSize = FMath::Max(EnemyGridCellSize, MinEnemyGridCellSize);
+	EnemyGrid.Init(FBox2D(ToPlanePosition(ArenaBounds.Min), ToPlanePosition(ArenaBounds.Max)), CellSize);
+
+	UE_LOG(LogCombatCollision, Log, TEXT("Enemy grid initialized over %s with %.0f unit cells"), *ArenaBounds.ToString(), CellSize);
+	return true;
+}
+
+void UCombatCollisionSubsystem::RebuildEnemyGrid()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyGridBuild);
+
+	GridEnemies.Reset();
+	if (USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld()))
+	{
+		PoolSubsystem->GetActivePoolActors<AEnemyBase>(GridEnemies);
+	}
+
+	// Enemies that are spawning in, or were destroyed this frame, cannot be hit
+	GridEnemies.RemoveAllSwap([](const AEnemyBase* Enemy) { return !Enemy->IsPoolObjectActive() || !Enemy->GetActorEnableCollision(); }, EAllowShrinking::No);
+
+	EnemyPositions.Reset(GridEnemies.Num());
+	EnemyHalfExtents.Reset(GridEnemies.Num());
+	EnemyRadii.Reset(GridEnemies.Num());
+	for (const AEnemyBase* Enemy : GridEnemies)
+	{
+		const FVector2D HalfExtent = Enemy->GetCollisionHalfExtent();
+		EnemyPositions.Add(ToPlanePosition(Enemy->GetActorLocation()));
+		EnemyHalfExtents.Add(HalfExtent);
+
+		// The grid stores circles enclosing the bounding boxes
+		EnemyRadii.Add(static_cast<float>(HalfExtent.Size()));
+	}
+
+	EnemyGrid.Build(EnemyPositions, EnemyRadii);
+	SET_DWORD_STAT(STAT_NumGridEnemies, GridEnemies.Num());
+}
+
+void UCombatCollisionSubsystem::UpdateEnemyFlocking()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyFlocking);
+
+	const int32 NumEnemies = GridEnemies.Num();
+	EnemyVelocities.Reset(NumEnemies);
+	EnemyFlockingSettings.Reset(NumEnemies);
+	int32 NumFlockingEnemies = 0;
+	for (const AEnemyBase* Enemy : GridEnemies)
+	{
+		const FVector& Velocity = Enemy->GetMovementVelocity();
+		EnemyVelocities.Add(FVector2D(Velocity.X, Velocity.Z));
+
+		const FEnemyFlockingSettings& FlockingSettings = Enemy->GetFlockingSettings();
+		EnemyFlockingSettings.Add(FlockingSettings.bEnableFlocking ? &FlockingSettings : nullptr);
+		NumFlockingEnemies += FlockingSettings.bEnableFlocking ? 1 : 0;
+	}
+
+	if (NumFlockingEnemies == 0)
+	{
+		return;
+	}
+
+	EnemyFlockingSteering.SetNumUninitialized(NumEnemies, EAllowShrinking::No);
+	FEnemyFlocking::ComputeSteering(EnemyGrid, EnemyVelocities, EnemyFlockingSettings, EnemyFlockingSteering);
+
+	for (int32 EnemyIndex = 0; EnemyIndex < NumEnemies; ++EnemyIndex)
+	{
+		if (EnemyFlockingSettings[EnemyIndex] != nullptr)
+		{
+			const FVector2D& Steering = EnemyFlockingSteering[EnemyIndex];
+			GridEnemies[EnemyIndex]->SetFlockingSteering(FVector(Steering.X, 0.0, Steering.Y));
+		}
+	}
+
+	SET_DWORD_STAT(STAT_NumFlockingEnemies, NumFlockingEnemies);
+}
+
+void UCombatCollisionSubsystem::ResolveEnemyBulletHits()
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyBulletHitQueries);
+
+	APlayerShipPawn* PlayerShipPawn = PlayerShip.Get();
+	if (PlayerShipPawn == nullptr || PlayerShipPawn->GetPlayerDead())
+	{
+		return;
+	}
+
+	// Work relative to the player ship, so a bullet and the moving ship can not pass through each other
+	const FVector2D PlayerStart = ToPlanePosition(PlayerShipPawn->GetMovementStartLocation());
+	const FVector2D PlayerDelta = ToPlanePosition(PlayerShipPawn->GetActorLocation()) - PlayerStart;
+	const float PlayerRadius = PlayerShipPawn->GetCollisionRadius();
+
+	int32 NumBullets = 0;
+	for (const TWeakObjectPtr<AProjectileManager>& ProjectileManagerPtr : ProjectileManagers)
+	{
+		AProjectileManager* BulletManager = ProjectileManagerPtr.Get();
+		if (BulletManager == nullptr || BulletManager->GetTarget() != EProjectileManagerTarget::Player)
+		{
+			continue;
+		}
+
+		// Bullets are tested as points against the ship's circle grown by the bullet radius
+		const float HitRadius = PlayerRadius + BulletManager->GetCollisionRadius();
+		const TConstArrayView<FVector> PreviousPositions = BulletManager->GetProjectilePreviousPositions();
+		const TConstArrayView<FVector> Positions = BulletManager->GetProjectilePositions();
+		NumBullets += Positions.Num();
+		for (int32 i = 0; i < Positions.Num(); ++i)
+		{
+			const FVector2D BulletStart = ToPlanePosition(PreviousPositions[i]);
+			const FVector2D BulletDelta = ToPlanePosition(Positions[i]) - BulletStart;
+			float Time = 0.0f;
+			if (FSweptCollision2D::SegmentVsCircle(BulletStart - PlayerStart, BulletDelta - PlayerDelta, FVector2D::ZeroVector, HitRadius, Time))
+			{
+				BulletManager->ExpireProjectile(i);
+				PlayerShipPawn->OnEnemyBulletHit();
+				if (PlayerShipPawn->GetPlayerDead())
+				{
+					break;
+				}
+			}
+		}
+	}
+	SET_DWORD_STAT(STAT_NumEnemyBullets, NumBullets);
+}
+
+void UCombatCollisionSubsystem::GatherProjectileBatches()
+{
+	CircleProjectiles.Reset();
+	OrientedBoxProjectiles.Reset();
+
+	// Pooled projectile actors. The shape is read from the class defaults, once per pool.
+	PooledProjectiles.Reset();
+	if (USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld()))
+	{
+		PoolSubsystem->ForEachPool<AProjectileBase>([this](TSubclassOf<APoolActor> PoolActorClass, const TPoolActorContainer<APoolActor>& Pool)
+		{
+			const AProjectileBase* ProjectileCDO = PoolActorClass->GetDefaultObject<AProjectileBase>();
+			switch (ProjectileCDO->GetProjectileShape())
+			{
+			case EProjectileShape::Circle:
+			{
+				const FCircleProjectileShape Shape{ ProjectileCDO->GetCollisionRadius() };
+				Pool.ForEachActive([this, &Shape](APoolActor* PoolActor)
+				{
+					AProjectileBase* Projectile = static_cast<AProjectileBase*>(PoolActor);
+					const int32 ProjectileIndex = PooledProjectiles.Add(Projectile);
+					CircleProjectiles.Add(Shape, ToPlanePosition(Projectile->GetMovementStartLocation()), ToPlanePosition(Projectile->GetActorLocation()), ProjectileIndex);
+				});
+				break;
+			}
+			case EProjectileShape::OrientedBox:
+			{
+				const FVector2D HalfExtent = ProjectileCDO->GetCollisionHalfExtent();
+				Pool.ForEachActive([this, &HalfExtent](APoolActor* PoolActor)
+				{
+					AProjectileBase* Projectile = static_cast<AProjectileBase*>(PoolActor);
+					const int32 ProjectileIndex = PooledProjectiles.Add(Projectile);
+					const FOrientedBoxProjectileShape Shape{ ToPlanePosition(Projectile->GetActorUpVector()).GetSafeNormal(), HalfExtent };
+					OrientedBoxProjectiles.Add(Shape, ToPlanePosition(Projectile->GetMovementStartLocation()), ToPlanePosition(Projectile->GetActorLocation()), ProjectileIndex);
+				});
+				break;
+			}
+			}
+		});
+	}
+
+	// Projectiles simulated by projectile managers. Every projectile of a manager has the same shape.
+	// They are indexed after the pooled projectiles, with each manager's projectiles in one consecutive range.
+	ManagedProjectileRanges.Reset();
+	int32 NextProjectileIndex = PooledProjectiles.Num();
+	for (const TWeakObjectPtr<AProjectileManager>& ProjectileManagerPtr : ProjectileManagers)
+	{
+		AProjectileManager* ProjectileManager = ProjectileManagerPtr.Get();
+		if (ProjectileManager == nullptr || ProjectileManager->GetTarget() != EProjectileManagerTarget::Enemies)
+		{
+			continue;
+		}
+
+		const int32 FirstProjectileIndex = NextProjectileIndex;
+		NextProjectileIndex += ProjectileManager->GetNumProjectiles();
+		ManagedProjectileRanges.Add({ ProjectileManager, FirstProjectileIndex });
+
+		const TConstArrayView<FVector> PreviousPositions = ProjectileManager->GetProjectilePreviousPositions();
+		const TConstArrayView<FVector> Positions = ProjectileManager->GetProjectilePositions();
+		switch (ProjectileManager->GetProjectileShape())
+		{
+		case EProjectileShape::Circle:
+		{
+			const FCircleProjectileShape Shape{ ProjectileManager->GetCollisionRadius() };
+			for (int32 i = 0; i < Positions.Num(); ++i)
+			{
+				CircleProjectiles.Add(Shape, ToPlanePosition(PreviousPositions[i]), ToPlanePosition(Positions[i]), FirstProjectileIndex + i);
+			}
+			break;
+		}
+		case EProjectileShape::OrientedBox:
+		{
+			const FVector2D HalfExtent = ProjectileManager->GetCollisionHalfExtent();
+			const TConstArrayView<FVector> Directions = ProjectileManager->GetProjectileDirections();
+			for (int32 i = 0; i < Positions.Num(); ++i)
+			{
+				const FOrientedBoxProjectileShape Shape{ ToPlanePosition(Directions[i]).GetSafeNormal(), HalfExtent };
+				OrientedBoxProjectiles.Add(Shape, ToPlanePosition(PreviousPositions[i]), ToPlanePosition(Positions[i]), FirstProjectileIndex + i);
+			}
+			break;
+		}
+		}
+	}
+}
+
+void UCombatCollisionSubsystem::ResolveProjectileHits()
+{
+	if (GridEnemies.Num() == 0)
+	{
+		return;
+	}
+
+	ProjectileHits.Reset();
+	int32 NumQueries = 0;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ProjectileHitQueries);
+
+		GatherProjectileBatches();
+		NumQueries = CircleProjectiles.Num() + OrientedBoxProjectiles.Num();
+
+		// One kernel per shape. Kernel time divided by its hit tests is the cost of one test.
+		{
+			SCOPE_CYCLE_COUNTER(STAT_CircleProjectileKernel);
+			const int32 NumHitTests = SweepProjectileBatch(CircleProjectiles);
+			SET_DWORD_STAT(STAT_NumCircleProjectileHitTests, NumHitTests);
+		}
+		{
+			SCOPE_CYCLE_COUNTER(STAT_OrientedBoxProjectileKernel);
+			const int32 NumHitTests = SweepProjectileBatch(OrientedBoxProjectiles);
+			SET_DWORD_STAT(STAT_NumOrientedBoxProjectileHitTests, NumHitTests);
+		}
+
+		// Resolve the earliest hits first
+		ProjectileHits.Sort([](const FProjectileHit& A, const FProjectileHit& B) { return A.Time < B.Time; });
+	}
+	SET_DWORD_STAT(STAT_NumProjectileHitQueries, NumQueries);
+
+	// Resolve every hit in one pass. An enemy hit by several projectiles is only destroyed once.
+	for (const FProjectileHit& ProjectileHit : ProjectileHits)
+	{
+		AEnemyBase* Enemy = GridEnemies[ProjectileHit.EnemyIndex];
+		if (!Enemy->IsPoolObjectActive())
+		{
+			continue;
+		}
+
+		if (ProjectileHit.ProjectileIndex < PooledProjectiles.Num())
+		{
+			// Projectiles spent on an earlier hit this frame hit nothing else
+			AProjectileBase* Projectile = PooledProjectiles[ProjectileHit.ProjectileIndex];
+			if (Projectile->IsPoolObjectActive())
+			{
+				Projectile->OnEnemyHit(Enemy);
+			}
+		}
+		else
+		{
+			// Find the manager simulating the projectile. There are only a few managers.
+			for (int32 RangeIndex = ManagedProjectileRanges.Num() - 1; RangeIndex >= 0; --RangeIndex)
+			{
+				const FManagedProjectileRange& Range = ManagedProjectileRanges[RangeIndex];
+				if (ProjectileHit.ProjectileIndex >= Range.FirstProjectileIndex)
+				{
+					Range.ProjectileManager->OnProjectileHitEnemy(ProjectileHit.ProjectileIndex - Range.FirstProjectileIndex, Enemy);
+					break;
+				}
+			}
+		}
+	}
+}
+
+void UCombatCollisionSubsystem::ResolveDashHits()
+{
+	APlayerShipPawn* PlayerShipPawn = PlayerShip.Get();
+	if (PlayerShipPawn == nullptr || !PlayerShipPawn->IsDashing() || GridEnemies.Num() == 0)
+	{
+		return;
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_DashHitQueries);
+		SweepHits.Reset();
+		SweepCircleVsEnemies(PlayerShipPawn->GetMovementStartLocation(), PlayerShipPawn->GetActorLocation(), PlayerShipPawn->GetCollisionRadius(), SweepHits);
+		SweepHits.Sort([](const FEnemySweepHit& A, const FEnemySweepHit& B) { return A.Time < B.Time; });
+	}
+
+	for (const FEnemySweepHit& SweepHit : SweepHits)
+	{
+		PlayerShipPawn->OnDashEnemyHit(GridEnemies[SweepHit.EnemyIndex]);
+	}
+}
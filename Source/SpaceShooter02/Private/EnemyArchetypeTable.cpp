@@ -0,0 +1,43 @@
+// Copyright 2024 Richard Skala
+
+#include "EnemyArchetypeTable.h"
+
+#include "EnemyBase.h"
+
+namespace
+{
+	bool CanSpawnArchetype(const FEnemyArchetype& Archetype, int32 DifficultyLevel)
+	{
+		return Archetype.EnemyClass != nullptr && Archetype.SpawnWeight > 0.0f && Archetype.MinDifficultyLevel <= DifficultyLevel;
+	}
+}
+
+int32 UEnemyArchetypeTable::PickRandomArchetype(int32 DifficultyLevel) const
+{
+	float TotalSpawnWeight = 0.0f;
+	int32 LastSpawnableIndex = INDEX_NONE;
+	for (int32 ArchetypeIndex = 0; ArchetypeIndex < Archetypes.Num(); ++ArchetypeIndex)
+	{
+		if (CanSpawnArchetype(Archetypes[ArchetypeIndex], DifficultyLevel))
+		{
+			TotalSpawnWeight += Archetypes[ArchetypeIndex].SpawnWeight;
+			LastSpawnableIndex = ArchetypeIndex;
+		}
+	}
+
+	float Roll = FMath::FRandRange(0.0f, TotalSpawnWeight);
+	for (int32 ArchetypeIndex = 0; ArchetypeIndex < LastSpawnableIndex; ++ArchetypeIndex)
+	{
+		if (CanSpawnArchetype(Archetypes[ArchetypeIndex], DifficultyLevel))
+		{
+			Roll -= Archetypes[ArchetypeIndex].SpawnWeight;
+			if (Roll < 0.0f)
+			{
+				return ArchetypeIndex;
+			}
+		}
+	}
+
+	// Also catches a roll of exactly the total weight
+	return LastSpawnableIndex;
+}
@@ -4,24 +4,118 @@
 
 #include "Components/BoxComponent.h"
 #include "Components/SceneComponent.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "PaperSprite.h"
 #include "PaperSpriteComponent.h"
-#include "TimerManager.h"
 
+#include "CombatCollisionSubsystem.h"
 #include "EnemySpawner.h"
-#include "PlayerShipPawn.h"
+#include "SpaceShooter02.h"
 #include "SpaceShooterGameState.h"
+#include "TargetRegistrySubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Steering"), STAT_EnemySteering, STATGROUP_SpaceShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Steered Enemies"), STAT_NumSteeredEnemies, STATGROUP_SpaceShooter);
 
 DEFINE_LOG_CATEGORY_CLASS(AEnemyBase, LogEnemy)
 
+static TAutoConsoleVariable<bool> CVarBatchedEnemySteering(
+	TEXT("SpaceShooter.BatchedEnemySteering"),
+	true,
+	TEXT("If true, enemies of a pool are moved and turned together from contiguous arrays.\n")
+	TEXT("If false, each enemy runs its own MoveTowardsTarget (for comparing the frame time of both)."));
+
 FEnemyDeathDelegateSignature AEnemyBase::OnEnemyDeath;
-const FVector AEnemyBase::InactivePosition = FVector(-10000.0f, -10000.0f, -10000.0f);
 
 namespace
 {
 	static const TCHAR* DefaultEnemySpriteClass = TEXT("/Game/Sprites/Enemies/SPR_Enemy_001");
+
+	// --- Behaviours ---
+	// Each returns the direction an enemy wants to move in, given the vector from the enemy to its target.
+	// Directions are on the XZ plane. Rotating about +Y turns +Z towards +X.
+
+	FORCEINLINE FVector ChaseDirection(const FVector& ToTarget)
+	{
+		return ToTarget.GetSafeNormal();
+	}
+
+	FORCEINLINE FVector OrbitDirection(const FVector& ToTarget, const FEnemyBehaviourSettings& Behaviour, float Sign)
+	{
+		const double Distance = ToTarget.Size();
+		if (Distance <= UE_KINDA_SMALL_NUMBER)
+		{
+			return FVector::ZeroVector;
+		}
+
+		// Head in while outside the orbit radius and out while inside it, circling the target in between
+		const FVector Radial = ToTarget / Distance;
+		const FVector Tangent = FVector(Radial.Z, 0.0, -Radial.X) * Sign;
+		const double RadialWeight = Behaviour.OrbitRadius > 0.0f ? FMath::Clamp((Distance - Behaviour.OrbitRadius) / Behaviour.OrbitRadius, -1.0, 1.0) : 1.0;
+		return (Radial * RadialWeight + Tangent * (1.0 - FMath::Abs(RadialWeight))).GetSafeNormal();
+	}
+
+	FORCEINLINE FVector ZigZagDirection(const FVector& ToTarget, const FEnemyBehaviourSettings& Behaviour, float TimeSeconds, float Sign)
+	{
+		// Veer to one side for the first half of the period, and to the other for the second half
+		const float Phase = Behaviour.ZigZagPeriodSeconds > 0.0f ? FMath::Frac(TimeSeconds / Behaviour.ZigZagPeriodSeconds) : 0.0f;
+		const float Side = Phase < 0.5f ? Sign : -Sign;
+		const FQuat Veer(FVector::YAxisVector, FMath::DegreesToRadians(Behaviour.ZigZagAngleDegrees) * Side);
+		return Veer.RotateVector(ToTarget.GetSafeNormal());
+	}
+
+	FORCEINLINE FVector DashAtDirection(const FVector& ToTarget, const FVector& Heading, const FEnemyBehaviourSettings& Behaviour, float TimeSeconds, float& OutSpeedScale)
+	{
+		// Charge at the end of every interval, keeping the heading the enemy had when the charge started
+		const float Phase = Behaviour.DashIntervalSeconds > 0.0f ? FMath::Fmod(TimeSeconds, Behaviour.DashIntervalSeconds) : 0.0f;
+		const bool bDashing = Behaviour.DashIntervalSeconds > 0.0f && Phase >= Behaviour.DashIntervalSeconds - Behaviour.DashDurationSeconds;
+		if (bDashing && !Heading.IsNearlyZero())
+		{
+			OutSpeedScale = Behaviour.DashSpeedMultiplier;
+			return Heading;
+		}
+
+		OutSpeedScale = 1.0f;
+		return ToTarget.GetSafeNormal();
+	}
+
+	FORCEINLINE FVector BehaviourDirection(const FVector& ToTarget, const FVector& Heading, const FEnemyBehaviourSettings& Behaviour, float TimeSeconds, float Sign, float& OutSpeedScale)
+	{
+		OutSpeedScale = 1.0f;
+		switch (Behaviour.Kind)
+		{
+			case EEnemyBehaviourKind::Orbit:
+				return OrbitDirection(ToTarget, Behaviour, Sign);
+			case EEnemyBehaviourKind::ZigZag:
+				return ZigZagDirection(ToTarget, Behaviour, TimeSeconds, Sign);
+			case EEnemyBehaviourKind::DashAt:
+				return DashAtDirection(ToTarget, Heading, Behaviour, TimeSeconds, OutSpeedScale);
+			case EEnemyBehaviourKind::Chase:
+			default:
+				return ChaseDirection(ToTarget);
+		}
+	}
+
+	// Turns the heading towards the desired direction by at most MaxTurnRadians
+	FORCEINLINE FVector TurnTowards(const FVector& Heading, const FVector& Desired, float MaxTurnRadians)
+	{
+		const float HeadingAngle = static_cast<float>(FMath::Atan2(Heading.X, Heading.Z));
+		const float DesiredAngle = static_cast<float>(FMath::Atan2(Desired.X, Desired.Z));
+		const float Angle = HeadingAngle + FMath::Clamp(FMath::FindDeltaAngleRadians(HeadingAngle, DesiredAngle), -MaxTurnRadians, MaxTurnRadians);
+		return FVector(FMath::Sin(Angle), 0.0, FMath::Cos(Angle));
+	}
+
+	// Applies the turn rate of the behaviour. Enemies that have not moved yet turn instantly.
+	FORCEINLINE FVector ApplyTurnRate(const FVector& Heading, const FVector& Desired, const FEnemyBehaviourSettings& Behaviour, float DeltaTime)
+	{
+		if (Behaviour.TurnRateDegreesPerSecond <= 0.0f || Heading.IsNearlyZero() || Desired.IsNearlyZero())
+		{
+			return Desired;
+		}
+		return TurnTowards(Heading, Desired, FMath::DegreesToRadians(Behaviour.TurnRateDegreesPerSecond) * DeltaTime);
+	}
 }
 
 AEnemyBase::AEnemyBase()
@@ -43,10 +137,189 @@ AEnemyBase::AEnemyBase()
 	}
 }
 
-void AEnemyBase::Tick(float DeltaTime)
+void AEnemyBase::BatchTickEnemies(TArrayView<APoolActor* const> PoolActors, float DeltaTime)
 {
-	Super::Tick(DeltaTime);
-	MoveTowardsTarget(DeltaTime);
+	SteerEnemies(PoolActors, DeltaTime);
+}
+
+void AEnemyBase::SteerEnemies(TArrayView<APoolActor* const> PoolActors, float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemySteering);
+
+	// The batched steering arrays are owned by the combat collision subsystem. Every enemy of the pool is in the same world.
+	UCombatCollisionSubsystem* CombatCollisionSubsystem = PoolActors.Num() > 0 ? UWorld::GetSubsystem<UCombatCollisionSubsystem>(PoolActors[0]->GetWorld()) : nullptr;
+	if (CVarBatchedEnemySteering.GetValueOnGameThread() && CombatCollisionSubsystem != nullptr)
+	{
+		FEnemySteeringArrays& Steering = CombatCollisionSubsystem->GetEnemySteeringArrays();
+		SteerEnemiesBatched(PoolActors, DeltaTime, Steering);
+
+		// Don't keep pointers to enemies past this tick
+		Steering.Reset();
+		return;
+	}
+
+	int32 NumSteeredEnemies = 0;
+	for (APoolActor* PoolActor : PoolActors)
+	{
+		AEnemyBase* Enemy = static_cast<AEnemyBase*>(PoolActor);
+		if (Enemy->bIsPoolObjectActive)
+		{
+			Enemy->MoveTowardsTarget(DeltaTime);
+			++NumSteeredEnemies;
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_NumSteeredEnemies, NumSteeredEnemies);
+}
+
+void AEnemyBase::SteerEnemiesBatched(TArrayView<APoolActor* const> PoolActors, float DeltaTime, FEnemySteeringArrays& Steering)
+{
+	Steering.Reset();
+
+	// Every enemy of the pool is in the same world, so the target registry is only looked up once
+	const UTargetRegistrySubsystem* TargetRegistry = UWorld::GetSubsystem<UTargetRegistrySubsystem>(PoolActors[0]->GetWorld());
+
+	// Gather the enemies that move this frame
+	for (APoolActor* PoolActor : PoolActors)
+	{
+		AEnemyBase* Enemy = static_cast<AEnemyBase*>(PoolActor);
+		if (!Enemy->bIsPoolObjectActive || Enemy->bIsSpawning)
+		{
+			continue;
+		}
+
+		// Do not move if the target is dead
+		const FTargetSnapshot* Target = TargetRegistry != nullptr ? TargetRegistry->GetTarget(Enemy->TargetIndex) : nullptr;
+		if (Target != nullptr && !Target->bAlive)
+		{
+			Enemy->DeactivatePoolObject();
+			continue;
+		}
+
+		const FVector Position = Enemy->GetActorLocation();
+		Steering.Enemies.Add(Enemy);
+		Steering.Positions.Add(Position);
+		Steering.Speeds.Add(Enemy->MoveSpeed);
+		Steering.FlockingSteerings.Add(Enemy->FlockingSteering);
+		Steering.Behaviours.Add(&Enemy->BehaviourSettings);
+		Steering.BehaviourTimes.Add(Enemy->BehaviourTimeSeconds);
+		Steering.BehaviourSigns.Add(Enemy->BehaviourSign);
+		Steering.Headings.Add(Enemy->MovementVelocity.GetSafeNormal());
+		Steering.bHasTarget.Add(Target != nullptr);
+		if (Target != nullptr)
+		{
+			Steering.ToTargets.Add(Target->Position - Position);
+			Steering.Directions.Add(FVector::ZeroVector);
+			Steering.bFaceDirection.Add(Enemy->bRotateToFaceTarget);
+		}
+		else
+		{
+			// No target. Move in the enemy's "up" direction without turning.
+			Steering.ToTargets.Add(FVector::ZeroVector);
+			Steering.Directions.Add(Enemy->GetActorUpVector());
+			Steering.bFaceDirection.Add(false);
+		}
+	}
+
+	const int32 NumEnemies = Steering.Enemies.Num();
+	Steering.SpeedScales.Init(1.0f, NumEnemies);
+
+	// Group the enemies with a target by behaviour kind (counting sort)
+	constexpr int32 NumKinds = static_cast<int32>(EEnemyBehaviourKind::NumBehaviourKinds);
+	Steering.KindStarts.Init(0, NumKinds + 1);
+	for (int32 i = 0; i < NumEnemies; ++i)
+	{
+		if (Steering.bHasTarget[i])
+		{
+			++Steering.KindStarts[FMath::Min(static_cast<int32>(Steering.Behaviours[i]->Kind), NumKinds - 1) + 1];
+		}
+	}
+	for (int32 Kind = 0; Kind < NumKinds; ++Kind)
+	{
+		Steering.KindStarts[Kind + 1] += Steering.KindStarts[Kind];
+	}
+	Steering.KindOrder.SetNumUninitialized(Steering.KindStarts[NumKinds], EAllowShrinking::No);
+	{
+		TArray<int32, TInlineAllocator<NumKinds>> KindCursors(Steering.KindStarts.GetData(), NumKinds);
+		for (int32 i = 0; i < NumEnemies; ++i)
+		{
+			if (Steering.bHasTarget[i])
+			{
+				Steering.KindOrder[KindCursors[FMath::Min(static_cast<int32>(Steering.Behaviours[i]->Kind), NumKinds - 1)]++] = i;
+			}
+		}
+	}
+
+	// Desired direction of every enemy, one loop per behaviour kind
+	for (int32 Kind = 0; Kind < NumKinds; ++Kind)
+	{
+		const TArrayView<const int32> KindEnemies = MakeArrayView(Steering.KindOrder.GetData() + Steering.KindStarts[Kind], Steering.KindStarts[Kind + 1] - Steering.KindStarts[Kind]);
+		switch (static_cast<EEnemyBehaviourKind>(Kind))
+		{
+			case EEnemyBehaviourKind::Chase:
+				for (int32 i : KindEnemies)
+				{
+					Steering.Directions[i] = ChaseDirection(Steering.ToTargets[i]);
+				}
+				break;
+			case EEnemyBehaviourKind::Orbit:
+				for (int32 i : KindEnemies)
+				{
+					Steering.Directions[i] = OrbitDirection(Steering.ToTargets[i], *Steering.Behaviours[i], Steering.BehaviourSigns[i]);
+				}
+				break;
+			case EEnemyBehaviourKind::ZigZag:
+				for (int32 i : KindEnemies)
+				{
+					Steering.Directions[i] = ZigZagDirection(Steering.ToTargets[i], *Steering.Behaviours[i], Steering.BehaviourTimes[i], Steering.BehaviourSigns[i]);
+				}
+				break;
+			case EEnemyBehaviourKind::DashAt:
+				for (int32 i : KindEnemies)
+				{
+					Steering.Directions[i] = DashAtDirection(Steering.ToTargets[i], Steering.Headings[i], *Steering.Behaviours[i], Steering.BehaviourTimes[i], Steering.SpeedScales[i]);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	// Move and turn every enemy
+	Steering.FacingAngles.SetNumUninitialized(NumEnemies, EAllowShrinking::No);
+	for (int32 i = 0; i < NumEnemies; ++i)
+	{
+		const FVector DesiredDirection = Steering.Directions[i];
+		FVector Direction = (DesiredDirection + Steering.FlockingSteerings[i]).GetSafeNormal(UE_SMALL_NUMBER, DesiredDirection);
+		if (Steering.bHasTarget[i])
+		{
+			Direction = ApplyTurnRate(Steering.Headings[i], Direction, *Steering.Behaviours[i], DeltaTime);
+		}
+		Steering.Directions[i] = Direction;
+		Steering.Speeds[i] *= Steering.SpeedScales[i];
+		Steering.Positions[i] += Direction * (Steering.Speeds[i] * DeltaTime);
+		Steering.BehaviourTimes[i] += DeltaTime;
+
+		// Angle from the world "up" (+Z) to the direction. Turning towards +X is a negative pitch.
+		Steering.FacingAngles[i] = -FMath::RadiansToDegrees(static_cast<float>(FMath::Atan2(Direction.X, Direction.Z)));
+	}
+
+	// Write every transform back in one pass, with one move per enemy
+	for (int32 i = 0; i < NumEnemies; ++i)
+	{
+		AEnemyBase* Enemy = Steering.Enemies[i];
+		Enemy->MovementVelocity = Steering.Directions[i] * Steering.Speeds[i];
+		Enemy->BehaviourTimeSeconds = Steering.BehaviourTimes[i];
+		if (Steering.bFaceDirection[i])
+		{
+			Enemy->SetActorLocationAndRotation(Steering.Positions[i], FRotator(Steering.FacingAngles[i], 0.0f, 0.0f));
+		}
+		else
+		{
+			Enemy->SetActorLocation(Steering.Positions[i]);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_NumSteeredEnemies, NumEnemies);
 }
 
 void AEnemyBase::BeginDestroy()
@@ -59,45 +332,94 @@ void AEnemyBase::ActivatePoolObject()
 	Super::ActivatePoolObject();
 
 	bIsSpawning = true;
+	HitPoints = MaxHitPoints;
+	BehaviourTimeSeconds = 0.0f;
+	BehaviourSign = FMath::RandBool() ? 1.0f : -1.0f;
 	SetActorEnableCollision(false);
 	if (PaperSpriteComp != nullptr)
 	{
 		PaperSpriteComp->SetVisibility(false, true);
 	}
-
-	const float EnemySpawnDelayTimeSeconds = 0.75f; // TODO: Get this from the animation
-	GetWorldTimerManager().SetTimer(SpawnDelayTimerHandle, this, &ThisClass::OnSpawnDelayTimerElapsed, EnemySpawnDelayTimeSeconds, false);
 }
 
 void AEnemyBase::DeactivatePoolObject()
 {
 	Super::DeactivatePoolObject();
-	TargetActor = nullptr; // Clear the target
+	TargetIndex = INDEX_NONE; // Clear the target
+	MovementVelocity = FVector::ZeroVector;
+	FlockingSteering = FVector::ZeroVector;
 	bIsSpawning = false;
 }
 
 void AEnemyBase::DestroyEnemy(bool bDestroyedFromBoost /*= false*/)
 {
+	// Collision is only disabled at the end of the frame, so ignore overlaps with an enemy that was already destroyed this frame
+	if (!IsPoolObjectActive())
+	{
+		return;
+	}
+
 	// Notify subscribers that an enemy died
-	OnEnemyDeath.Broadcast(GetActorLocation(), EnemyExplosionEffect.Get(), bDestroyedFromBoost);
+	OnEnemyDeath.Broadcast(GetActorLocation(), EnemyExplosionEffect.Get(), bDestroyedFromBoost, ScoreValue);
 
 	// Deactivate this enemy
 	DeactivatePoolObject();
 }
 
-void AEnemyBase::SetTarget(TSoftObjectPtr<AActor> InTargetActor)
+void AEnemyBase::DamageEnemy(int32 Damage /*= 1*/)
 {
-	TargetActor = InTargetActor;
+	if (!IsPoolObjectActive())
+	{
+		return;
+	}
+
+	HitPoints -= Damage;
+	if (HitPoints <= 0)
+	{
+		DestroyEnemy();
+	}
 }
 
-void AEnemyBase::BeginPlay()
+void AEnemyBase::ApplyArchetype(const FEnemyArchetype& Archetype)
 {
-	Super::BeginPlay();
+	MoveSpeed = Archetype.MoveSpeed;
+	BehaviourSettings = Archetype.Behaviour;
+	MaxHitPoints = FMath::Max(Archetype.HitPoints, 1);
+	ScoreValue = Archetype.ScoreValue;
+
+	if (PaperSpriteComp != nullptr)
+	{
+		// Remember the class's sprite the first time, as pooled enemies are reused by archetypes with and without a sprite
+		if (DefaultSprite == nullptr)
+		{
+			DefaultSprite = PaperSpriteComp->GetSprite();
+		}
+		PaperSpriteComp->SetSprite(Archetype.Sprite != nullptr ? Archetype.Sprite.Get() : DefaultSprite.Get());
+	}
+}
+
+void AEnemyBase::SetTarget(int32 InTargetIndex)
+{
+	TargetIndex = InTargetIndex;
+}
+
+FVector2D AEnemyBase::GetCollisionHalfExtent() const
+{
+	if (BoxComp == nullptr)
+	{
+		return FVector2D::ZeroVector;
+	}
+
+	// Bounds are kept up to date whenever the box moves or rotates
+	const FVector& BoundsExtent = BoxComp->Bounds.BoxExtent;
+	return FVector2D(BoundsExtent.X, BoundsExtent.Z);
 }
 
-FVector AEnemyBase::GetInactivePoolObjectPosition() const
+void AEnemyBase::BeginPlay()
 {
-	return InactivePosition;
+	Super::BeginPlay();
+
+	TargetRegistry = UWorld::GetSubsystem<UTargetRegistrySubsystem>(GetWorld());
 }
 
 void AEnemyBase::MoveTowardsTarget(float DeltaTime)
@@ -108,31 +430,40 @@ void AEnemyBase::MoveTowardsTarget(float DeltaTime)
 		return;
 	}
 
-	// Do not move if the player is the target and the player is dead.
-	if (APlayerShipPawn* PlayerShipPawn = Cast<APlayerShipPawn>(TargetActor.Get()))
+	// Do not move if the target is dead.
+	const UTargetRegistrySubsystem* TargetRegistrySubsystem = TargetRegistry.Get();
+	const FTargetSnapshot* Target = TargetRegistrySubsystem != nullptr ? TargetRegistrySubsystem->GetTarget(TargetIndex) : nullptr;
+	if (Target != nullptr && !Target->bAlive)
 	{
-		if (PlayerShipPawn->GetPlayerDead())
-		{
-			DeactivatePoolObject();
-			return;
-		}
+		DeactivatePoolObject();
+		return;
 	}
 
 	// Get this enemy's movement direction depending on whether or not it has a target
 	FVector MovementDirection;
-	if (TargetActor == nullptr)
+	float SpeedScale = 1.0f;
+	const FVector Heading = MovementVelocity.GetSafeNormal();
+	if (Target == nullptr)
 	{
 		// This enemy has no target. Move directly in its "up" direction
 		MovementDirection = GetActorUpVector();
 	}
 	else
 	{
-		// This enemy has a target. Move toward the target.
-		FVector TargetPosition = TargetActor->GetActorLocation();
+		// This enemy has a target. Move the way its behaviour steers it, from the vector to the target (A->B = B-A).
+		MovementDirection = BehaviourDirection(Target->Position - GetActorLocation(), Heading, BehaviourSettings, BehaviourTimeSeconds, BehaviourSign, SpeedScale);
+	}
 
-		// Get the normalized vector from this enemy to the target (A->B = B-A)
-		MovementDirection = (TargetActor->GetActorLocation() - GetActorLocation()).GetSafeNormal();
+	// Bend the path around nearby enemies
+	MovementDirection = (MovementDirection + FlockingSteering).GetSafeNormal(UE_SMALL_NUMBER, MovementDirection);
+	if (Target != nullptr)
+	{
+		MovementDirection = ApplyTurnRate(Heading, MovementDirection, BehaviourSettings, DeltaTime);
 	}
+	BehaviourTimeSeconds += DeltaTime;
+
+	const float Speed = MoveSpeed * SpeedScale;
+	MovementVelocity = MovementDirection * Speed;
 
 	// Move enemy in the movement direction
 
@@ -141,14 +472,14 @@ void AEnemyBase::MoveTowardsTarget(float DeltaTime)
 
 	// Get the distance to move this frame using the movement direction
 	//FVector2D MovementAmount2D = MovementDirection * MoveSpeed * DeltaTime;
-	FVector MovementAmount = MovementDirection * MoveSpeed * DeltaTime;
+	FVector MovementAmount = MovementDirection * Speed * DeltaTime;
 
 	// Get the new enemy position and set it
 	FVector NewEnemyPosition = EnemyPosition + MovementAmount;
 	SetActorLocation(NewEnemyPosition);
 
 	// Rotate this enemy towards its target (if it has one)
-	if(bRotateToFaceTarget && TargetActor != nullptr)
+	if(bRotateToFaceTarget && Target != nullptr)
 	{
 		// Get the angle from the world-up vector to the movement direction
 		float Dot = FVector::UnitZ().Dot(MovementDirection);
@@ -166,11 +497,12 @@ void AEnemyBase::MoveTowardsTarget(float DeltaTime)
 	}
 }
 
-void AEnemyBase::OnSpawnDelayTimerElapsed()
+void AEnemyBase::FinishSpawning()
 {
-	if (SpawnDelayTimerHandle.IsValid())
+	// Do not let a late spawn-in re-enable collision on an inactive enemy
+	if (!bIsPoolObjectActive || !bIsSpawning)
 	{
-		GetWorldTimerManager().ClearTimer(SpawnDelayTimerHandle);
+		return;
 	}
 
 	bIsSpawning = false;
@@ -180,3 +512,11 @@ void AEnemyBase::OnSpawnDelayTimerElapsed()
 		PaperSpriteComp->SetVisibility(true, true);
 	}
 }
+
+void AEnemyBase::FinishSpawningEnemies(TConstArrayView<AEnemyBase*> Enemies)
+{
+	for (AEnemyBase* Enemy : Enemies)
+	{
+		Enemy->FinishSpawning();
+	}
+}
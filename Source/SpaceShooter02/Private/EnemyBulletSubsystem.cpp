@@ -0,0 +1,138 @@
+// Copyright 2024 Richard Skala
+
+#include "EnemyBulletSubsystem.h"
+
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+#include "ArenaCollisionSubsystem.h"
+#include "ProjectileBase.h"
+#include "ProjectileCircular.h"
+#include "ProjectileManager.h"
+#include "SpaceShooterBenchmark.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogEnemyBullets, Log, All)
+
+bool UEnemyBulletSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyBulletSubsystem::FireBullet(TSubclassOf<AProjectileBase> BulletClass, const FVector& Position, const FVector& Direction, float Speed, AActor* InOwner)
+{
+	if (AProjectileManager* BulletManager = GetOrCreateBulletManager(BulletClass))
+	{
+		BulletManager->FireProjectile(Position, Direction, Speed, InOwner);
+	}
+}
+
+AProjectileManager* UEnemyBulletSubsystem::GetOrCreateBulletManager(TSubclassOf<AProjectileBase> BulletClass)
+{
+	if (BulletClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (TObjectPtr<AProjectileManager>* ExistingBulletManager = BulletManagers.Find(BulletClass))
+	{
+		return *ExistingBulletManager;
+	}
+
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AProjectileManager* BulletManager = World->SpawnActor<AProjectileManager>(AProjectileManager::StaticClass(), FTransform::Identity, SpawnParameters);
+	if (ensure(BulletManager != nullptr))
+	{
+		BulletManager->InitProjectileManager(BulletClass, INITIAL_BULLET_CAPACITY, EProjectileManagerTarget::Player);
+		BulletManagers.Add(BulletClass, BulletManager);
+		UE_LOG(LogEnemyBullets, Log, TEXT("Created enemy bullet manager for %s"), *BulletClass->GetName());
+	}
+	return BulletManager;
+}
+
+void UEnemyBulletSubsystem::ResetEnemyBullets()
+{
+	for (const TPair<TSubclassOf<AProjectileBase>, TObjectPtr<AProjectileManager>>& BulletManagerPair : BulletManagers)
+	{
+		if (BulletManagerPair.Value != nullptr)
+		{
+			BulletManagerPair.Value->ResetProjectiles();
+		}
+	}
+}
+
+int32 UEnemyBulletSubsystem::GetNumEnemyBullets() const
+{
+	int32 NumBullets = 0;
+	for (const TPair<TSubclassOf<AProjectileBase>, TObjectPtr<AProjectileManager>>& BulletManagerPair : BulletManagers)
+	{
+		if (BulletManagerPair.Value != nullptr)
+		{
+			NumBullets += BulletManagerPair.Value->GetNumProjectiles();
+		}
+	}
+	return NumBullets;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	static constexpr int32 DefaultNumStressBullets = 4000;
+
+	// Bullets are not fired closer than this to the player ship, so the test does not end on the first frame
+	static constexpr float StressBulletPlayerClearance = 400.0f;
+
+	// Fires a burst of enemy bullets across the arena. Their simulation and player collision costs show up under
+	// "stat SpaceShooter" (Projectile Simulation, Enemy Bullet Hit Queries) for as long as they are alive.
+	void StressEnemyBullets(const TArray<FString>& Args, UWorld* World)
+	{
+		UEnemyBulletSubsystem* EnemyBulletSubsystem = UWorld::GetSubsystem<UEnemyBulletSubsystem>(World);
+		UArenaCollisionSubsystem* ArenaCollisionSubsystem = UWorld::GetSubsystem<UArenaCollisionSubsystem>(World);
+		if (EnemyBulletSubsystem == nullptr || ArenaCollisionSubsystem == nullptr || !ArenaCollisionSubsystem->GetArenaBounds().IsValid)
+		{
+			UE_LOG(LogEnemyBullets, Warning, TEXT("SpaceShooter.StressEnemyBullets - No arena to fire into"));
+			return;
+		}
+
+		const int32 NumBullets = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : DefaultNumStressBullets;
+		const FBox& ArenaBounds = ArenaCollisionSubsystem->GetArenaBounds();
+		const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(World, 0);
+		const FVector PlayerLocation = PlayerPawn != nullptr ? PlayerPawn->GetActorLocation() : ArenaBounds.GetCenter();
+
+		// Bullets are fired over the real arena, on the XZ plane
+		FSpaceShooterBenchmark Benchmark;
+		const FBox2D ArenaPlaneBounds(FVector2D(ArenaBounds.Min.X, ArenaBounds.Min.Z), FVector2D(ArenaBounds.Max.X, ArenaBounds.Max.Z));
+		const double ElapsedMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([&Benchmark, &ArenaPlaneBounds, &PlayerLocation, EnemyBulletSubsystem, NumBullets]()
+		{
+			for (int32 i = 0; i < NumBullets; ++i)
+			{
+				const FVector2D PlanePosition = Benchmark.RandomPosition(ArenaPlaneBounds);
+				FVector Position(PlanePosition.X, PlayerLocation.Y, PlanePosition.Y);
+				if (FVector::DistSquared(Position, PlayerLocation) < FMath::Square(StressBulletPlayerClearance))
+				{
+					Position = PlayerLocation + (Position - PlayerLocation).GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector) * StressBulletPlayerClearance;
+				}
+
+				const FVector2D PlaneDirection = Benchmark.RandomDirection();
+				const FVector Direction(PlaneDirection.X, 0.0, PlaneDirection.Y);
+				EnemyBulletSubsystem->FireBullet(AProjectileCircular::StaticClass(), Position, Direction, Benchmark.GetRandomStream().FRandRange(150.0f, 400.0f), nullptr);
+			}
+		});
+
+		UE_LOG(LogSpaceShooterBenchmark, Log, TEXT("Fired %d enemy bullets in %.3f ms. %d enemy bullets alive. Use 'stat SpaceShooter' to see their per-frame cost."),
+			NumBullets, ElapsedMilliseconds, EnemyBulletSubsystem->GetNumEnemyBullets());
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs StressEnemyBulletsCommand(
+	TEXT("SpaceShooter.StressEnemyBullets"),
+	TEXT("Fires the given number of enemy bullets (default 4000) across the arena, to stress the enemy bullet simulation and collision"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StressEnemyBullets));
+#endif // !UE_BUILD_SHIPPING
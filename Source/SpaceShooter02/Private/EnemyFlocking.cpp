@@ -0,0 +1,151 @@
+// Copyright 2024 Richard Skala
+
+#include "EnemyFlocking.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+#include "SpaceShooterBenchmark.h"
+#include "UniformGrid2D.h"
+
+namespace
+{
+	// Minimum number of grid cells given to one worker. Most cells hold only a few enemies.
+	static constexpr int32 FlockingCellBatchSize = 8;
+}
+
+void FEnemyFlocking::ComputeSteering(const FUniformGrid2D& Grid, TConstArrayView<FVector2D> Velocities, TConstArrayView<const FEnemyFlockingSettings*> Settings, TArrayView<FVector2D> OutSteering)
+{
+	const int32 NumItems = Grid.GetNumItems();
+	if (!ensure(Velocities.Num() == NumItems && Settings.Num() == NumItems && OutSteering.Num() == NumItems))
+	{
+		return;
+	}
+
+	// Each item is in exactly one cell, so every worker writes to its own items. The grid is only read.
+	ParallelFor(TEXT("EnemyFlocking"), Grid.GetNumCells(), FlockingCellBatchSize, [&Grid, Velocities, Settings, OutSteering](int32 CellIndex)
+	{
+		for (const int32 ItemIndex : Grid.GetCellItems(CellIndex))
+		{
+			const FEnemyFlockingSettings* ItemSettings = Settings[ItemIndex];
+			OutSteering[ItemIndex] = ItemSettings != nullptr ? ComputeItemSteering(Grid, ItemIndex, Velocities, *ItemSettings) : FVector2D::ZeroVector;
+		}
+	});
+}
+
+FVector2D FEnemyFlocking::ComputeItemSteering(const FUniformGrid2D& Grid, int32 ItemIndex, TConstArrayView<FVector2D> Velocities, const FEnemyFlockingSettings& Settings)
+{
+	const FVector2D Position = Grid.GetItemPosition(ItemIndex);
+	const double SeparationRadius = Settings.SeparationRadius;
+	const double SearchRadius = FMath::Max(Settings.NeighbourRadius, Settings.SeparationRadius);
+	if (SearchRadius <= 0.0)
+	{
+		return FVector2D::ZeroVector;
+	}
+
+	const double NeighbourRadiusSquared = FMath::Square(static_cast<double>(Settings.NeighbourRadius));
+	const double SeparationRadiusSquared = FMath::Square(SeparationRadius);
+
+	FVector2D Separation = FVector2D::ZeroVector;
+	FVector2D HeadingSum = FVector2D::ZeroVector;
+	FVector2D NeighbourPositionSum = FVector2D::ZeroVector;
+	int32 NumNeighbours = 0;
+
+	const FVector2D SearchExtent(SearchRadius);
+	Grid.ForEachCandidateInBox(FBox2D(Position - SearchExtent, Position + SearchExtent), [&](int32 OtherItemIndex)
+	{
+		if (OtherItemIndex == ItemIndex)
+		{
+			return;
+		}
+
+		const FVector2D OtherPosition = Grid.GetItemPosition(OtherItemIndex);
+		const FVector2D Offset = Position - OtherPosition;
+		const double DistanceSquared = Offset.SizeSquared();
+		if (DistanceSquared < SeparationRadiusSquared)
+		{
+			// Enemies on top of each other are split along X, in opposite directions
+			const double Distance = FMath::Sqrt(DistanceSquared);
+			const FVector2D Away = Distance > UE_KINDA_SMALL_NUMBER ? Offset / Distance : FVector2D(ItemIndex < OtherItemIndex ? 1.0 : -1.0, 0.0);
+			Separation += Away * (1.0 - Distance / SeparationRadius);
+		}
+
+		if (DistanceSquared < NeighbourRadiusSquared)
+		{
+			HeadingSum += Velocities[OtherItemIndex].GetSafeNormal();
+			NeighbourPositionSum += OtherPosition;
+			++NumNeighbours;
+		}
+	});
+
+	FVector2D Steering = Separation.GetClampedToMaxSize(1.0) * Settings.SeparationWeight;
+	if (NumNeighbours > 0)
+	{
+		// Head the way the neighbours are heading, and towards their center
+		Steering += (HeadingSum / NumNeighbours) * Settings.AlignmentWeight;
+		Steering += ((NeighbourPositionSum / NumNeighbours - Position) / Settings.NeighbourRadius) * Settings.CohesionWeight;
+	}
+	return Steering;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	// Game thread time allowed for flocking at the target swarm size
+	static constexpr double FlockingBudgetMilliseconds = 2.0;
+
+	// Times the flocking steering of enemies spread over an arena sized grid, and of the same enemies packed into a swarm
+	// (where every enemy has the most neighbours)
+	void RunFlockingBenchmark()
+	{
+		const FEnemyFlockingSettings BenchmarkSettings = []()
+		{
+			FEnemyFlockingSettings FlockingSettings;
+			FlockingSettings.bEnableFlocking = true;
+			return FlockingSettings;
+		}();
+
+		FUniformGrid2D EnemyGrid;
+		EnemyGrid.Init(FSpaceShooterBenchmark::GetArenaBounds(), 200.0f);
+
+		for (const double SpawnRadius : { 2000.0, 800.0 })
+		{
+			for (const int32 NumEnemies : { 500, 1000, 2000, 4000 })
+			{
+				FSpaceShooterBenchmark Benchmark;
+				const FBox2D SpawnBounds(FVector2D(-SpawnRadius), FVector2D(SpawnRadius));
+				TArray<FVector2D> Positions;
+				TArray<float> Radii;
+				TArray<FVector2D> Velocities;
+				for (int32 i = 0; i < NumEnemies; ++i)
+				{
+					Positions.Add(Benchmark.RandomPosition(SpawnBounds));
+					Radii.Add(50.0f);
+					Velocities.Add(Benchmark.RandomDirection() * 300.0);
+				}
+
+				TArray<const FEnemyFlockingSettings*> Settings;
+				Settings.Init(&BenchmarkSettings, NumEnemies);
+				TArray<FVector2D> Steering;
+				Steering.SetNumUninitialized(NumEnemies);
+
+				// The grid is rebuilt every frame in game, so its build is part of the cost
+				const double ElapsedMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([&EnemyGrid, &Positions, &Radii, &Velocities, &Settings, &Steering]()
+				{
+					EnemyGrid.Build(Positions, Radii);
+					FEnemyFlocking::ComputeSteering(EnemyGrid, Velocities, Settings, Steering);
+				});
+
+				UE_LOG(LogSpaceShooterBenchmark, Log, TEXT("%d enemies within %.0f units: flocking %.3f ms (%.2f us per enemy)%s"),
+					NumEnemies, SpawnRadius, ElapsedMilliseconds, ElapsedMilliseconds * 1000.0 / NumEnemies,
+					ElapsedMilliseconds > FlockingBudgetMilliseconds ? TEXT(" - OVER BUDGET") : TEXT(""));
+			}
+		}
+	}
+}
+
+static FAutoConsoleCommand BenchmarkFlockingCommand(
+	TEXT("SpaceShooter.BenchmarkFlocking"),
+	TEXT("Times the enemy flocking steering for 500 to 4000 enemies, spread over the arena and packed into a swarm"),
+	FConsoleCommandDelegate::CreateStatic(&RunFlockingBenchmark));
+#endif // !UE_BUILD_SHIPPING
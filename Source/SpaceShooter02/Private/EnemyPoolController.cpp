@@ -2,55 +2,73 @@
 
 #include "EnemyPoolController.h"
 
+#include "EnemyArchetypeTable.h"
 #include "EnemyBase.h"
-#include "EnemyPoolContainer.h"
-
-void UEnemyPoolController::BeginDestroy()
-{
-	Super::BeginDestroy();
-}
+#include "SpaceShooterPoolSubsystem.h"
 
 void UEnemyPoolController::InitEnemyPools()
 {
-	if (EnemyClasses.Num() <= 0)
+	USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld());
+	if (PoolSubsystem == nullptr)
 	{
 		return;
 	}
 
-	for (TSubclassOf<AEnemyBase> EnemyClass : EnemyClasses)
+	// Each archetype gets a pool's worth of enemies in the pool of its class
+	TMap<TSubclassOf<AEnemyBase>, int32> PoolSizes;
+	if (ArchetypeTable != nullptr)
 	{
-		if (ensureAlways(EnemyClass != nullptr))
+		for (const FEnemyArchetype& Archetype : ArchetypeTable->GetArchetypes())
 		{
-			// Create a new pool
-			UEnemyPoolContainer* EnemyPoolContainer = NewObject<UEnemyPoolContainer>(this, UEnemyPoolContainer::StaticClass());
-			if (EnemyPoolContainer != nullptr)
+			if (ensureAlways(Archetype.EnemyClass != nullptr))
 			{
-				EnemyPoolContainers.Add(EnemyPoolContainer);
-				EnemyPoolContainer->InitEnemyPool(EnemyClass, MAX_ENEMIES_PER_POOL);
+				PoolSizes.FindOrAdd(Archetype.EnemyClass) += MAX_ENEMIES_PER_POOL;
 			}
 		}
 	}
-}
-
-void UEnemyPoolController::ResetEnemyPools()
-{
-	for (UEnemyPoolContainer* EnemyPoolContainer : EnemyPoolContainers)
+	else
 	{
-		if (EnemyPoolContainer != nullptr)
+		for (TSubclassOf<AEnemyBase> EnemyClass : EnemyClasses)
 		{
-			EnemyPoolContainer->ResetEnemyPool();
+			if (ensureAlways(EnemyClass != nullptr))
+			{
+				PoolSizes.FindOrAdd(EnemyClass) = MAX_ENEMIES_PER_POOL;
+			}
 		}
 	}
+
+	for (const TPair<TSubclassOf<AEnemyBase>, int32>& PoolSize : PoolSizes)
+	{
+		PoolSubsystem->CreatePool(PoolSize.Key, PoolSize.Value, GrowthSettings);
+	}
 }
 
-AEnemyBase* UEnemyPoolController::GetRandomEnemy()
+AEnemyBase* UEnemyPoolController::GetRandomEnemy(int32 DifficultyLevel /*= 1*/)
 {
 	AEnemyBase* Enemy = nullptr;
-	int32 RandomIndex = FMath::RandRange(0, EnemyPoolContainers.Num() - 1);
-	UEnemyPoolContainer* PoolContainer = EnemyPoolContainers[RandomIndex];
-	if (PoolContainer != nullptr)
+	USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld());
+	if (PoolSubsystem == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (ArchetypeTable != nullptr)
+	{
+		const int32 ArchetypeIndex = ArchetypeTable->PickRandomArchetype(DifficultyLevel);
+		if (ArchetypeIndex != INDEX_NONE)
+		{
+			const FEnemyArchetype& Archetype = ArchetypeTable->GetArchetypes()[ArchetypeIndex];
+			Enemy = PoolSubsystem->AcquirePoolActor(Archetype.EnemyClass);
+			if (Enemy != nullptr)
+			{
+				Enemy->ApplyArchetype(Archetype);
+			}
+		}
+	}
+	else if (EnemyClasses.Num() > 0)
 	{
-		Enemy = PoolContainer->GetInactiveEnemy();
+		int32 RandomIndex = FMath::RandRange(0, EnemyClasses.Num() - 1);
+		Enemy = PoolSubsystem->AcquirePoolActor(EnemyClasses[RandomIndex]);
 	}
 	return Enemy;
 }
@@ -0,0 +1,69 @@
+// Copyright 2024 Richard Skala
+
+#include "EnemyShooter.h"
+
+#include "EnemyBulletSubsystem.h"
+#include "ProjectileBase.h"
+#include "ProjectileManager.h"
+#include "TargetRegistrySubsystem.h"
+
+void AEnemyShooter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Spawn the bullet manager with the enemy pool, rather than on the first shot
+	if (UEnemyBulletSubsystem* EnemyBulletSubsystem = UWorld::GetSubsystem<UEnemyBulletSubsystem>(GetWorld()))
+	{
+		BulletManager = EnemyBulletSubsystem->GetOrCreateBulletManager(BulletClass);
+	}
+}
+
+void AEnemyShooter::ActivatePoolObject()
+{
+	Super::ActivatePoolObject();
+
+	// Every enemy starts the pattern from the beginning once it has spawned in
+	BulletPatternPlayer.Reset();
+}
+
+void AEnemyShooter::BatchTickShooterEnemies(TArrayView<APoolActor* const> PoolActors, float DeltaTime)
+{
+	SteerEnemies(PoolActors, DeltaTime);
+
+	// Enemies deactivated by the steering do not fire
+	for (APoolActor* PoolActor : PoolActors)
+	{
+		AEnemyShooter* Enemy = static_cast<AEnemyShooter*>(PoolActor);
+		if (Enemy->bIsPoolObjectActive)
+		{
+			Enemy->UpdateBulletPattern(DeltaTime);
+		}
+	}
+}
+
+void AEnemyShooter::UpdateBulletPattern(float DeltaTime)
+{
+	// Do not fire while spawning in, or after being deactivated by the movement update
+	AProjectileManager* EnemyBulletManager = BulletManager.Get();
+	if (bIsSpawning || !bIsPoolObjectActive || BulletPattern == nullptr || EnemyBulletManager == nullptr)
+	{
+		return;
+	}
+
+	// Aimed bullets are turned towards the target. Angles are clockwise from the top of the screen (+Z towards +X).
+	const FVector EnemyLocation = GetActorLocation();
+	double AimAngle = 0.0;
+	const UTargetRegistrySubsystem* TargetRegistrySubsystem = TargetRegistry.Get();
+	if (const FTargetSnapshot* Target = TargetRegistrySubsystem != nullptr ? TargetRegistrySubsystem->GetTarget(TargetIndex) : nullptr)
+	{
+		const FVector ToTarget = Target->Position - EnemyLocation;
+		AimAngle = FMath::Atan2(ToTarget.X, ToTarget.Z);
+	}
+
+	BulletPatternPlayer.Advance(*BulletPattern, DeltaTime, [this, EnemyBulletManager, &EnemyLocation, AimAngle](const FBulletSpawnInstruction& Instruction)
+	{
+		const double Angle = Instruction.AngleRadians + (Instruction.bAimed ? AimAngle : 0.0);
+		const FVector Direction(FMath::Sin(Angle), 0.0, FMath::Cos(Angle));
+		EnemyBulletManager->FireProjectile(EnemyLocation, Direction, Instruction.Speed, this);
+	});
+}
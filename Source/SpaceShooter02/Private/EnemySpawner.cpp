@@ -21,9 +21,16 @@
 #include "SpaceShooterLevelScriptActor.h"
 #include "SpawnAnimBase.h"
 #include "SpawnAnimController.h"
+#include "TargetRegistrySubsystem.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogEnemySpawner, Log, All)
 
+namespace
+{
+	// Spawn-in time of enemies that are spawned without a spawn animation
+	static constexpr float DefaultEnemySpawnInDelaySeconds = 0.75f;
+}
+
 AEnemySpawner::AEnemySpawner()
 {
 	PrimaryActorTick.bCanEverTick = true;
@@ -33,6 +40,9 @@ void AEnemySpawner::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 	UpdateSpawning(DeltaTime);
+
+	// Spawn-ins still finish after spawning is disabled
+	UpdateSpawnIns();
 }
 
 void AEnemySpawner::SetExplosionSpriteController(UExplosionSpriteController* InExplosionSpriteController)
@@ -102,7 +112,8 @@ void AEnemySpawner::UpdateSpawning(float DeltaTime)
 		// Time has elapsed since the last enemy was spawned. Spawn an enemy.
 		FVector EnemyPosition = GetRandomEnemySpawnPosition();
 
-		// Play a Spawn Animation at the enemy spawn position
+		// Play a Spawn Animation at the enemy spawn position. The enemy appears when the animation finishes.
+		float SpawnInDelaySeconds = DefaultEnemySpawnInDelaySeconds;
 		if (SpawnAnimController != nullptr)
 		{
 			ASpawnAnimBase* EnemySpawnAnim = SpawnAnimController->GetInactiveSpawnAnim();
@@ -114,19 +125,28 @@ void AEnemySpawner::UpdateSpawning(float DeltaTime)
 
 				EnemySpawnAnim->SetActorLocationAndRotation(SpawnAnimPos, SpawnAnimRotation);
 				EnemySpawnAnim->ActivatePoolObject();
+
+				const float SpawnAnimLength = EnemySpawnAnim->GetSpawnAnimLength();
+				if (SpawnAnimLength > 0.0f)
+				{
+					SpawnInDelaySeconds = SpawnAnimLength;
+				}
 			}
 		}
 
 		// Spawn the enemy
 		if (EnemyPoolController != nullptr)
 		{
-			AEnemyBase* SpawnedEnemy = EnemyPoolController->GetRandomEnemy();
+			// Harder enemy types are only spawned at higher difficulty levels
+			const int32 DifficultyLevel = SpaceShooterGameState.IsValid() ? SpaceShooterGameState->GetDifficultyLevel() : 1;
+			AEnemyBase* SpawnedEnemy = EnemyPoolController->GetRandomEnemy(DifficultyLevel);
 			if (SpawnedEnemy != nullptr)
 			{
 				// Set player as the enemy's target and place at the spawn position
-				SpawnedEnemy->SetTarget(PlayerShipPawn);
+				SpawnedEnemy->SetTarget(UTargetRegistrySubsystem::PLAYER_TARGET_INDEX);
 				SpawnedEnemy->SetActorLocation(EnemyPosition);
 				SpawnedEnemy->ActivatePoolObject();
+				QueueSpawnIn(SpawnedEnemy, SpawnInDelaySeconds);
 			}
 		}
 
@@ -135,13 +155,56 @@ void AEnemySpawner::UpdateSpawning(float DeltaTime)
 	}
 }
 
+void AEnemySpawner::QueueSpawnIn(AEnemyBase* Enemy, float SpawnInDelaySeconds)
+{
+	// Keep the queue ordered if spawn animations differ in length. A shorter animation following a longer one makes its
+	// enemy wait for the one ahead, by at most the difference between the two lengths.
+	double FinishTimeSeconds = GetWorld()->GetTimeSeconds() + SpawnInDelaySeconds;
+	if (!SpawnInQueue.IsEmpty())
+	{
+		FinishTimeSeconds = FMath::Max(FinishTimeSeconds, SpawnInQueue.Last().FinishTimeSeconds);
+	}
+
+	FEnemySpawnIn SpawnIn;
+	SpawnIn.Enemy = Enemy;
+	SpawnIn.ActivationSerial = Enemy->GetPoolActivationSerial();
+	SpawnIn.FinishTimeSeconds = FinishTimeSeconds;
+	SpawnInQueue.Add(MoveTemp(SpawnIn));
+}
+
+void AEnemySpawner::UpdateSpawnIns()
+{
+	const double CurrentTimeSeconds = GetWorld()->GetTimeSeconds();
+	while (!SpawnInQueue.IsEmpty() && SpawnInQueue.First().FinishTimeSeconds <= CurrentTimeSeconds)
+	{
+		const FEnemySpawnIn SpawnIn = SpawnInQueue.First();
+		SpawnInQueue.PopFront();
+
+		// Skip enemies that were deactivated (and possibly spawned again) during their spawn-in
+		AEnemyBase* Enemy = SpawnIn.Enemy.Get();
+		if (Enemy != nullptr && Enemy->IsPoolObjectActive() && Enemy->IsSpawning() && Enemy->GetPoolActivationSerial() == SpawnIn.ActivationSerial)
+		{
+			FinishedSpawnInEnemies.Add(Enemy);
+		}
+	}
+
+	if (FinishedSpawnInEnemies.Num() > 0)
+	{
+		AEnemyBase::FinishSpawningEnemies(FinishedSpawnInEnemies);
+		FinishedSpawnInEnemies.Reset();
+	}
+}
+
 void AEnemySpawner::OnGameStarted()
 {
 	// Gameplay has started. Start enemy spawning.
 	SetSpawningEnabled(true);
+
+	// Drop the spawn-ins left over from the last game
+	SpawnInQueue.Reset();
 }
 
-void AEnemySpawner::OnEnemyDeath(FVector EnemyDeathPosition, UNiagaraSystem* EnemyDeathEffect, bool bKilledFromBoost)
+void AEnemySpawner::OnEnemyDeath(FVector EnemyDeathPosition, UNiagaraSystem* EnemyDeathEffect, bool bKilledFromBoost, int32 EnemyScoreValue)
 {
 	//UE_LOG(LogEnemySpawner, Warning, TEXT("%s - EnemyDeathPosition: %s"), ANSI_TO_TCHAR(__FUNCTION__), *EnemyDeathPosition.ToString());
 
@@ -183,7 +246,7 @@ void AEnemySpawner::OnEnemyDeath(FVector EnemyDeathPosition, UNiagaraSystem* Ene
 		SpawnParams.Scale = FVector::OneVector;
 		SpawnParams.bAutoDestroy = true;
 		SpawnParams.bAutoActivate = true;
-		SpawnParams.PoolingMethod = ToPSCPoolMethod(ENCPoolMethod::None);
+		SpawnParams.PoolingMethod = ToPSCPoolMethod(ENCPoolMethod::AutoRelease); // Reuse finished components instead of creating garbage on every kill
 		SpawnParams.bPreCullCheck = true;
 		UNiagaraFunctionLibrary::SpawnSystemAtLocationWithParams(SpawnParams);
 	}
@@ -7,8 +7,6 @@
 
 DEFINE_LOG_CATEGORY_STATIC(LogExplosion, Log, All)
 
-const FVector AExplosionBase::InactivePosition = FVector(9000.0f, -9000.0f, -9000.0f);
-
 AExplosionBase::AExplosionBase()
 {
 	//UE_LOG(LogExplosion, Log, TEXT("AExplosionBase::AExplosionBase - %s"), *GetName());
@@ -63,11 +61,6 @@ void AExplosionBase::BeginPlay()
 	}
 }
 
-FVector AExplosionBase::GetInactivePoolObjectPosition() const
-{
-	return InactivePosition;
-}
-
 void AExplosionBase::OnExplosionAnimationFinished()
 {
 	//UE_LOG(LogExplosion, Log, TEXT("AExplosionBase::OnExplosionAnimationFinished - %s"), *GetName());
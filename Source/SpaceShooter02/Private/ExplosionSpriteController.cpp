@@ -3,18 +3,12 @@
 #include "ExplosionSpriteController.h"
 
 #include "ExplosionBase.h"
-#include "ExplosionSpritePoolContainer.h"
-
-DEFINE_LOG_CATEGORY_STATIC(LogExplosionSpriteController, Log, All)
-
-void UExplosionSpriteController::BeginDestroy()
-{
-	Super::BeginDestroy();
-}
+#include "SpaceShooterPoolSubsystem.h"
 
 void UExplosionSpriteController::InitExplosionSpritePools()
 {
-	if (ExplosionSpriteClasses.Num() <= 0)
+	USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld());
+	if (PoolSubsystem == nullptr || ExplosionSpriteClasses.Num() <= 0)
 	{
 		return;
 	}
@@ -23,24 +17,7 @@ void UExplosionSpriteController::InitExplosionSpritePools()
 	{
 		if (ensureAlways(ExplosionSpriteClass != nullptr))
 		{
-			// Create a new pool
-			UExplosionSpritePoolContainer* ExplosionSpritePoolContainer = NewObject<UExplosionSpritePoolContainer>(this, UExplosionSpritePoolContainer::StaticClass());
-			if (ExplosionSpritePoolContainer != nullptr)
-			{
-				ExplosionSpritePoolContainers.Add(ExplosionSpritePoolContainer);
-				ExplosionSpritePoolContainer->InitExplosionSpritePool(ExplosionSpriteClass);
-			}
-		}
-	}
-}
-
-void UExplosionSpriteController::ResetExplosionSpritePools()
-{
-	for (UExplosionSpritePoolContainer* ExplosionSpritePoolContainer : ExplosionSpritePoolContainers)
-	{
-		if (ExplosionSpritePoolContainer != nullptr)
-		{
-			ExplosionSpritePoolContainer->ResetExplosionSpritePool();
+			PoolSubsystem->CreatePool(ExplosionSpriteClass, MAX_EXPLOSION_SPRITES_PER_POOL, GrowthSettings);
 		}
 	}
 }
@@ -48,11 +25,11 @@ void UExplosionSpriteController::ResetExplosionSpritePools()
 AExplosionBase* UExplosionSpriteController::GetRandomInactiveExplosionSprite()
 {
 	AExplosionBase* ExplosionSprite = nullptr;
-	int32 RandomIndex = FMath::RandRange(0, ExplosionSpritePoolContainers.Num() - 1);
-	UExplosionSpritePoolContainer* PoolContainer = ExplosionSpritePoolContainers[RandomIndex];
-	if (PoolContainer != nullptr)
+	USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld());
+	if (PoolSubsystem != nullptr && ExplosionSpriteClasses.Num() > 0)
 	{
-		ExplosionSprite = PoolContainer->GetInactiveExplosionSprite();
+		int32 RandomIndex = FMath::RandRange(0, ExplosionSpriteClasses.Num() - 1);
+		ExplosionSprite = PoolSubsystem->AcquirePoolActor(ExplosionSpriteClasses[RandomIndex]);
 	}
 	return ExplosionSprite;
 }
@@ -0,0 +1,160 @@
+// Copyright 2024 Richard Skala
+
+#include "ImpactEffectSubsystem.h"
+
+#include "NiagaraComponent.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+
+#include "SpaceShooter02.h"
+
+DECLARE_CYCLE_STAT(TEXT("Impact Effect Flush"), STAT_ImpactEffectFlush, STATGROUP_SpaceShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Impact Effect Allocations Per Second"), STAT_ImpactEffectAllocationsPerSecond, STATGROUP_SpaceShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Impact Effects Played"), STAT_NumImpactEffectsPlayed, STATGROUP_SpaceShooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Impact Effects Merged Or Dropped"), STAT_NumImpactEffectsSkipped, STATGROUP_SpaceShooter);
+
+DEFINE_LOG_CATEGORY_STATIC(LogImpactEffects, Log, All)
+
+void UImpactEffectSubsystem::Deinitialize()
+{
+	for (TPair<TObjectPtr<UNiagaraSystem>, FImpactEffectPool>& ImpactEffectPoolPair : ImpactEffectPools)
+	{
+		for (UNiagaraComponent* Component : ImpactEffectPoolPair.Value.Components)
+		{
+			if (IsValid(Component))
+			{
+				Component->DestroyComponent();
+			}
+		}
+	}
+	ImpactEffectPools.Empty();
+	PendingImpactEffects.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UImpactEffectSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UImpactEffectSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Runs after every actor has ticked, so every impact of this frame has been queued
+	FlushImpactEffects();
+	UpdateAllocationStats();
+}
+
+void UImpactEffectSubsystem::CreateImpactEffectPool(UNiagaraSystem* ImpactEffect)
+{
+	UWorld* World = GetWorld();
+	if (ImpactEffect == nullptr || World == nullptr || ImpactEffectPools.Contains(ImpactEffect))
+	{
+		return;
+	}
+
+	FImpactEffectPool& ImpactEffectPool = ImpactEffectPools.Add(ImpactEffect);
+	const int32 PoolSize = FMath::Max(ImpactEffectPoolSize, 1);
+	ImpactEffectPool.Components.Reserve(PoolSize);
+	for (int32 i = 0; i < PoolSize; ++i)
+	{
+		// Components are kept for the life of the world, so they are not auto destroyed or handed to the Niagara world pool
+		UNiagaraComponent* Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+			World, ImpactEffect, FVector::ZeroVector, FRotator::ZeroRotator, FVector::OneVector, false, false, ENCPoolMethod::None);
+		if (Component != nullptr)
+		{
+			ImpactEffectPool.Components.Add(Component);
+			++NumAllocationsThisSecond;
+		}
+	}
+
+	UE_LOG(LogImpactEffects, Log, TEXT("Created impact effect pool for %s with %d components"), *ImpactEffect->GetName(), ImpactEffectPool.Components.Num());
+}
+
+void UImpactEffectSubsystem::SpawnImpactEffect(UNiagaraSystem* ImpactEffect, const FVector& Location, const FRotator& Rotation)
+{
+	if (ImpactEffect != nullptr)
+	{
+		PendingImpactEffects.Add({ ImpactEffect, Location, Rotation });
+	}
+}
+
+void UImpactEffectSubsystem::FlushImpactEffects()
+{
+	if (PendingImpactEffects.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_ImpactEffectFlush);
+
+	const double MergeDistanceSquared = FMath::Square(FMath::Max(ImpactEffectMergeDistance, 0.0f));
+	PlayedImpactEffects.Reset();
+	for (const FImpactEffectRequest& ImpactEffectRequest : PendingImpactEffects)
+	{
+		if (PlayedImpactEffects.Num() >= FMath::Max(MaxImpactEffectsPerFrame, 1))
+		{
+			break;
+		}
+
+		// Skip impacts close to one that is already playing this frame
+		const bool bMerged = PlayedImpactEffects.ContainsByPredicate([&ImpactEffectRequest, MergeDistanceSquared](const FImpactEffectRequest& PlayedImpactEffect)
+		{
+			return PlayedImpactEffect.ImpactEffect == ImpactEffectRequest.ImpactEffect
+				&& FVector::DistSquared(PlayedImpactEffect.Location, ImpactEffectRequest.Location) <= MergeDistanceSquared;
+		});
+		if (bMerged)
+		{
+			continue;
+		}
+
+		FImpactEffectPool* ImpactEffectPool = ImpactEffectPools.Find(ImpactEffectRequest.ImpactEffect);
+		if (ImpactEffectPool == nullptr)
+		{
+			CreateImpactEffectPool(ImpactEffectRequest.ImpactEffect);
+			ImpactEffectPool = ImpactEffectPools.Find(ImpactEffectRequest.ImpactEffect);
+		}
+
+		if (ImpactEffectPool != nullptr && ImpactEffectPool->Components.Num() > 0)
+		{
+			PlayImpactEffect(*ImpactEffectPool, ImpactEffectRequest.Location, ImpactEffectRequest.Rotation);
+			PlayedImpactEffects.Add(ImpactEffectRequest);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_NumImpactEffectsPlayed, PlayedImpactEffects.Num());
+	SET_DWORD_STAT(STAT_NumImpactEffectsSkipped, PendingImpactEffects.Num() - PlayedImpactEffects.Num());
+	PendingImpactEffects.Reset();
+}
+
+void UImpactEffectSubsystem::PlayImpactEffect(FImpactEffectPool& ImpactEffectPool, const FVector& Location, const FRotator& Rotation)
+{
+	UNiagaraComponent* Component = ImpactEffectPool.Components[ImpactEffectPool.NextComponentIndex];
+	ImpactEffectPool.NextComponentIndex = (ImpactEffectPool.NextComponentIndex + 1) % ImpactEffectPool.Components.Num();
+
+	if (IsValid(Component))
+	{
+		// Restarts the effect if the component is still playing its previous impact
+		Component->SetWorldLocationAndRotation(Location, Rotation);
+		Component->ActivateSystem(true);
+	}
+}
+
+void UImpactEffectSubsystem::UpdateAllocationStats()
+{
+	const UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	const double CurrentTimeSeconds = World->GetTimeSeconds();
+	if (CurrentTimeSeconds - AllocationStatsStartTimeSeconds >= 1.0)
+	{
+		SET_DWORD_STAT(STAT_ImpactEffectAllocationsPerSecond, NumAllocationsThisSecond);
+		NumAllocationsThisSecond = 0;
+		AllocationStatsStartTimeSeconds = CurrentTimeSeconds;
+	}
+}
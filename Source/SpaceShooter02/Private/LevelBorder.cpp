@@ -43,6 +43,11 @@ void ALevelBorder::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 }
 
+FBox ALevelBorder::GetBorderBounds() const
+{
+	return BoxComp != nullptr ? BoxComp->CalcBounds(BoxComp->GetComponentTransform()).GetBox() : FBox(ForceInit);
+}
+
 void ALevelBorder::BeginPlay()
 {
 	Super::BeginPlay();
@@ -3,12 +3,11 @@
 #include "PickupItemBase.h"
 
 #include "Components/SphereComponent.h"
-#include "Kismet/GameplayStatics.h"
 #include "PaperSpriteComponent.h"
 
+#include "ArenaCollisionSubsystem.h"
 #include "PlayerShipPawn.h"
-
-const FVector APickupItemBase::InactivePosition = FVector(-9000.0f, 9000.0f, 9000.0f);
+#include "TargetRegistrySubsystem.h"
 
 APickupItemBase::APickupItemBase()
 {
@@ -21,24 +20,30 @@ APickupItemBase::APickupItemBase()
 	PaperSpriteComp->SetupAttachment(RootComponent);
 }
 
-void APickupItemBase::Tick(float DeltaTime)
+void APickupItemBase::BatchTickPickupItems(TArrayView<APoolActor* const> PoolActors, float DeltaTime)
 {
-	Super::Tick(DeltaTime);
-	UpdateTargetAttraction(DeltaTime);
-	UpdateMovement(DeltaTime);
+	for (APoolActor* PoolActor : PoolActors)
+	{
+		APickupItemBase* PickupItem = static_cast<APickupItemBase*>(PoolActor);
+		if (PickupItem->bIsPoolObjectActive)
+		{
+			PickupItem->UpdateTargetAttraction(DeltaTime);
+			PickupItem->UpdateMovement(DeltaTime);
+		}
+	}
 }
 
 void APickupItemBase::ActivatePoolObject()
 {
 	Super::ActivatePoolObject();
-	AttractionTargetActor = nullptr;
+	AttractionTargetIndex = INDEX_NONE;
 	APlayerShipPawn::OnPlayerShipDestroyed.AddUniqueDynamic(this, &ThisClass::OnPlayerShipDestroyed);
 }
 
 void APickupItemBase::DeactivatePoolObject()
 {
 	Super::DeactivatePoolObject();
-	AttractionTargetActor = nullptr;
+	AttractionTargetIndex = INDEX_NONE;
 	APlayerShipPawn::OnPlayerShipDestroyed.RemoveDynamic(this, &ThisClass::OnPlayerShipDestroyed);
 }
 
@@ -57,24 +62,8 @@ void APickupItemBase::BeginPlay()
 	float zDir = FMath::Sin(FMath::DegreesToRadians(RandomAngle));
 	MovementDirection = FVector(xDir, 0.0f, zDir);
 
-	// Just get the player. TODO: Pass into the pickup item when "spawned" from pickup item spawner.
-	PlayerShipPawn = UGameplayStatics::GetActorOfClass(GetWorld(), APlayerShipPawn::StaticClass());
-}
-
-FVector APickupItemBase::GetInactivePoolObjectPosition() const
-{
-	return InactivePosition;
-}
-
-void APickupItemBase::UpdateLifetime(float DeltaTime)
-{
-	// Do not update lifetime if attracting to target so it doesn't disappear while being pulled in
-	if (IsAttractingToTarget())
-	{
-		return;
-	}
-
-	Super::UpdateLifetime(DeltaTime);
+	ArenaCollision = UWorld::GetSubsystem<UArenaCollisionSubsystem>(GetWorld());
+	TargetRegistry = UWorld::GetSubsystem<UTargetRegistrySubsystem>(GetWorld());
 }
 
 void APickupItemBase::UpdateMovement(float DeltaTime)
@@ -91,14 +80,16 @@ void APickupItemBase::UpdateMovement(float DeltaTime)
 
 void APickupItemBase::UpdateAttractionMovement(float DeltaTime)
 {
-	if (AttractionTargetActor == nullptr)
+	const UTargetRegistrySubsystem* TargetRegistrySubsystem = TargetRegistry.Get();
+	const FTargetSnapshot* AttractionTarget = TargetRegistrySubsystem != nullptr ? TargetRegistrySubsystem->GetTarget(AttractionTargetIndex) : nullptr;
+	if (AttractionTarget == nullptr)
 	{
 		return;
 	}
 
 	// Move this pickup item in the direction of its target
 	FVector PickupItemPosition = GetActorLocation();
-	FVector AttractionMovementDirection = (AttractionTargetActor->GetActorLocation() - PickupItemPosition).GetSafeNormal();
+	FVector AttractionMovementDirection = (AttractionTarget->Position - PickupItemPosition).GetSafeNormal();
 	MovementDirection = AttractionMovementDirection; // Set the MovementDirection in case the player dies while attracting
 	FVector NewPickupItemPosition = PickupItemPosition + AttractionMovementDirection * AttractionMovementSpeed * DeltaTime;
 	SetActorLocation(NewPickupItemPosition);
@@ -113,30 +104,19 @@ void APickupItemBase::UpdateNonAttractionMovement(float DeltaTime)
 	FVector NewPickupItemPosition = GetActorLocation() + MovementAmount;
 	SetActorLocation(NewPickupItemPosition);
 
-	if (UWorld* World = GetWorld())
+	if (UArenaCollisionSubsystem* ArenaCollisionSubsystem = ArenaCollision.Get())
 	{
-		// Use the pickup item's position as the line trace start position
-		const FVector& TraceStartPos = GetActorLocation();
-
-		// Check agains all static objects (TODO: Use custom collision object type, e.g. Walls)
-		FCollisionObjectQueryParams ObjectQueryParams(FCollisionObjectQueryParams::InitType::AllStaticObjects);
-
-		// Distance of the LineTrace. Adjust with the movement speed and deltatime
-		static const float CollisionLineTraceOffset = 2.0f;
-		float CollisionDistance = MovementSpeed * DeltaTime * CollisionLineTraceOffset;
+		// Distance to check ahead of the pickup item. Adjust with the movement speed and deltatime
+		static const float CollisionCheckDistanceMultiplier = 2.0f;
+		float CollisionDistance = MovementSpeed * DeltaTime * CollisionCheckDistanceMultiplier;
 
 		// Check collision against walls in its movement direction
-		TArray<FHitResult> HitResult;
-		const FVector& TraceEndPos = TraceStartPos + FVector(MovementDirection.X, 0.0f, MovementDirection.Z).GetSafeNormal() * CollisionDistance;
-		if (World->LineTraceMultiByObjectType(HitResult, TraceStartPos, TraceEndPos, ObjectQueryParams))
+		FArenaHit ArenaHit;
+		const FVector CheckEndPos = NewPickupItemPosition + FVector(MovementDirection.X, 0.0f, MovementDirection.Z).GetSafeNormal() * CollisionDistance;
+		if (ArenaCollisionSubsystem->SegmentVsArena(NewPickupItemPosition, CheckEndPos, ArenaHit))
 		{
-			if (HitResult.Num() > 0)
-			{
-				// Reflect against the wall and change movement direction
-				FVector ImpactNormal = HitResult[0].ImpactNormal;
-				FVector ReflectionVector = FMath::GetReflectionVector(MovementDirection, ImpactNormal);
-				MovementDirection = ReflectionVector;
-			}
+			// Reflect against the wall and change movement direction
+			MovementDirection = FMath::GetReflectionVector(MovementDirection, ArenaHit.ImpactNormal);
 		}
 	}
 }
@@ -155,14 +135,19 @@ void APickupItemBase::UpdateTargetAttraction(float DeltaTime)
 	}
 
 	// Check distance from this pickup item to the player pawn (skip if player is dead)
-	if(PlayerShipPawn.IsValid() && !PlayerShipPawn->GetPlayerDead())
+	const UTargetRegistrySubsystem* TargetRegistrySubsystem = TargetRegistry.Get();
+	const FTargetSnapshot* PlayerTarget = TargetRegistrySubsystem != nullptr ? TargetRegistrySubsystem->GetTarget(UTargetRegistrySubsystem::PLAYER_TARGET_INDEX) : nullptr;
+	if(PlayerTarget != nullptr && PlayerTarget->bAlive)
 	{
 		// Get distance from the player ship to this pickup item
-		float Distance = FVector::Distance(GetActorLocation(), PlayerShipPawn.Get()->GetActorLocation());
-		if (Distance <= TargetAttractDistance)
+		float DistanceSquared = FVector::DistSquared(GetActorLocation(), PlayerTarget->Position);
+		if (DistanceSquared <= FMath::Square(TargetAttractDistance))
 		{
 			// Player ship is within the specified distance. Set the player ship as the attraction target.
-			AttractionTargetActor = PlayerShipPawn.Get();
+			AttractionTargetIndex = UTargetRegistrySubsystem::PLAYER_TARGET_INDEX;
+
+			// Do not let the lifetime run out while being pulled in
+			PauseLifetime();
 		}
 	}
 }
@@ -175,6 +160,12 @@ void APickupItemBase::OnCollisionOverlap(
 	bool bFromSweep,
 	const FHitResult& SweepResult)
 {
+	// Collision is only disabled at the end of the frame, so ignore overlaps after this pickup was already collected
+	if (!IsPoolObjectActive())
+	{
+		return;
+	}
+
 	APlayerShipPawn* CollidingPlayerShipPawn = Cast<APlayerShipPawn>(OtherActor);
 	if (CollidingPlayerShipPawn != nullptr)
 	{
@@ -186,6 +177,9 @@ void APickupItemBase::OnCollisionOverlap(
 void APickupItemBase::OnPlayerShipDestroyed()
 {
 	APlayerShipPawn::OnPlayerShipDestroyed.RemoveDynamic(this, &ThisClass::OnPlayerShipDestroyed);
-	AttractionTargetActor = nullptr;
+	AttractionTargetIndex = INDEX_NONE;
+
+	// No longer attracting. Continue counting down the lifetime.
+	ResumeLifetime();
 }
 
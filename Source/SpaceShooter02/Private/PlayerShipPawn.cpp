@@ -23,12 +23,14 @@
 #include "Sound/SoundBase.h"
 //#include "TimerManager.h"
 
+#include "CombatCollisionSubsystem.h"
 #include "EnemyBase.h"
 #include "EnemySpawner.h"
 #include "PickupItemScoreMultiplier.h"
 #include "ProjectileBase.h"
 #include "SpaceShooterGameInstance.h"
 #include "SpaceShooterGameState.h"
+#include "TargetRegistrySubsystem.h"
 #include "UI/SpaceShooterMenuController.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogPlayerShipPawn, Warning, All)
@@ -175,6 +177,9 @@ void APlayerShipPawn::Tick(float DeltaTime)
 	UpdateMovement(DeltaTime);
 	UpdateGamepadAimFiring();
 
+	// Publish where the ship ended up, so enemies and pickups do not each have to ask it
+	PublishTargetSnapshot(DeltaTime > 0.0f ? (GetActorLocation() - MovementStartLocation) / DeltaTime : FVector::ZeroVector);
+
 	// Increase the time since last shot
 	TimeSinceLastShot += DeltaTime;
 
@@ -293,6 +298,16 @@ void APlayerShipPawn::BeginPlay()
 
 	SphereComp->OnComponentBeginOverlap.AddUniqueDynamic(this, &ThisClass::OnCollisionOverlap);
 
+	// Sweep the ship against enemies while dashing, so a fast dash can't pass through them between frames
+	if (UCombatCollisionSubsystem* CombatCollisionSubsystem = UWorld::GetSubsystem<UCombatCollisionSubsystem>(GetWorld()))
+	{
+		CombatCollisionSubsystem->SetPlayerShip(this);
+	}
+	MovementStartLocation = GetActorLocation();
+
+	TargetRegistry = UWorld::GetSubsystem<UTargetRegistrySubsystem>(GetWorld());
+	PublishTargetSnapshot(FVector::ZeroVector);
+
 	// Start ship exhaust particle deactivated
 	if (ShipExhaustParticleComp != nullptr)
 	{
@@ -345,6 +360,8 @@ void APlayerShipPawn::UpdateMovement(float DeltaTime)
 {
 	UE_LOG(LogPlayerShipPawnMovement, Verbose, TEXT("APlayerShipPawn::UpdateMovement: %s"), *MovementDirection.ToString());
 
+	MovementStartLocation = GetActorLocation();
+
 	// =======================================================================
 	// Handle Dash
 	float ModifiedMoveSpeed = MoveSpeed;
@@ -724,7 +741,9 @@ void APlayerShipPawn::OnCollisionOverlap(UPrimitiveComponent* OverlappedComponen
 	FString OtherActorName = OtherActor != nullptr ? OtherActor->GetName() : "(invalid)";
 	UE_LOG(LogPlayerShipPawn, Verbose, TEXT("APlayerShipPawn::OnCollisionOverlap - OtherActor: %s"), *OtherActorName);
 
-	if (AEnemyBase* OverlappedEnemy = Cast<AEnemyBase>(OtherActor))
+	// Enemies keep their collision until the end of the frame they were destroyed in, so skip inactive ones
+	AEnemyBase* OverlappedEnemy = Cast<AEnemyBase>(OtherActor);
+	if (OverlappedEnemy != nullptr && OverlappedEnemy->IsPoolObjectActive())
 	{
 		// The player has collided with an enemy
 		if (bIsDashing)
@@ -740,10 +759,33 @@ void APlayerShipPawn::OnCollisionOverlap(UPrimitiveComponent* OverlappedComponen
 	}
 }
 
+float APlayerShipPawn::GetCollisionRadius() const
+{
+	return SphereComp != nullptr ? SphereComp->GetScaledSphereRadius() : 0.0f;
+}
+
+void APlayerShipPawn::OnDashEnemyHit(AEnemyBase* Enemy)
+{
+	if (Enemy != nullptr && bIsDashing && !bPlayerDead)
+	{
+		// Same as a dash overlap. Kill the enemy.
+		Enemy->DestroyEnemy(true);
+	}
+}
+
+void APlayerShipPawn::OnEnemyBulletHit()
+{
+	if (!bIsDashing && !bPlayerDead)
+	{
+		KillPlayer();
+	}
+}
+
 void APlayerShipPawn::OnGameStarted()
 {
 	// TODO: Call enabled function here, but first ensure NOT dead
 	bPlayerDead = false;
+	PublishTargetSnapshot(FVector::ZeroVector);
 }
 
 void APlayerShipPawn::OnGameEnded(
@@ -1068,26 +1110,28 @@ void APlayerShipPawn::FireProjectile(FRotator ProjectileRotation)
 
 			FirePointRotatorComp->SetWorldRotation(ProjectileRotation);
 
-			FActorSpawnParameters ProjectileSpawnParameters;
-			ProjectileSpawnParameters.Name = TEXT("Projectile_");
-			ProjectileSpawnParameters.Instigator = this;
-			ProjectileSpawnParameters.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
-			ProjectileSpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-
-
+			// Gather every fire point of this shot, then fire them as one volley
+			VolleyFireTransforms.Reset();
 			if (FirePointComp1 != nullptr)
 			{
-				if (SpaceShooterGameState != nullptr)
-				{
-					SpaceShooterGameState->FireProjectile(FirePointComp1->GetComponentLocation(), FirePointComp1->GetComponentRotation(), this);
-				}
+				VolleyFireTransforms.Add(FirePointComp1->GetComponentTransform());
 			}
-
 			if (FirePointComp2 != nullptr)
 			{
-				if (SpaceShooterGameState != nullptr)
+				VolleyFireTransforms.Add(FirePointComp2->GetComponentTransform());
+			}
+
+			// At the homing powerup level, the satellite weapons fire homing projectiles as a volley of their own
+			const bool bSatellitesFireHoming = HomingPowerupLevel > 0 && CurrentPowerupLevel >= HomingPowerupLevel;
+			HomingVolleyFireTransforms.Reset();
+			GetSatelliteWeaponFireTransforms(bSatellitesFireHoming ? HomingVolleyFireTransforms : VolleyFireTransforms);
+
+			if (SpaceShooterGameState != nullptr)
+			{
+				SpaceShooterGameState->FireVolley(VolleyFireTransforms, this);
+				if (HomingVolleyFireTransforms.Num() > 0)
 				{
-					SpaceShooterGameState->FireProjectile(FirePointComp2->GetComponentLocation(), FirePointComp2->GetComponentRotation(), this);
+					SpaceShooterGameState->FireHomingVolley(HomingVolleyFireTransforms, this);
 				}
 			}
 
@@ -1096,9 +1140,6 @@ void APlayerShipPawn::FireProjectile(FRotator ProjectileRotation)
 
 			// Reset time since last shot
 			TimeSinceLastShot = 0.0f;
-
-			// Fire projectiles from Satellite weapons
-			FireProjectileFromSatelliteWeapon(World, ProjectileSpawnParameters);
 		}
 	}
 }
@@ -1133,7 +1174,7 @@ void APlayerShipPawn::KillPlayer()
 	// Play explosion effect
 	if (PlayerExplosionEffect != nullptr && PlayerExplosionEffect->IsValid())
 	{
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), PlayerExplosionEffect.Get(), GetActorLocation());
+		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), PlayerExplosionEffect.Get(), GetActorLocation(), FRotator::ZeroRotator, FVector::OneVector, true, true, ENCPoolMethod::AutoRelease);
 	}
 
 	// Destroy player ship
@@ -1145,6 +1186,9 @@ void APlayerShipPawn::KillPlayer()
 	// Mark player as dead. TODO: Add delegate and notify.
 	bPlayerDead = true;
 
+	// The ship no longer ticks, so publish that it is dead now
+	PublishTargetSnapshot(FVector::ZeroVector);
+
 	// TEMP: Stop enemy spawning manually
 	AEnemySpawner* EnemySpawner = Cast<AEnemySpawner>(UGameplayStatics::GetActorOfClass(GetWorld(), AEnemySpawner::StaticClass()));
 	if (EnemySpawner != nullptr)
@@ -1159,6 +1203,14 @@ void APlayerShipPawn::KillPlayer()
 	OnPlayerShipDestroyed.Broadcast();
 }
 
+void APlayerShipPawn::PublishTargetSnapshot(const FVector& Velocity)
+{
+	if (UTargetRegistrySubsystem* TargetRegistrySubsystem = TargetRegistry.Get())
+	{
+		TargetRegistrySubsystem->PublishTarget(UTargetRegistrySubsystem::PLAYER_TARGET_INDEX, GetActorLocation(), Velocity, !bPlayerDead);
+	}
+}
+
 void APlayerShipPawn::SetMouseCursorVisiblityFromInput(APlayerController* const PlayerController, bool bCursorVisible)
 {
 	if (PlayerController != nullptr)
@@ -1222,33 +1274,24 @@ void APlayerShipPawn::UpdateSatelliteWeaponAimRotation(FRotator AimRotation, UPa
 	}
 }
 
-void APlayerShipPawn::FireProjectileFromSatelliteWeapon(UWorld* const World, const FActorSpawnParameters& ProjectileSpawnParameters)
-{
-	FireProjectileFromSatelliteWeapon(World, SatelliteWeaponSprite1, ProjectileSpawnParameters);
-	FireProjectileFromSatelliteWeapon(World, SatelliteWeaponSprite2, ProjectileSpawnParameters);
-	FireProjectileFromSatelliteWeapon(World, SatelliteWeaponSprite3, ProjectileSpawnParameters);
-	FireProjectileFromSatelliteWeapon(World, SatelliteWeaponSprite4, ProjectileSpawnParameters);
-}
-
-void APlayerShipPawn::FireProjectileFromSatelliteWeapon(
-	UWorld* const World,
-	UPaperSpriteComponent* const SatelliteWeapon,
-	const FActorSpawnParameters& ProjectileSpawnParameters)
+void APlayerShipPawn::GetSatelliteWeaponFireTransforms(TArray<FTransform>& OutFireTransforms) const
 {
-	if (SatelliteWeapon == nullptr)
+	if (SatelliteWeaponRotatorComp == nullptr)
 	{
 		return;
 	}
 
-	// Do not fire a projectile if this satellite weapon is disabled
-	if (!SatelliteWeapon->GetVisibleFlag())
+	// The satellite weapons are only offset from their rotator and use absolute rotation, so their fire transforms
+	// come from the rotator's world transform and their own relative transforms
+	const FTransform& RotatorTransform = SatelliteWeaponRotatorComp->GetComponentTransform();
+	for (const UPaperSpriteComponent* SatelliteWeapon : { SatelliteWeaponSprite1.Get(), SatelliteWeaponSprite2.Get(), SatelliteWeaponSprite3.Get(), SatelliteWeaponSprite4.Get() })
 	{
-		return;
-	}
-
-	if (SpaceShooterGameState != nullptr)
-	{
-		SpaceShooterGameState->FireProjectile(SatelliteWeapon->GetComponentLocation(), SatelliteWeapon->GetComponentRotation(), this);
+		// Do not fire a projectile if this satellite weapon is disabled
+		if (SatelliteWeapon != nullptr && SatelliteWeapon->GetVisibleFlag())
+		{
+			const FVector SatelliteWeaponLocation = RotatorTransform.TransformPosition(SatelliteWeapon->GetRelativeLocation());
+			OutFireTransforms.Emplace(SatelliteWeapon->GetRelativeRotation(), SatelliteWeaponLocation);
+		}
 	}
 }
 
@@ -1298,7 +1341,7 @@ void APlayerShipPawn::AddSatelliteWeapon()
 	if (PlayerPowerupEffectLarge != nullptr)
 	{
 		//UNiagaraFunctionLibrary::SpawnSystemAttached(PlayerPowerupEffectLarge, RootComponent, NAME_None, FVector::ZeroVector, FRotator::ZeroRotator, EAttachLocation::SnapToTarget, true);
-		UNiagaraFunctionLibrary::SpawnSystemAttached(PlayerPowerupEffectLarge, PowerupEffectAttachPoint, NAME_None, FVector::ZeroVector, FRotator::ZeroRotator, EAttachLocation::SnapToTarget, true);
+		UNiagaraFunctionLibrary::SpawnSystemAttached(PlayerPowerupEffectLarge, PowerupEffectAttachPoint, NAME_None, FVector::ZeroVector, FRotator::ZeroRotator, EAttachLocation::SnapToTarget, true, true, ENCPoolMethod::AutoRelease);
 	}
 
 	IncrementPowerupLevel();
@@ -1405,7 +1448,7 @@ void APlayerShipPawn::PickupItemPercentChanged(float Percent)
 			// Play powerup time added effect
 			if (PlayerPowerupEffectSmall != nullptr)
 			{
-				UNiagaraFunctionLibrary::SpawnSystemAttached(PlayerPowerupEffectSmall, PowerupEffectAttachPoint, NAME_None, FVector::ZeroVector, FRotator::ZeroRotator, EAttachLocation::SnapToTarget, true);
+				UNiagaraFunctionLibrary::SpawnSystemAttached(PlayerPowerupEffectSmall, PowerupEffectAttachPoint, NAME_None, FVector::ZeroVector, FRotator::ZeroRotator, EAttachLocation::SnapToTarget, true, true, ENCPoolMethod::AutoRelease);
 			}
 
 			IncrementPowerupLevel();
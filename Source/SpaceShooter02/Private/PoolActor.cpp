@@ -2,6 +2,9 @@
 
 #include "PoolActor.h"
 
+#include "PoolActorContainer.h"
+#include "SpaceShooterPoolSubsystem.h"
+
 APoolActor::APoolActor()
 {
 	PrimaryActorTick.bCanEverTick = true;
@@ -9,52 +12,149 @@ APoolActor::APoolActor()
 
 void APoolActor::Tick(float DeltaTime)
 {
+	// Only reached by actors that tick themselves (e.g. Blueprint classes that implement Tick). Run the same batched
+	// per-frame work as pool-ticked actors, with a batch of one.
 	Super::Tick(DeltaTime);
-	UpdateLifetime(DeltaTime);
+
+	if (FPoolActorBatchTickFunction BatchTickFunction = GetPoolActorBatchTickFunction())
+	{
+		APoolActor* const ThisPoolActor = this;
+		BatchTickFunction(MakeArrayView(&ThisPoolActor, 1), DeltaTime);
+	}
 }
 
 void APoolActor::ActivatePoolObject()
 {
-	bIsPoolObjectActive = true;
-	SetActorHiddenInGame(false); // Show visible components
-	if (EnableCollisionOnActivate())
+	if (OwningPool != nullptr && !bIsPoolObjectActive)
 	{
-		SetActorEnableCollision(true); // Enable collision components
+		OwningPool->OnPoolActorActivated(this);
 	}
-	SetActorTickEnabled(true); // Start ticking
-	TimeAlive = 0.0f;
+
+	bIsPoolObjectActive = true;
+	QueuePoolObjectStateChange(); // Show, enable collision and start ticking at the end of the frame
+
+	// Restart the lifetime
+	++LifetimeGeneration;
+	LifetimeStartTimeSeconds = GetWorld() != nullptr ? GetWorld()->GetTimeSeconds() : 0.0;
+	LifetimePausedTimeSeconds = -1.0;
+	ScheduleLifetimeExpiry();
 }
 
 void APoolActor::DeactivatePoolObject()
 {
+	if (OwningPool != nullptr && bIsPoolObjectActive)
+	{
+		OwningPool->OnPoolActorDeactivated(this);
+	}
+
 	bIsPoolObjectActive = false;
-	SetActorHiddenInGame(true); // Hide visible components
-	SetActorEnableCollision(false); // Disable collision components
-	SetActorTickEnabled(false); // Stop ticking
-	SetActorLocation(GetInactivePoolObjectPosition()); // Move actor to somewhere far outside game bounds
-	TimeAlive = 0.0f;
+	QueuePoolObjectStateChange(); // Hide, disable collision and stop ticking at the end of the frame
+
+	// Cancel any scheduled expiry
+	++LifetimeGeneration;
+	LifetimePausedTimeSeconds = -1.0;
 }
 
 void APoolActor::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Always start pooled actors deactivated
+	// Always start pooled actors deactivated. This is applied right away, as the pool subsystem is only looked up afterwards.
 	DeactivatePoolObject();
+
+	// Batch all later state changes
+	PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld());
+}
+
+void APoolActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (OwningPool != nullptr)
+	{
+		OwningPool->RemovePoolActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void APoolActor::QueuePoolObjectStateChange()
+{
+	if (USpaceShooterPoolSubsystem* Subsystem = PoolSubsystem.Get())
+	{
+		Subsystem->QueuePoolObjectStateChange(this);
+	}
+	else
+	{
+		ApplyPoolObjectState();
+	}
+}
+
+void APoolActor::ApplyPoolObjectState()
+{
+	// Activating and deactivating within the same frame cancels out
+	if (bPoolObjectStateApplied == bIsPoolObjectActive)
+	{
+		return;
+	}
+	bPoolObjectStateApplied = bIsPoolObjectActive;
+
+	// Inactive actors are hidden and have no collision, so they are left where they are rather than moved out of the game bounds
+	SetActorHiddenInGame(!bIsPoolObjectActive);
+	if (!bIsPoolObjectActive || EnableCollisionOnActivate())
+	{
+		SetActorEnableCollision(bIsPoolObjectActive);
+	}
+	SetActorTickEnabled(bIsPoolObjectActive && !bTickedByPool);
 }
 
-FVector APoolActor::GetInactivePoolObjectPosition() const
+void APoolActor::SetTickedByPool(bool bInTickedByPool)
 {
-	checkf(false, TEXT("APoolActor::GetInactivePoolObjectPosition MUST be overidden in a subclass"));
-	return FVector();
+	bTickedByPool = bInTickedByPool;
+	SetActorTickEnabled(bPoolObjectStateApplied && !bTickedByPool);
+}
+
+float APoolActor::GetTimeAlive() const
+{
+	if (!bIsPoolObjectActive)
+	{
+		return 0.0f;
+	}
+
+	const double EndTimeSeconds = IsLifetimePaused() ? LifetimePausedTimeSeconds : (GetWorld() != nullptr ? GetWorld()->GetTimeSeconds() : 0.0);
+	return static_cast<float>(EndTimeSeconds - LifetimeStartTimeSeconds);
+}
+
+void APoolActor::PauseLifetime()
+{
+	if (bIsPoolObjectActive && !IsLifetimePaused() && GetWorld() != nullptr)
+	{
+		++LifetimeGeneration;
+		LifetimePausedTimeSeconds = GetWorld()->GetTimeSeconds();
+	}
+}
+
+void APoolActor::ResumeLifetime()
+{
+	if (bIsPoolObjectActive && IsLifetimePaused() && GetWorld() != nullptr)
+	{
+		LifetimeStartTimeSeconds += GetWorld()->GetTimeSeconds() - LifetimePausedTimeSeconds;
+		LifetimePausedTimeSeconds = -1.0;
+		ScheduleLifetimeExpiry();
+	}
+}
+
+void APoolActor::OnLifetimeExpired()
+{
+	DeactivatePoolObject();
 }
 
-void APoolActor::UpdateLifetime(float DeltaTime)
+void APoolActor::ScheduleLifetimeExpiry()
 {
-	TimeAlive += DeltaTime;
-	if (TimeAlive >= LifeTimeSeconds)
+	if (HasFiniteLifetime())
 	{
-		DeactivatePoolObject();
+		if (USpaceShooterPoolSubsystem* Subsystem = PoolSubsystem.Get())
+		{
+			Subsystem->ScheduleLifetimeExpiry(this, LifetimeStartTimeSeconds + LifeTimeSeconds);
+		}
 	}
 }
 
@@ -0,0 +1,90 @@
+// Copyright 2024 Richard Skala
+
+#include "PoolActorCluster.h"
+
+#include "HAL/IConsoleManager.h"
+#include "UObject/GarbageCollection.h"
+#include "UObject/UObjectArray.h"
+
+#include "PoolActor.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPoolActorCluster, Log, All)
+
+void UPoolActorCluster::CreatePoolActorCluster(TArrayView<APoolActor* const> InPoolActors)
+{
+	if (!ensureMsgf(!bClustered, TEXT("%s - Cluster already created"), ANSI_TO_TCHAR(__FUNCTION__)) || !CanCreatePoolActorClusters())
+	{
+		return;
+	}
+
+	PoolActors.Reset(InPoolActors.Num());
+	for (APoolActor* PoolActor : InPoolActors)
+	{
+		// Skip actors that are being destroyed, that gain references while in use, or that already belong to a cluster
+		if (IsValid(PoolActor) && PoolActor->CanBeInCluster() && !PoolActor->HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot) && GUObjectArray.ObjectToObjectItem(PoolActor)->GetOwnerIndex() == 0)
+		{
+			PoolActors.Add(PoolActor);
+		}
+	}
+
+	if (PoolActors.Num() == 0)
+	{
+		return;
+	}
+
+	// Everything referenced from the root that can be in a cluster (the actors, through PoolActors, and their components) is
+	// added to the cluster. Anything else the actors reference stays outside it and is still checked every pass.
+	CreateCluster();
+	bClustered = HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot);
+
+	UE_LOG(LogPoolActorCluster, Log, TEXT("Clustered %d pooled actors: %s"), PoolActors.Num(), bClustered ? TEXT("Succeeded") : TEXT("Failed"));
+}
+
+void UPoolActorCluster::DissolvePoolActorCluster()
+{
+	if (bClustered)
+	{
+		GUObjectClusters.DissolveCluster(this);
+		bClustered = false;
+	}
+	PoolActors.Empty();
+}
+
+bool UPoolActorCluster::CanCreatePoolActorClusters()
+{
+	// Matches the engine's conditions for level actor clusters
+	static const IConsoleVariable* CreateGCClustersCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.CreateGCClusters"));
+	static const IConsoleVariable* ActorClusteringEnabledCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.ActorClusteringEnabled"));
+	return FPlatformProperties::RequiresCookedData()
+		&& (CreateGCClustersCVar == nullptr || CreateGCClustersCVar->GetBool())
+		&& (ActorClusteringEnabledCVar == nullptr || ActorClusteringEnabledCVar->GetBool());
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	// Runs a full garbage collection with gc.VerifyAssumptions on. The collector then checks that every object referenced
+	// from inside a cluster is in that cluster or kept alive by it, and fails on the first reference that is not.
+	void VerifyPoolActorCluster()
+	{
+		IConsoleVariable* VerifyAssumptionsCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.VerifyAssumptions"));
+		if (VerifyAssumptionsCVar == nullptr || !UPoolActorCluster::CanCreatePoolActorClusters())
+		{
+			UE_LOG(LogPoolActorCluster, Warning, TEXT("SpaceShooter.VerifyPoolActorCluster - GC clusters or gc.VerifyAssumptions are not available in this build"));
+			return;
+		}
+
+		const int32 PreviousVerifyAssumptions = VerifyAssumptionsCVar->GetInt();
+		VerifyAssumptionsCVar->Set(1, ECVF_SetByCode);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		VerifyAssumptionsCVar->Set(PreviousVerifyAssumptions, ECVF_SetByCode);
+
+		UE_LOG(LogPoolActorCluster, Log, TEXT("SpaceShooter.VerifyPoolActorCluster - Garbage collection verified the GC clusters"));
+	}
+}
+
+static FAutoConsoleCommand VerifyPoolActorClusterCommand(
+	TEXT("SpaceShooter.VerifyPoolActorCluster"),
+	TEXT("Runs a garbage collection with gc.VerifyAssumptions, to check that no clustered pooled actor references an object outside the cluster. Run during a game."),
+	FConsoleCommandDelegate::CreateStatic(&VerifyPoolActorCluster));
+#endif // !UE_BUILD_SHIPPING
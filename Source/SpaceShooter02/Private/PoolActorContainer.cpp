@@ -0,0 +1,453 @@
+// Copyright 2024 Richard Skala
+
+#include "PoolActorContainer.h"
+
+#include "TimerManager.h"
+
+#include "SpaceShooter02.h"
+#include "UObjectCreationTracker.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pool Acquire"), STAT_PoolAcquire, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Pool Reset"), STAT_PoolReset, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Pool Grow"), STAT_PoolGrow, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Pool Tick"), STAT_PoolTick, STATGROUP_SpaceShooter);
+
+DEFINE_LOG_CATEGORY_STATIC(LogPoolActorContainer, Log, All)
+
+void FPoolActorContainerBase::InitPool(UObject* InPoolOwner, FName InPoolName, const FPoolGrowthSettings& InGrowthSettings, FCreatePoolActorDelegate InCreatePoolActor)
+{
+	PoolOwner = InPoolOwner;
+	PoolName = InPoolName;
+	GrowthSettings = InGrowthSettings;
+	CreatePoolActor = MoveTemp(InCreatePoolActor);
+}
+
+void FPoolActorContainerBase::EnablePoolTick(UWorld* World, FPoolActorBatchTickFunction InBatchTickFunction)
+{
+	if (!ensure(World != nullptr) || !ensureMsgf(GetNum() == 0, TEXT("Pool %s already has actors"), *PoolName.ToString()))
+	{
+		return;
+	}
+
+	bPoolTickEnabled = true;
+	BatchTickFunction = InBatchTickFunction;
+	if (BatchTickFunction == nullptr)
+	{
+		// Nothing to do per frame
+		return;
+	}
+
+	// Same tick group the actors used to tick in
+	PoolTickFunction.Pool = this;
+	PoolTickFunction.TickGroup = TG_PrePhysics;
+	PoolTickFunction.bCanEverTick = true;
+	PoolTickFunction.bStartWithTickEnabled = true;
+	PoolTickFunction.RegisterTickFunction(World->PersistentLevel);
+}
+
+void FPoolActorContainerBase::AddPoolActor(APoolActor* PoolActor)
+{
+	if (!ensure(PoolActor != nullptr))
+	{
+		return;
+	}
+
+	if (!ensureMsgf(PoolActor->OwningPool == nullptr, TEXT("%s is already in a pool"), *PoolActor->GetName()))
+	{
+		return;
+	}
+
+	PoolActor->OwningPool = this;
+	if (bPoolTickEnabled)
+	{
+		PoolActor->SetTickedByPool(true);
+	}
+
+	if (PoolActor->IsPoolObjectActive())
+	{
+		PoolActor->PoolSlotIndex = ActivePoolActors.Add(PoolActor);
+		PoolActor->PoolActivationSerial = ++LastActivationSerial;
+		RecordActivation(PoolActor);
+		PeakNumActive = FMath::Max(PeakNumActive, ActivePoolActors.Num());
+	}
+	else
+	{
+		PoolActor->PoolSlotIndex = FreePoolActors.Add(PoolActor);
+	}
+}
+
+void FPoolActorContainerBase::RemovePoolActor(APoolActor* PoolActor)
+{
+	if (PoolActor == nullptr || PoolActor->OwningPool != this)
+	{
+		return;
+	}
+
+	RemoveAtSlot(PoolActor->IsPoolObjectActive() ? ActivePoolActors : FreePoolActors, PoolActor->PoolSlotIndex);
+	PoolActor->OwningPool = nullptr;
+	PoolActor->SetTickedByPool(false);
+	PoolActor->PoolSlotIndex = INDEX_NONE;
+}
+
+int32 FPoolActorContainerBase::ResetPool(int32 MaxNumToReset /*= MAX_int32*/)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoolReset);
+
+	// Start counting down to a shrink from the reset
+	LowWaterStartTimeSeconds = -1.0;
+
+	// Only the active actors need deactivating. Walk backwards, as each deactivation removes the actor from the active list.
+	int32 NumReset = 0;
+	for (int32 ActiveIndex = ActivePoolActors.Num() - 1; ActiveIndex >= 0 && NumReset < MaxNumToReset; --ActiveIndex)
+	{
+		if (!ActivePoolActors.IsValidIndex(ActiveIndex))
+		{
+			continue;
+		}
+
+		APoolActor* PoolActor = ActivePoolActors[ActiveIndex];
+		if (PoolActor != nullptr)
+		{
+			PoolActor->DeactivatePoolObject();
+			++NumReset;
+		}
+		else
+		{
+			// The actor was garbage collected. Drop the stale entry.
+			ActivePoolActors.RemoveAtSwap(ActiveIndex, 1, EAllowShrinking::No);
+			if (ActivePoolActors.IsValidIndex(ActiveIndex) && ActivePoolActors[ActiveIndex] != nullptr)
+			{
+				ActivePoolActors[ActiveIndex]->PoolSlotIndex = ActiveIndex;
+			}
+		}
+	}
+	return NumReset;
+}
+
+void FPoolActorContainerBase::Empty()
+{
+	// Make sure no actor outlives its pool while still pointing at it
+	for (TObjectPtr<APoolActor>& PoolActor : ActivePoolActors)
+	{
+		if (PoolActor != nullptr)
+		{
+			PoolActor->OwningPool = nullptr;
+			PoolActor->PoolSlotIndex = INDEX_NONE;
+		}
+	}
+
+	for (TObjectPtr<APoolActor>& PoolActor : FreePoolActors)
+	{
+		if (PoolActor != nullptr)
+		{
+			PoolActor->OwningPool = nullptr;
+			PoolActor->PoolSlotIndex = INDEX_NONE;
+		}
+	}
+
+	ActivePoolActors.Empty();
+	FreePoolActors.Empty();
+	TickingPoolActors.Empty();
+	ActivationOrder.Empty();
+
+	if (PoolTickFunction.IsTickFunctionRegistered())
+	{
+		PoolTickFunction.UnRegisterTickFunction();
+	}
+	bPoolTickEnabled = false;
+	BatchTickFunction = nullptr;
+}
+
+void FPoolActorContainerBase::UpdateShrink(double CurrentTimeSeconds)
+{
+	if (GrowthSettings.ShrinkDelaySeconds <= 0.0f || GetNum() <= StartupPoolSize)
+	{
+		return;
+	}
+
+	const int32 LowWaterMark = FMath::FloorToInt32(GetNum() * GrowthSettings.LowWaterMarkFraction);
+	if (GetNumActive() > LowWaterMark)
+	{
+		LowWaterStartTimeSeconds = -1.0;
+		return;
+	}
+
+	if (LowWaterStartTimeSeconds < 0.0)
+	{
+		LowWaterStartTimeSeconds = CurrentTimeSeconds;
+		return;
+	}
+
+	if (CurrentTimeSeconds - LowWaterStartTimeSeconds < GrowthSettings.ShrinkDelaySeconds)
+	{
+		return;
+	}
+
+	// Destroy free actors until the pool is back to its startup size
+	const int32 NumToDestroy = FMath::Min(GetNumFree(), GetNum() - StartupPoolSize);
+	UE_LOG(LogPoolActorContainer, Log, TEXT("Pool %s has been idle for %.1f seconds. Shrinking from %d to %d actors."),
+		*PoolName.ToString(), GrowthSettings.ShrinkDelaySeconds, GetNum(), GetNum() - NumToDestroy);
+
+	for (int32 i = 0; i < NumToDestroy; ++i)
+	{
+		APoolActor* PoolActor = FreePoolActors.Last();
+		RemovePoolActor(PoolActor);
+		if (PoolActor != nullptr)
+		{
+			PoolActor->Destroy();
+		}
+	}
+
+	LowWaterStartTimeSeconds = -1.0;
+}
+
+void FPoolActorContainerBase::GetAllPoolActors(TArray<APoolActor*>& OutPoolActors) const
+{
+	OutPoolActors.Reserve(OutPoolActors.Num() + GetNum());
+	OutPoolActors.Append(ActivePoolActors);
+	OutPoolActors.Append(FreePoolActors);
+}
+
+void FPoolActorContainerBase::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(ActivePoolActors);
+	Collector.AddReferencedObjects(FreePoolActors);
+}
+
+APoolActor* FPoolActorContainerBase::AcquireInternal() const
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoolAcquire);
+	return FreePoolActors.Num() > 0 ? FreePoolActors.Last().Get() : nullptr;
+}
+
+TConstArrayView<TObjectPtr<APoolActor>> FPoolActorContainerBase::AcquireMultipleInternal(int32 Num) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoolAcquire);
+	const int32 NumToAcquire = FMath::Clamp(Num, 0, FreePoolActors.Num());
+	return TConstArrayView<TObjectPtr<APoolActor>>(FreePoolActors).Slice(FreePoolActors.Num() - NumToAcquire, NumToAcquire);
+}
+
+APoolActor* FPoolActorContainerBase::AcquireOrGrowInternal()
+{
+	if (APoolActor* PoolActor = AcquireInternal())
+	{
+		return PoolActor;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_PoolGrow);
+	NumMisses++;
+
+	// Growth is designed behaviour, not gameplay garbage
+	FUObjectCreationTracker::FIgnoreScope IgnoreObjectCreation;
+
+	// A deferred grow event is already pending. Spawn a single actor to satisfy this request.
+	if (NumPendingPoolActors > 0)
+	{
+		NumPendingPoolActors--;
+		return CreatePoolActor.IsBound() ? CreatePoolActor.Execute() : nullptr;
+	}
+
+	// At the cap, reuse the oldest active actor instead of growing
+	if (GrowthSettings.GrowthPolicy == EPoolGrowthPolicy::CapAndRecycleOldest && GetNum() >= GrowthSettings.MaxPoolSize)
+	{
+		return RecycleOldestActive();
+	}
+
+	if (!ensureMsgf(CreatePoolActor.IsBound(), TEXT("Pool %s cannot grow. InitPool was not called."), *PoolName.ToString()))
+	{
+		return nullptr;
+	}
+
+	const int32 GrowAmount = GetGrowAmount();
+	NumGrowEvents++;
+
+	// Log once per grow event rather than once per miss
+	UE_LOG(LogPoolActorContainer, Warning, TEXT("Pool %s ran out of actors. Growing by %d (current size: %d). Consider increasing the pool size."),
+		*PoolName.ToString(), GrowAmount, GetNum());
+
+	// Spawn the actor needed right now. The rest of the chunk is spawned next frame if growth is deferred.
+	APoolActor* NewPoolActor = CreatePoolActor.Execute();
+	NumPendingPoolActors = GrowAmount - 1;
+
+	UWorld* World = PoolOwner.IsValid() ? PoolOwner->GetWorld() : nullptr;
+	if (GrowthSettings.bDeferGrowth && World != nullptr)
+	{
+		if (NumPendingPoolActors > 0)
+		{
+			World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(PoolOwner.Get(), [this]()
+			{
+				CreatePendingPoolActors();
+			}));
+		}
+	}
+	else
+	{
+		CreatePendingPoolActors();
+	}
+
+	return NewPoolActor;
+}
+
+void FPoolActorContainerBase::OnPoolActorActivated(APoolActor* PoolActor)
+{
+	// Move the actor from the free list to the active list
+	if (ensureMsgf(
+		FreePoolActors.IsValidIndex(PoolActor->PoolSlotIndex) && FreePoolActors[PoolActor->PoolSlotIndex] == PoolActor,
+		TEXT("%s - Pool free list is out of sync for %s"), ANSI_TO_TCHAR(__FUNCTION__), *PoolActor->GetName()))
+	{
+		RemoveAtSlot(FreePoolActors, PoolActor->PoolSlotIndex);
+		PoolActor->PoolSlotIndex = ActivePoolActors.Add(PoolActor);
+		PoolActor->PoolActivationSerial = ++LastActivationSerial;
+		RecordActivation(PoolActor);
+		PeakNumActive = FMath::Max(PeakNumActive, ActivePoolActors.Num());
+	}
+}
+
+void FPoolActorContainerBase::OnPoolActorDeactivated(APoolActor* PoolActor)
+{
+	// Move the actor from the active list back onto the free list
+	if (ensureMsgf(
+		ActivePoolActors.IsValidIndex(PoolActor->PoolSlotIndex) && ActivePoolActors[PoolActor->PoolSlotIndex] == PoolActor,
+		TEXT("%s - Pool active list is out of sync for %s"), ANSI_TO_TCHAR(__FUNCTION__), *PoolActor->GetName()))
+	{
+		RemoveAtSlot(ActivePoolActors, PoolActor->PoolSlotIndex);
+		PoolActor->PoolSlotIndex = FreePoolActors.Add(PoolActor);
+
+		// Every record left is stale once nothing is active
+		if (ActivePoolActors.Num() == 0)
+		{
+			ActivationOrder.Reset();
+		}
+	}
+}
+
+/*static*/ void FPoolActorContainerBase::RemoveAtSlot(TArray<TObjectPtr<APoolActor>>& PoolActorList, int32 SlotIndex)
+{
+	if (!PoolActorList.IsValidIndex(SlotIndex))
+	{
+		return;
+	}
+
+	// Swap the last actor into the removed slot so the list stays dense
+	PoolActorList.RemoveAtSwap(SlotIndex, 1, EAllowShrinking::No);
+	if (PoolActorList.IsValidIndex(SlotIndex) && PoolActorList[SlotIndex] != nullptr)
+	{
+		PoolActorList[SlotIndex]->PoolSlotIndex = SlotIndex;
+	}
+}
+
+int32 FPoolActorContainerBase::GetGrowAmount() const
+{
+	int32 GrowAmount = 1;
+	switch (GrowthSettings.GrowthPolicy)
+	{
+		case EPoolGrowthPolicy::FixedChunk: GrowAmount = GrowthSettings.ChunkSize; break;
+		case EPoolGrowthPolicy::Geometric: GrowAmount = FMath::CeilToInt32(GetNum() * GrowthSettings.GrowthFactor); break;
+		case EPoolGrowthPolicy::CapAndRecycleOldest: GrowAmount = FMath::Min(GrowthSettings.ChunkSize, GrowthSettings.MaxPoolSize - GetNum()); break;
+		default: break;
+	}
+	return FMath::Max(GrowAmount, 1);
+}
+
+APoolActor* FPoolActorContainerBase::RecycleOldestActive()
+{
+	// Actors deactivated (or reused) since they were recorded have left stale records at the front. Each record is only popped once.
+	while (ActivationOrder.Num() > 0 && !IsActivationCurrent(ActivationOrder.First()))
+	{
+		ActivationOrder.PopFront();
+	}
+
+	APoolActor* OldestPoolActor = ActivationOrder.Num() > 0 ? ActivationOrder.PopFrontValue().PoolActor.Get() : nullptr;
+	if (OldestPoolActor != nullptr)
+	{
+		// Deactivating pushes the actor on top of the free list, where the caller will take it from
+		OldestPoolActor->DeactivatePoolObject();
+	}
+	return OldestPoolActor;
+}
+
+void FPoolActorContainerBase::RecordActivation(APoolActor* PoolActor)
+{
+	if (GrowthSettings.GrowthPolicy != EPoolGrowthPolicy::CapAndRecycleOldest)
+	{
+		return;
+	}
+
+	// Actors deactivated out of order leave stale records behind the oldest active actor. Drop them once they make up
+	// half of the records, which keeps the cost amortized O(1) per activation and the buffer at most twice the active count.
+	// Compacted before adding, as the actor being activated is not flagged active yet.
+	static constexpr int32 MinActivationRecordsToCompact = 64;
+	const int32 NumRecords = ActivationOrder.Num();
+	if (NumRecords >= MinActivationRecordsToCompact && NumRecords > 2 * ActivePoolActors.Num())
+	{
+		for (int32 i = 0; i < NumRecords; ++i)
+		{
+			FActivationRecord Record = ActivationOrder.PopFrontValue();
+			if (IsActivationCurrent(Record))
+			{
+				ActivationOrder.Add(MoveTemp(Record));
+			}
+		}
+	}
+
+	ActivationOrder.Add({ PoolActor, PoolActor->PoolActivationSerial });
+}
+
+bool FPoolActorContainerBase::IsActivationCurrent(const FActivationRecord& Record) const
+{
+	const APoolActor* RecordedPoolActor = Record.PoolActor.Get();
+	return RecordedPoolActor != nullptr && RecordedPoolActor->OwningPool == this && RecordedPoolActor->IsPoolObjectActive()
+		&& RecordedPoolActor->PoolActivationSerial == Record.ActivationSerial;
+}
+
+void FPoolActorContainerBase::CreatePendingPoolActors()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoolGrow);
+	FUObjectCreationTracker::FIgnoreScope IgnoreObjectCreation;
+
+	while (NumPendingPoolActors > 0 && CreatePoolActor.IsBound())
+	{
+		NumPendingPoolActors--;
+		CreatePoolActor.Execute();
+	}
+	NumPendingPoolActors = 0;
+}
+
+void FPoolActorContainerBase::TickActivePoolActors(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoolTick);
+
+	if (ActivePoolActors.Num() <= 0 || BatchTickFunction == nullptr)
+	{
+		return;
+	}
+
+	TickingPoolActors.Reset();
+	for (APoolActor* PoolActor : ActivePoolActors)
+	{
+		if (PoolActor != nullptr)
+		{
+			TickingPoolActors.Add(PoolActor);
+		}
+	}
+
+	BatchTickFunction(TickingPoolActors, DeltaTime);
+}
+
+void FPoolActorTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Pool != nullptr && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Pool->TickActivePoolActors(DeltaTime);
+	}
+}
+
+FString FPoolActorTickFunction::DiagnosticMessage()
+{
+	return FString::Printf(TEXT("FPoolActorTickFunction[%s]"), Pool != nullptr ? *Pool->GetPoolName().ToString() : TEXT("None"));
+}
+
+FName FPoolActorTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return Pool != nullptr ? Pool->GetPoolName() : NAME_None;
+}
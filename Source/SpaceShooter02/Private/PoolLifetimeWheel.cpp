@@ -0,0 +1,230 @@
+// Copyright 2024 Richard Skala
+
+#include "PoolLifetimeWheel.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#include "PoolActor.h"
+#include "ProjectileCircular.h"
+#include "SpaceShooterBenchmark.h"
+
+FPoolLifetimeWheel::FPoolLifetimeWheel(double InTickSeconds /*= 1.0 / 60.0*/)
+	: TickSeconds(FMath::Max(InTickSeconds, UE_KINDA_SMALL_NUMBER))
+{
+}
+
+void FPoolLifetimeWheel::Start(double CurrentTimeSeconds)
+{
+	Reset();
+	StartTimeSeconds = CurrentTimeSeconds;
+	CurrentTick = 0;
+}
+
+void FPoolLifetimeWheel::Schedule(APoolActor* PoolActor, uint32 Generation, double ExpiryTimeSeconds)
+{
+	if (PoolActor == nullptr)
+	{
+		return;
+	}
+
+	// Never schedule into the current tick, as it has already been processed
+	FEntry Entry;
+	Entry.PoolActor = PoolActor;
+	Entry.Generation = Generation;
+	Entry.ExpiryTick = FMath::Max(TimeToTick(ExpiryTimeSeconds), CurrentTick + 1);
+	Insert(MoveTemp(Entry));
+	++NumEntries;
+}
+
+void FPoolLifetimeWheel::Reset()
+{
+	for (int32 Level = 0; Level < NumLevels; ++Level)
+	{
+		for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+		{
+			Slots[Level][Slot].Reset();
+		}
+	}
+	OverflowEntries.Reset();
+	NumEntries = 0;
+}
+
+uint64 FPoolLifetimeWheel::TimeToTick(double TimeSeconds) const
+{
+	// Round up, so an entry never expires before its expiry time
+	const double Ticks = FMath::CeilToDouble((TimeSeconds - StartTimeSeconds) / TickSeconds);
+	return Ticks > 0.0 ? static_cast<uint64>(Ticks) : 0;
+}
+
+void FPoolLifetimeWheel::Insert(FEntry&& Entry)
+{
+	const uint64 TicksUntilExpiry = Entry.ExpiryTick > CurrentTick ? Entry.ExpiryTick - CurrentTick : 0;
+	for (int32 Level = 0; Level < NumLevels; ++Level)
+	{
+		const int32 LevelShift = Level * SlotBits;
+		if (TicksUntilExpiry < (uint64(1) << (LevelShift + SlotBits)))
+		{
+			// An entry that is already due goes in the current level 0 slot, which is processed right after a cascade
+			const uint64 Tick = FMath::Max(Entry.ExpiryTick, CurrentTick);
+			Slots[Level][(Tick >> LevelShift) & SlotMask].Add(MoveTemp(Entry));
+			return;
+		}
+	}
+	OverflowEntries.Add(MoveTemp(Entry));
+}
+
+void FPoolLifetimeWheel::StepTick()
+{
+	++CurrentTick;
+
+	// When a level's slot index wraps, the next slot of the level above starts its span. Cascade from the top down,
+	// so entries cascaded from a higher level can be cascaded again in the same step.
+	if ((CurrentTick & SlotMask) != 0)
+	{
+		return;
+	}
+
+	const uint64 Level1Slot = (CurrentTick >> SlotBits) & SlotMask;
+	if (Level1Slot == 0)
+	{
+		const uint64 Level2Slot = (CurrentTick >> (2 * SlotBits)) & SlotMask;
+		if (Level2Slot == 0)
+		{
+			Cascade(OverflowEntries);
+		}
+		Cascade(Slots[2][Level2Slot]);
+	}
+	Cascade(Slots[1][Level1Slot]);
+}
+
+void FPoolLifetimeWheel::Cascade(TArray<FEntry>& SlotEntries)
+{
+	Exchange(CascadingEntries, SlotEntries);
+	for (FEntry& Entry : CascadingEntries)
+	{
+		Insert(MoveTemp(Entry));
+	}
+	CascadingEntries.Reset();
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	static constexpr int32 NumBenchmarkFrames = 600;
+	static constexpr double BenchmarkFrameSeconds = 1.0 / 60.0;
+	static constexpr float MinBenchmarkLifeTimeSeconds = 0.5f;
+	static constexpr float MaxBenchmarkLifeTimeSeconds = 3.0f;
+
+	// Compares lifetime expiry on the timing wheel against accumulating TimeAlive on every live object each frame (the
+	// per-actor tick it replaced), for the given numbers of live objects (default 100, 1000 and 10000). Every expired
+	// object is re-armed with a new random lifetime, as if the pool reused it, so the live count stays constant.
+	void RunLifetimeWheelBenchmark(const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr)
+		{
+			return;
+		}
+
+		TArray<int32> NumsLiveObjects;
+		for (const FString& Arg : Args)
+		{
+			NumsLiveObjects.Add(FMath::Max(FCString::Atoi(*Arg), 1));
+		}
+		if (NumsLiveObjects.Num() == 0)
+		{
+			NumsLiveObjects = { 100, 1000, 10000 };
+		}
+
+		// The wheel holds weak actor pointers, so both methods run over real (inactive) pooled actors
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		TArray<APoolActor*> PoolActors;
+		const int32 MaxLiveObjects = FMath::Max(NumsLiveObjects);
+		PoolActors.Reserve(MaxLiveObjects);
+		for (int32 i = 0; i < MaxLiveObjects; ++i)
+		{
+			if (APoolActor* PoolActor = World->SpawnActor<AProjectileCircular>(AProjectileCircular::StaticClass(), FTransform::Identity, SpawnParameters))
+			{
+				PoolActors.Add(PoolActor);
+			}
+		}
+
+		TArray<float> LifeTimes;
+		TArray<float> TimesAlive;
+		for (const int32 NumLiveObjects : NumsLiveObjects)
+		{
+			const TArrayView<APoolActor* const> LiveActors = MakeArrayView(PoolActors.GetData(), FMath::Min(NumLiveObjects, PoolActors.Num()));
+
+			// Per-object accumulation. Both methods draw their lifetimes from the same seed.
+			FSpaceShooterBenchmark AccumulateBenchmark;
+			FRandomStream& AccumulateRandomStream = AccumulateBenchmark.GetRandomStream();
+			LifeTimes.SetNumUninitialized(LiveActors.Num());
+			TimesAlive.Init(0.0f, LiveActors.Num());
+			for (float& LifeTime : LifeTimes)
+			{
+				LifeTime = AccumulateRandomStream.FRandRange(MinBenchmarkLifeTimeSeconds, MaxBenchmarkLifeTimeSeconds);
+			}
+
+			int32 NumAccumulateExpiries = 0;
+			const double AccumulateMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([&]()
+			{
+				for (int32 Frame = 0; Frame < NumBenchmarkFrames; ++Frame)
+				{
+					for (int32 i = 0; i < LiveActors.Num(); ++i)
+					{
+						// The per-actor tick compared against the actor's own lifetime
+						TimesAlive[i] += static_cast<float>(BenchmarkFrameSeconds);
+						if (TimesAlive[i] >= FMath::Min(LifeTimes[i], LiveActors[i]->GetLifeTimeSeconds()))
+						{
+							TimesAlive[i] = 0.0f;
+							LifeTimes[i] = AccumulateRandomStream.FRandRange(MinBenchmarkLifeTimeSeconds, MaxBenchmarkLifeTimeSeconds);
+							++NumAccumulateExpiries;
+						}
+					}
+				}
+			});
+
+			// Timing wheel. The generation carries the object's index, as there is no pool to look it up in.
+			FSpaceShooterBenchmark WheelBenchmark;
+			FRandomStream& WheelRandomStream = WheelBenchmark.GetRandomStream();
+			FPoolLifetimeWheel LifetimeWheel(BenchmarkFrameSeconds);
+			LifetimeWheel.Start(0.0);
+			for (int32 i = 0; i < LiveActors.Num(); ++i)
+			{
+				LifetimeWheel.Schedule(LiveActors[i], i, WheelRandomStream.FRandRange(MinBenchmarkLifeTimeSeconds, MaxBenchmarkLifeTimeSeconds));
+			}
+
+			int32 NumWheelExpiries = 0;
+			const double WheelMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([&]()
+			{
+				for (int32 Frame = 1; Frame <= NumBenchmarkFrames; ++Frame)
+				{
+					const double CurrentTimeSeconds = Frame * BenchmarkFrameSeconds;
+					LifetimeWheel.Advance(CurrentTimeSeconds, [&](APoolActor* PoolActor, uint32 Generation)
+					{
+						LifetimeWheel.Schedule(PoolActor, Generation, CurrentTimeSeconds + WheelRandomStream.FRandRange(MinBenchmarkLifeTimeSeconds, MaxBenchmarkLifeTimeSeconds));
+						++NumWheelExpiries;
+					});
+				}
+			});
+
+			UE_LOG(LogSpaceShooterBenchmark, Log, TEXT("%d live objects over %d frames: TimeAlive accumulation %.3f ms per frame (%d expiries), timing wheel %.3f ms per frame (%d expiries), %.1fx"),
+				LiveActors.Num(), NumBenchmarkFrames, AccumulateMilliseconds / NumBenchmarkFrames, NumAccumulateExpiries,
+				WheelMilliseconds / NumBenchmarkFrames, NumWheelExpiries, AccumulateMilliseconds / FMath::Max(WheelMilliseconds, UE_SMALL_NUMBER));
+		}
+
+		// Don't leave the benchmark's actors in the game
+		for (APoolActor* PoolActor : PoolActors)
+		{
+			PoolActor->Destroy();
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkLifetimeWheelCommand(
+	TEXT("SpaceShooter.BenchmarkLifetimeWheel"),
+	TEXT("Compares lifetime expiry on the timing wheel against per-object TimeAlive accumulation for the given numbers of live objects (default 100, 1000 and 10000)"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunLifetimeWheelBenchmark));
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,196 @@
+// Copyright 2024 Richard Skala
+
+#include "PoolPrewarmScheduler.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#include "ProjectileCircular.h"
+#include "SpaceShooter02.h"
+#include "SpaceShooterBenchmark.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pool Prewarm"), STAT_PoolPrewarm, STATGROUP_SpaceShooter);
+
+DEFINE_LOG_CATEGORY_STATIC(LogPoolPrewarmScheduler, Log, All)
+
+// static member initialization
+FPoolPrewarmProgressDelegateSignature UPoolPrewarmScheduler::OnPoolPrewarmProgress;
+
+void UPoolPrewarmScheduler::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoolPrewarm);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double EndTime = StartTime + (FrameBudgetMs / 1000.0);
+
+	// Always create at least one actor so pre-warming makes progress even with a tiny budget
+	do
+	{
+		if (!CreateNextPoolActor())
+		{
+			break;
+		}
+	} while (FPlatformTime::Seconds() < EndTime);
+
+	NumPrewarmFrames++;
+	WorstFrameMs = FMath::Max(WorstFrameMs, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	OnPoolPrewarmProgress.Broadcast(GetProgress());
+
+	if (!IsPrewarming())
+	{
+		OnPrewarmFinished();
+	}
+}
+
+ETickableTickType UPoolPrewarmScheduler::GetTickableTickType() const
+{
+	// Do not allow ticking in the CDO
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UPoolPrewarmScheduler::IsTickable() const
+{
+	return IsPrewarming();
+}
+
+void UPoolPrewarmScheduler::AddPrewarmRequest(FName PoolName, int32 NumPoolActors, FSimpleDelegate CreatePoolActor)
+{
+	if (NumPoolActors <= 0 || !ensure(CreatePoolActor.IsBound()))
+	{
+		return;
+	}
+
+	FPoolPrewarmRequest& PrewarmRequest = PrewarmRequests.AddDefaulted_GetRef();
+	PrewarmRequest.PoolName = PoolName;
+	PrewarmRequest.NumRemaining = NumPoolActors;
+	PrewarmRequest.CreatePoolActor = MoveTemp(CreatePoolActor);
+
+	NumPoolActorsRequested += NumPoolActors;
+}
+
+void UPoolPrewarmScheduler::Flush()
+{
+	if (!IsPrewarming())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_PoolPrewarm);
+
+	UE_LOG(LogPoolPrewarmScheduler, Log, TEXT("Flushing pool pre-warm. Creating the remaining %d actors synchronously."), NumPoolActorsRequested - NumPoolActorsCreated);
+
+	const double StartTime = FPlatformTime::Seconds();
+	while (CreateNextPoolActor())
+	{
+	}
+	WorstFrameMs = FMath::Max(WorstFrameMs, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	OnPoolPrewarmProgress.Broadcast(GetProgress());
+	OnPrewarmFinished();
+}
+
+float UPoolPrewarmScheduler::GetProgress() const
+{
+	return NumPoolActorsRequested > 0 ? static_cast<float>(NumPoolActorsCreated) / static_cast<float>(NumPoolActorsRequested) : 1.0f;
+}
+
+bool UPoolPrewarmScheduler::CreateNextPoolActor()
+{
+	// Skip over finished requests
+	while (PrewarmRequests.IsValidIndex(CurrentRequestIndex) && PrewarmRequests[CurrentRequestIndex].NumRemaining <= 0)
+	{
+		CurrentRequestIndex++;
+	}
+
+	if (!PrewarmRequests.IsValidIndex(CurrentRequestIndex))
+	{
+		return false;
+	}
+
+	FPoolPrewarmRequest& PrewarmRequest = PrewarmRequests[CurrentRequestIndex];
+	PrewarmRequest.CreatePoolActor.ExecuteIfBound();
+	PrewarmRequest.NumRemaining--;
+	NumPoolActorsCreated++;
+
+	UE_CLOG(PrewarmRequest.NumRemaining == 0, LogPoolPrewarmScheduler, Verbose, TEXT("Pool %s pre-warmed"), *PrewarmRequest.PoolName.ToString());
+	return true;
+}
+
+void UPoolPrewarmScheduler::OnPrewarmFinished()
+{
+	UE_LOG(LogPoolPrewarmScheduler, Log, TEXT("Pool pre-warm finished. Created %d actors over %d frames. Worst frame: %.2f ms"), NumPoolActorsCreated, NumPrewarmFrames, WorstFrameMs);
+
+	PrewarmRequests.Empty();
+	CurrentRequestIndex = 0;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	static constexpr int32 DefaultNumBenchmarkPrewarmActors = 2000;
+	static constexpr float DefaultBenchmarkPrewarmFrameBudgetMs = 2.0f;
+	static constexpr float BenchmarkFrameSeconds = 1.0f / 60.0f;
+
+	// Measures the worst frame of creating the startup pooled actors, before and after pre-warming: once all in a single
+	// frame (as BeginPlay used to), and once spread over frames by a scheduler with the given budget.
+	// Args: number of actors (default 2000), frame budget in ms (default 2). The benchmark's actors are destroyed afterwards.
+	void RunPoolPrewarmBenchmark(const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr)
+		{
+			return;
+		}
+
+		const int32 NumActors = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : DefaultNumBenchmarkPrewarmActors;
+		const float FrameBudgetMs = Args.Num() > 1 ? FCString::Atof(*Args[1]) : DefaultBenchmarkPrewarmFrameBudgetMs;
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		TArray<AActor*> SpawnedActors;
+		SpawnedActors.Reserve(2 * NumActors);
+		auto MakePrewarmScheduler = [World, NumActors, &SpawnParameters, &SpawnedActors]()
+		{
+			UPoolPrewarmScheduler* PrewarmScheduler = NewObject<UPoolPrewarmScheduler>(World);
+			PrewarmScheduler->AddPrewarmRequest(TEXT("BenchmarkPrewarm"), NumActors, FSimpleDelegate::CreateLambda([World, &SpawnParameters, &SpawnedActors]()
+			{
+				SpawnedActors.Add(World->SpawnActor<AProjectileCircular>(AProjectileCircular::StaticClass(), FTransform::Identity, SpawnParameters));
+			}));
+			return PrewarmScheduler;
+		};
+
+		// Before: every actor created in the BeginPlay frame
+		UPoolPrewarmScheduler* SynchronousScheduler = MakePrewarmScheduler();
+		SynchronousScheduler->Flush();
+
+		// After: created over frames within the budget
+		UPoolPrewarmScheduler* FramedScheduler = MakePrewarmScheduler();
+		FramedScheduler->SetFrameBudgetMs(FrameBudgetMs);
+		while (FramedScheduler->IsPrewarming())
+		{
+			FramedScheduler->Tick(BenchmarkFrameSeconds);
+		}
+
+		UE_LOG(LogSpaceShooterBenchmark, Log, TEXT("Pre-warming %d pooled actors: all in BeginPlay, worst frame %.2f ms. Spread with a %.1f ms budget, worst frame %.2f ms over %d frames%s"),
+			NumActors, SynchronousScheduler->GetWorstFrameMs(), FrameBudgetMs, FramedScheduler->GetWorstFrameMs(), FramedScheduler->GetNumPrewarmFrames(),
+			FramedScheduler->GetWorstFrameMs() > BenchmarkFrameSeconds * 1000.0f ? TEXT(" - OVER 60 FPS FRAME") : TEXT(""));
+
+		// Don't leave the benchmark's actors in the game
+		for (AActor* SpawnedActor : SpawnedActors)
+		{
+			if (SpawnedActor != nullptr)
+			{
+				SpawnedActor->Destroy();
+			}
+		}
+		SynchronousScheduler->MarkAsGarbage();
+		FramedScheduler->MarkAsGarbage();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkPoolPrewarmCommand(
+	TEXT("SpaceShooter.BenchmarkPoolPrewarm"),
+	TEXT("Compares the worst frame of creating pooled actors all in BeginPlay against pre-warming them over frames. Args: number of actors (default 2000), frame budget in ms (default 2)"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunPoolPrewarmBenchmark));
+#endif // !UE_BUILD_SHIPPING
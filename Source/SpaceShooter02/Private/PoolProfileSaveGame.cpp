@@ -0,0 +1,24 @@
+// Copyright 2024 Richard Skala
+
+#include "PoolProfileSaveGame.h"
+
+#include "PoolActorContainer.h"
+
+FString FPoolProfileData::ToString() const
+{
+	return FString::Printf(TEXT("PoolSize: %d, PeakNumActive: %d, NumMisses: %d, NumGrowEvents: %d"), PoolSize, PeakNumActive, NumMisses, NumGrowEvents);
+}
+
+void UPoolProfileSaveGame::RecordPoolProfile(const FPoolActorContainerBase& Pool)
+{
+	if (!ensure(Pool.GetPoolName() != NAME_None))
+	{
+		return;
+	}
+
+	FPoolProfileData& PoolProfile = PoolProfiles.FindOrAdd(Pool.GetPoolName());
+	PoolProfile.PoolSize = Pool.GetNum();
+	PoolProfile.PeakNumActive = Pool.GetPeakNumActive();
+	PoolProfile.NumMisses = Pool.GetNumMisses();
+	PoolProfile.NumGrowEvents = Pool.GetNumGrowEvents();
+}
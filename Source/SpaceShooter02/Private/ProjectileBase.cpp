@@ -2,38 +2,113 @@
 
 #include "ProjectileBase.h"
 
+#include "Components/BoxComponent.h"
 #include "Components/ShapeComponent.h"
-#include "NiagaraFunctionLibrary.h"
+#include "Components/SphereComponent.h"
 #include "NiagaraSystem.h"
 #include "PaperSprite.h"
 #include "PaperSpriteComponent.h"
 
-DEFINE_LOG_CATEGORY_CLASS(AProjectileBase, LogProjectiles)
+#include "ArenaCollisionSubsystem.h"
+#include "ImpactEffectSubsystem.h"
 
-const FVector AProjectileBase::InactivePosition = FVector(9000.0f, 9000.0f, 9000.0f);
+DEFINE_LOG_CATEGORY_CLASS(AProjectileBase, LogProjectiles)
 
 AProjectileBase::AProjectileBase()
 {
 	PrimaryActorTick.bCanEverTick = true;
 }
 
-void AProjectileBase::Tick(float DeltaTime)
+void AProjectileBase::BatchTickProjectiles(TArrayView<APoolActor* const> PoolActors, float DeltaTime)
+{
+	for (APoolActor* PoolActor : PoolActors)
+	{
+		AProjectileBase* Projectile = static_cast<AProjectileBase*>(PoolActor);
+		if (Projectile->bIsPoolObjectActive)
+		{
+			Projectile->UpdateMovement(DeltaTime);
+		}
+	}
+}
+
+void AProjectileBase::ActivatePoolObject()
+{
+	Super::ActivatePoolObject();
+
+	// Don't sweep from where this projectile was last used
+	MovementStartLocation = GetActorLocation();
+	ModifierCounters = FProjectileModifierCounters(RicochetCount, PierceCount);
+}
+
+UPaperSprite* AProjectileBase::GetProjectileSprite() const
+{
+	return ProjectileSpriteComp != nullptr ? ProjectileSpriteComp->GetSprite() : nullptr;
+}
+
+UMaterialInterface* AProjectileBase::GetProjectileSpriteMaterial() const
+{
+	return ProjectileSpriteComp != nullptr ? ProjectileSpriteComp->GetMaterial(0) : nullptr;
+}
+
+FLinearColor AProjectileBase::GetProjectileSpriteColor() const
+{
+	return ProjectileSpriteComp != nullptr ? ProjectileSpriteComp->GetSpriteColor() : FLinearColor::White;
+}
+
+FTransform AProjectileBase::GetProjectileSpriteRelativeTransform() const
+{
+	// The sprite is attached directly to the root
+	return ProjectileSpriteComp != nullptr ? ProjectileSpriteComp->GetRelativeTransform() : FTransform::Identity;
+}
+
+float AProjectileBase::GetCollisionRadius() const
+{
+	if (CollisionShapeComp == nullptr)
+	{
+		return 0.0f;
+	}
+
+	const FVector Scale = CollisionShapeComp->GetRelativeScale3D();
+	if (const UBoxComponent* CollisionBoxComp = Cast<UBoxComponent>(CollisionShapeComp))
+	{
+		const FVector Extent = CollisionBoxComp->GetUnscaledBoxExtent() * Scale;
+		return static_cast<float>(FVector2D(Extent.X, Extent.Z).Size());
+	}
+	if (const USphereComponent* CollisionSphereComp = Cast<USphereComponent>(CollisionShapeComp))
+	{
+		return CollisionSphereComp->GetUnscaledSphereRadius() * static_cast<float>(FMath::Max(Scale.X, Scale.Z));
+	}
+	return 0.0f;
+}
+
+FVector2D AProjectileBase::GetCollisionHalfExtent() const
 {
-	Super::Tick(DeltaTime);
+	if (CollisionShapeComp == nullptr)
+	{
+		return FVector2D::ZeroVector;
+	}
 
-	if (bIsPoolObjectActive)
+	const FVector Scale = CollisionShapeComp->GetRelativeScale3D();
+	if (const UBoxComponent* CollisionBoxComp = Cast<UBoxComponent>(CollisionShapeComp))
 	{
-		UpdateMovement(DeltaTime);
+		const FVector Extent = CollisionBoxComp->GetUnscaledBoxExtent() * Scale;
+		return FVector2D(Extent.X, Extent.Z);
 	}
+	return FVector2D(GetCollisionRadius());
 }
 
 void AProjectileBase::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	ArenaCollision = UWorld::GetSubsystem<UArenaCollisionSubsystem>(GetWorld());
+	ImpactEffects = UWorld::GetSubsystem<UImpactEffectSubsystem>(GetWorld());
+
+	// Enemy hits are found by the combat collision subsystem, so the collision shape only defines the projectile's size
 	if (CollisionShapeComp != nullptr)
 	{
-		CollisionShapeComp->OnComponentBeginOverlap.AddUniqueDynamic(this, &ThisClass::OnCollisionOverlap);
+		CollisionShapeComp->SetGenerateOverlapEvents(false);
+		CollisionShapeComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	}
 }
 
@@ -43,11 +118,6 @@ void AProjectileBase::BeginDestroy()
 	Super::BeginDestroy();
 }
 
-FVector AProjectileBase::GetInactivePoolObjectPosition() const
-{
-	return InactivePosition;
-}
-
 void AProjectileBase::CreateProjectileDefaultSubobjects()
 {
 	// Create the scene root component
@@ -61,9 +131,19 @@ void AProjectileBase::CreateProjectileDefaultSubobjects()
 	CreateSpriteComponent(GetDefaultSpritePath());
 }
 
-void AProjectileBase::OnCollisionOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AProjectileBase::OnEnemyHit(AEnemyBase* Enemy)
+{
+	UE_LOG(LogProjectiles, Log, TEXT("AProjectileBase::OnEnemyHit - %s"), *GetName());
+}
+
+bool AProjectileBase::ConsumeEnemyPierce()
 {
-	UE_LOG(LogProjectiles, Log, TEXT("AProjectileBase::OnCollisionOverlap - %s"), *GetName());
+	if (ModifierCounters.ConsumePierce())
+	{
+		return true;
+	}
+	DeactivatePoolObject();
+	return false;
 }
 
 void AProjectileBase::CreateCollisionVolumeComponent(TSubclassOf<UShapeComponent> CollisionVolumeClass)
@@ -120,6 +200,12 @@ TSubclassOf<UShapeComponent> AProjectileBase::GetCollisionVolumeComponentClass()
 	return UShapeComponent::StaticClass();
 }
 
+EProjectileShape AProjectileBase::GetProjectileShape() const
+{
+	checkf(false, TEXT("AProjectileBase::GetProjectileShape MUST be overidden in a subclass"));
+	return EProjectileShape::Circle;
+}
+
 const TCHAR* AProjectileBase::GetDefaultSpritePath() const
 {
 	checkf(false, TEXT("AProjectileBase::GetDefaultSpritePath MUST be overidden in a subclass"));
@@ -132,6 +218,7 @@ void AProjectileBase::UpdateMovement(float DeltaTime)
 
 	// Get the projectile's current position
 	FVector ProjectilePosition = GetActorLocation();
+	MovementStartLocation = ProjectilePosition;
 
 	// Get the distance to move this frame using the projectiles "up" direction
 	FTransform ProjectileTransform = GetActorTransform();
@@ -142,30 +229,48 @@ void AProjectileBase::UpdateMovement(float DeltaTime)
 	FVector MovementAmount = MovementDirection * MoveSpeed * DeltaTime;
 
 	FVector NewProjectilePosition = ProjectilePosition + MovementAmount;
-	SetActorLocation(NewProjectilePosition);
 
-	// Line trace to check collision with static objects to destroy this projectile
-	if (UWorld* World = GetWorld())
+	// Ricochet off every wall this frame's movement runs into, while there are bounces left
+	UArenaCollisionSubsystem* ArenaCollisionSubsystem = ArenaCollision.Get();
+	FVector BounceSegmentStart = ProjectilePosition;
+	FArenaHit BounceHit;
+	while (ArenaCollisionSubsystem != nullptr && ModifierCounters.RemainingBounces > 0
+		&& ArenaCollisionSubsystem->SegmentVsArena(BounceSegmentStart, NewProjectilePosition, BounceHit))
 	{
-		// Use the projectiles's position as the line trace start position
-		const FVector& TraceStartPos = GetActorLocation();
+		ModifierCounters.ConsumeBounce();
 
-		// Check agains all static objects (TODO: Use custom collision object type, e.g. Walls)
-		FCollisionObjectQueryParams ObjectQueryParams(FCollisionObjectQueryParams::InitType::AllStaticObjects);
+		const float RemainingDistance = (1.0f - BounceHit.Time) * static_cast<float>(FVector::Dist(BounceSegmentStart, NewProjectilePosition));
+		FQuat ProjectileRotation = GetActorQuat();
+		NewProjectilePosition = FProjectileRicochet::Bounce(BounceHit.ImpactPoint, BounceHit.ImpactNormal, RemainingDistance, MovementDirection, ProjectileRotation);
+		BounceSegmentStart = BounceHit.ImpactPoint + BounceHit.ImpactNormal * FProjectileRicochet::WallSeparation;
+		SetActorRotation(ProjectileRotation);
 
-		// Distance of the LineTrace. Adjust with the movement speed and deltatime
-		static const float CollisionLineTraceOffset = 2.0f;
-		float CollisionDistance = MoveSpeed * DeltaTime * CollisionLineTraceOffset;
+		if (UImpactEffectSubsystem* ImpactEffectSubsystem = ImpactEffects.Get())
+		{
+			const FRotator ImpactEffectRotation = FRotationMatrix::MakeFromZ(BounceHit.ImpactNormal).Rotator();
+			ImpactEffectSubsystem->SpawnImpactEffect(ProjectileImpactEffect, BounceHit.ImpactPoint, ImpactEffectRotation);
+		}
+	}
+
+	SetActorLocation(NewProjectilePosition);
+
+	// Check collision with the level borders to destroy this projectile once it has no bounces left
+	if (ArenaCollisionSubsystem != nullptr && ModifierCounters.RemainingBounces == 0)
+	{
+		// Distance to check ahead of the projectile. Adjust with the movement speed and deltatime
+		static const float CollisionCheckDistanceMultiplier = 2.0f;
+		const float CollisionDistance = MoveSpeed * DeltaTime * CollisionCheckDistanceMultiplier;
 
 		// Check collision against walls in its movement direction
-		TArray<FHitResult> HitResult;
-		const FVector& TraceEndPosXDir = TraceStartPos + FVector(MovementDirection.X, 0.0f, 0.0f).GetSafeNormal() * CollisionDistance;
-		if (World->LineTraceMultiByObjectType(HitResult, TraceStartPos, TraceEndPosXDir, ObjectQueryParams))
+		FArenaHit ArenaHit;
+		if (ArenaCollisionSubsystem->SegmentVsArena(NewProjectilePosition, NewProjectilePosition + MovementDirection * CollisionDistance, ArenaHit))
 		{
-			FVector ImpactEffectSpawnPos = HitResult.Num() > 0 ? HitResult[0].ImpactPoint : TraceStartPos;
-
-			// Successful line trace into walls. Spawn a particle at the position and destroy this particle.
-			UNiagaraFunctionLibrary::SpawnSystemAtLocation(World, ProjectileImpactEffect, ImpactEffectSpawnPos);
+			// Hit a wall. Spawn a particle facing away from the wall at the impact position and deactivate this projectile.
+			if (UImpactEffectSubsystem* ImpactEffectSubsystem = ImpactEffects.Get())
+			{
+				const FRotator ImpactEffectRotation = FRotationMatrix::MakeFromZ(ArenaHit.ImpactNormal).Rotator();
+				ImpactEffectSubsystem->SpawnImpactEffect(ProjectileImpactEffect, ArenaHit.ImpactPoint, ImpactEffectRotation);
+			}
 			DeactivatePoolObject();
 		}
 	}
@@ -34,13 +34,7 @@ const TCHAR* AProjectileCircular::GetDefaultSpritePath() const
 	return ProjectileCircular::DefaultProjectileSpritePath;
 }
 
-void AProjectileCircular::OnCollisionOverlap(
-	UPrimitiveComponent* OverlappedComponent,
-	AActor* OtherActor,
-	UPrimitiveComponent* OtherComp,
-	int32 OtherBodyIndex,
-	bool bFromSweep,
-	const FHitResult& SweepResult)
+void AProjectileCircular::OnEnemyHit(AEnemyBase* Enemy)
 {
-	UE_LOG(LogProjectiles, Log, TEXT("AProjectileCircular::OnCollisionOverlap - %s"), *GetName());
+	UE_LOG(LogProjectiles, Log, TEXT("AProjectileCircular::OnEnemyHit - %s"), *GetName());
 }
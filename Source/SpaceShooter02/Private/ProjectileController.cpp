@@ -2,81 +2,145 @@
 
 #include "ProjectileController.h"
 
+#include "ImpactEffectSubsystem.h"
 #include "ProjectileBase.h"
-
-DEFINE_LOG_CATEGORY_STATIC(LogProjectileController, Log, All)
+#include "ProjectileManager.h"
+#include "SpaceShooterPoolSubsystem.h"
 
 void UProjectileController::InitProjectilePool()
 {
-	for (int i = 0; i < MAX_PROJECTILES; ++i)
+	// Allocate the impact effect components up front, rather than on the first wall hit
+	UImpactEffectSubsystem* ImpactEffectSubsystem = UWorld::GetSubsystem<UImpactEffectSubsystem>(GetWorld());
+	if (ImpactEffectSubsystem != nullptr)
+	{
+		for (TSubclassOf<AProjectileBase> Class : { ProjectileClass, HomingProjectileClass })
+		{
+			if (Class != nullptr)
+			{
+				ImpactEffectSubsystem->CreateImpactEffectPool(Class->GetDefaultObject<AProjectileBase>()->GetProjectileImpactEffect());
+			}
+		}
+	}
+
+	// Homing projectiles steer individually, so they are always pooled actors
+	USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld());
+	if (PoolSubsystem != nullptr && HomingProjectileClass != nullptr)
+	{
+		PoolSubsystem->CreatePool(HomingProjectileClass, MAX_HOMING_PROJECTILES, GrowthSettings);
+	}
+
+	if (bUseProjectileManager)
+	{
+		UWorld* World = GetWorld();
+		if (World != nullptr && ensure(ProjectileClass != nullptr))
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			ProjectileManager = World->SpawnActor<AProjectileManager>(AProjectileManager::StaticClass(), FTransform::Identity, SpawnParameters);
+			if (ensure(ProjectileManager != nullptr))
+			{
+				ProjectileManager->InitProjectileManager(ProjectileClass, MAX_PROJECTILES);
+			}
+		}
+		return;
+	}
+
+	if (PoolSubsystem != nullptr && ensure(ProjectileClass != nullptr))
 	{
-		CreateAndAddNewProjectile();
+		PoolSubsystem->CreatePool(ProjectileClass, MAX_PROJECTILES, GrowthSettings);
 	}
 }
 
 void UProjectileController::ResetProjectilePool()
 {
-	// Iterate through the entire projectile pool and deactivate each
-	for (AProjectileBase* const Projectile : ProjectilePool)
+	if (ProjectileManager != nullptr)
 	{
-		if (Projectile != nullptr)
+		ProjectileManager->ResetProjectiles();
+	}
+
+	if (USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld()))
+	{
+		PoolSubsystem->ResetPool(ProjectileClass);
+		if (HomingProjectileClass != nullptr)
 		{
-			Projectile->DeactivatePoolObject();
+			PoolSubsystem->ResetPool(HomingProjectileClass);
 		}
 	}
 }
 
-AProjectileBase* UProjectileController::GetInactiveProjectile()
+AProjectileBase* UProjectileController::GetInactiveProjectile(TSubclassOf<AProjectileBase> Class)
 {
-	// Get first inactive projectile
 	AProjectileBase* InactiveProjectile = nullptr;
-	for (AProjectileBase* Projectile : ProjectilePool)
+	if (USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld()))
 	{
-		if (Projectile != nullptr && !Projectile->IsPoolObjectActive())
-		{
-			// Found an inactive projectile
-			InactiveProjectile = Projectile;
-			break;
-		}
+		InactiveProjectile = PoolSubsystem->AcquirePoolActor(Class);
 	}
+	return InactiveProjectile;
+}
 
-	// FindByPredicate returns a pointer which is making it super annoying to assign so just use a normal for-loop as above
-	/*TObjectPtr<AProjectileBase>* InactiveProjectile = ProjectilePool.FindByPredicate([](TObjectPtr<AProjectileBase> Projectile)
+int32 UProjectileController::FireVolley(TConstArrayView<FTransform> FireTransforms, APawn* InInstigator)
+{
+	if (ProjectileManager != nullptr)
 	{
-		return Projectile != nullptr && !Projectile->IsProjectileActive();
-	});*/
+		ProjectileManager->FireVolley(FireTransforms, InInstigator);
+		return FireTransforms.Num();
+	}
+	return FirePooledVolley(ProjectileClass, FireTransforms, InInstigator);
+}
 
-	if (InactiveProjectile == nullptr)
+int32 UProjectileController::FireHomingVolley(TConstArrayView<FTransform> FireTransforms, APawn* InInstigator)
+{
+	if (HomingProjectileClass == nullptr)
 	{
-		UE_LOG(LogProjectileController, Warning, TEXT("No available projectiles in the pool. Increase the pool size."));
-		InactiveProjectile = CreateAndAddNewProjectile();
+		return FireVolley(FireTransforms, InInstigator);
 	}
-	return InactiveProjectile;
+	return FirePooledVolley(HomingProjectileClass, FireTransforms, InInstigator);
 }
 
-AProjectileBase* UProjectileController::CreateAndAddNewProjectile()
+bool UProjectileController::FirePooledProjectile(TSubclassOf<AProjectileBase> Class, const FVector& Position, const FRotator& Rotation, APawn* InInstigator)
 {
-	AProjectileBase* NewProjectile = nullptr;
-	if (ensure(ProjectileClass != nullptr))
+	AProjectileBase* Projectile = GetInactiveProjectile(Class);
+	if (Projectile != nullptr)
 	{
-		FActorSpawnParameters ProjectileSpawnParameters;
-		ProjectileSpawnParameters.Name = TEXT("Projectile");
-		//ProjectileSpawnParameters.Instigator = this;
-		ProjectileSpawnParameters.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
-		ProjectileSpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		Projectile->SetInstigator(InInstigator);
+		Projectile->SetActorLocationAndRotation(Position, Rotation);
+		Projectile->ActivatePoolObject();
+		return true;
+	}
+	return false;
+}
+
+int32 UProjectileController::FirePooledVolley(TSubclassOf<AProjectileBase> Class, TConstArrayView<FTransform> FireTransforms, APawn* InInstigator)
+{
+	USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld());
+	if (PoolSubsystem == nullptr)
+	{
+		return 0;
+	}
 
-		if (UWorld* World = GetWorld())
+	// Reserve the whole volley from the pool at once
+	VolleyProjectiles.Reset();
+	const int32 NumReserved = PoolSubsystem->AcquirePoolActors(Class, FireTransforms.Num(), VolleyProjectiles);
+
+	// Write the initial state of every projectile, then activate them together
+	for (int32 i = 0; i < NumReserved; ++i)
+	{
+		VolleyProjectiles[i]->SetInstigator(InInstigator);
+		VolleyProjectiles[i]->SetActorLocationAndRotation(FireTransforms[i].GetLocation(), FireTransforms[i].GetRotation());
+	}
+	for (APoolActor* Projectile : VolleyProjectiles)
+	{
+		Projectile->ActivatePoolObject();
+	}
+
+	// The pool ran out of free projectiles. Fire the rest one at a time, so the pool can grow.
+	int32 NumFired = NumReserved;
+	for (int32 i = NumReserved; i < FireTransforms.Num(); ++i)
+	{
+		if (FirePooledProjectile(Class, FireTransforms[i].GetLocation(), FireTransforms[i].Rotator(), InInstigator))
 		{
-			NewProjectile = World->SpawnActor<AProjectileBase>(ProjectileClass, FVector::ZeroVector, FRotator::ZeroRotator, ProjectileSpawnParameters);
-			if (NewProjectile != nullptr)
-			{
-				ProjectilePool.Add(NewProjectile);
-			}
-			else
-			{
-				UE_LOG(LogProjectileController, Warning, TEXT("Failed to create projectile."));
-			}
+			++NumFired;
 		}
 	}
-	return NewProjectile;
+	return NumFired;
 }
@@ -0,0 +1,229 @@
+// Copyright 2024 Richard Skala
+
+#include "ProjectileHoming.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+#include "CombatCollisionSubsystem.h"
+#include "EnemyBase.h"
+#include "SpaceShooter02.h"
+#include "SpaceShooterBenchmark.h"
+#include "UniformGrid2D.h"
+
+DECLARE_CYCLE_STAT(TEXT("Homing Projectiles"), STAT_HomingProjectiles, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Homing Retarget"), STAT_HomingRetarget, STATGROUP_SpaceShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Homing Projectiles"), STAT_NumHomingProjectiles, STATGROUP_SpaceShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Homing Retargets"), STAT_NumHomingRetargets, STATGROUP_SpaceShooter);
+
+namespace ProjectileHoming
+{
+	// How long a projectile that found no target waits before searching again
+	static constexpr float RetargetIntervalSeconds = 0.1f;
+}
+
+AProjectileHoming::AProjectileHoming()
+{
+	// Spent on the first enemy hit by default
+	PierceCount = 0;
+}
+
+void AProjectileHoming::BeginPlay()
+{
+	Super::BeginPlay();
+	CombatCollision = UWorld::GetSubsystem<UCombatCollisionSubsystem>(GetWorld());
+}
+
+void AProjectileHoming::ActivatePoolObject()
+{
+	Super::ActivatePoolObject();
+
+	// Don't chase the target from the last time this projectile was used
+	SetHomingTarget(nullptr);
+	RetargetDelaySeconds = 0.0f;
+}
+
+void AProjectileHoming::OnEnemyHit(AEnemyBase* Enemy)
+{
+	// Ignore this hit if the enemy is the Instigator (i.e. the Actor that "fired" this projectile)
+	if (Enemy == nullptr || Enemy == GetInstigator())
+	{
+		return;
+	}
+
+	// If this projectile pierces the enemy, it searches for a new target on its next update
+	Enemy->DamageEnemy();
+	ConsumeEnemyPierce();
+}
+
+void AProjectileHoming::BatchTickHomingProjectiles(TArrayView<APoolActor* const> PoolActors, float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HomingProjectiles);
+
+	// Every projectile of the pool is the same class in the same world, so they share a search radius and a subsystem
+	const AProjectileHoming* FirstProjectile = PoolActors.Num() > 0 ? static_cast<AProjectileHoming*>(PoolActors[0]) : nullptr;
+	UCombatCollisionSubsystem* CombatCollisionSubsystem = FirstProjectile != nullptr ? FirstProjectile->CombatCollision.Get() : nullptr;
+	if (CombatCollisionSubsystem != nullptr)
+	{
+		CombatCollisionSubsystem->ResetNearestEnemyQueries();
+	}
+
+	// Queue a target search for every projectile whose target was destroyed (or that has none yet)
+	int32 NumActiveProjectiles = 0;
+	for (APoolActor* PoolActor : PoolActors)
+	{
+		AProjectileHoming* Projectile = static_cast<AProjectileHoming*>(PoolActor);
+		Projectile->RetargetQueryIndex = INDEX_NONE;
+		if (!Projectile->bIsPoolObjectActive || Projectile->HasValidHomingTarget())
+		{
+			NumActiveProjectiles += Projectile->bIsPoolObjectActive ? 1 : 0;
+			continue;
+		}
+
+		++NumActiveProjectiles;
+		Projectile->RetargetDelaySeconds -= DeltaTime;
+		if (Projectile->RetargetDelaySeconds <= 0.0f && CombatCollisionSubsystem != nullptr)
+		{
+			Projectile->RetargetQueryIndex = CombatCollisionSubsystem->AddNearestEnemyQuery(Projectile->GetActorLocation());
+		}
+	}
+
+	// Search for every new target in one parallel batch
+	const int32 NumRetargets = CombatCollisionSubsystem != nullptr ? CombatCollisionSubsystem->GetNumNearestEnemyQueries() : 0;
+	if (NumRetargets > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_HomingRetarget);
+		CombatCollisionSubsystem->RunNearestEnemyQueries(FirstProjectile->HomingSearchRadius);
+	}
+
+	for (APoolActor* PoolActor : PoolActors)
+	{
+		AProjectileHoming* Projectile = static_cast<AProjectileHoming*>(PoolActor);
+		if (Projectile->RetargetQueryIndex != INDEX_NONE)
+		{
+			AEnemyBase* NewTarget = CombatCollisionSubsystem->GetNearestEnemyQueryResult(Projectile->RetargetQueryIndex);
+			Projectile->SetHomingTarget(NewTarget);
+			Projectile->RetargetDelaySeconds = NewTarget != nullptr ? 0.0f : ProjectileHoming::RetargetIntervalSeconds;
+			Projectile->RetargetQueryIndex = INDEX_NONE;
+		}
+
+		if (Projectile->bIsPoolObjectActive)
+		{
+			Projectile->SteerTowardsHomingTarget(DeltaTime);
+			Projectile->UpdateMovement(DeltaTime);
+		}
+	}
+
+	// Don't keep pointers to enemies past this tick
+	if (CombatCollisionSubsystem != nullptr)
+	{
+		CombatCollisionSubsystem->ResetNearestEnemyQueries();
+	}
+
+	INC_DWORD_STAT_BY(STAT_NumHomingProjectiles, NumActiveProjectiles);
+	INC_DWORD_STAT_BY(STAT_NumHomingRetargets, NumRetargets);
+}
+
+bool AProjectileHoming::HasValidHomingTarget() const
+{
+	return HomingTarget != nullptr && HomingTarget->IsPoolObjectActive() && HomingTarget->GetPoolActivationSerial() == HomingTargetSerial;
+}
+
+void AProjectileHoming::SetHomingTarget(AEnemyBase* Enemy)
+{
+	HomingTarget = Enemy;
+	HomingTargetSerial = Enemy != nullptr ? Enemy->GetPoolActivationSerial() : 0;
+}
+
+void AProjectileHoming::SteerTowardsHomingTarget(float DeltaTime)
+{
+	if (!HasValidHomingTarget())
+	{
+		return;
+	}
+
+	// Work on the XZ plane, where the game is played. The projectile moves along its "up" direction.
+	const FVector ToTarget = HomingTarget->GetActorLocation() - GetActorLocation();
+	const FVector2D DesiredDirection = FVector2D(ToTarget.X, ToTarget.Z).GetSafeNormal();
+	if (DesiredDirection.IsZero())
+	{
+		return;
+	}
+
+	const FVector ProjectileUp = GetActorUpVector();
+	const FVector2D CurrentDirection(ProjectileUp.X, ProjectileUp.Z);
+
+	// Signed angle from the current direction to the desired one, positive when turning from +Z towards +X
+	const float AngleToTarget = static_cast<float>(FMath::Atan2(
+		CurrentDirection.Y * DesiredDirection.X - CurrentDirection.X * DesiredDirection.Y,
+		CurrentDirection.X * DesiredDirection.X + CurrentDirection.Y * DesiredDirection.Y));
+
+	const float MaxTurnAngle = FMath::DegreesToRadians(TurnRateDegreesPerSecond) * DeltaTime;
+	const float TurnAngle = FMath::Clamp(AngleToTarget, -MaxTurnAngle, MaxTurnAngle);
+
+	// Rotate about the world Y axis (the axis facing the camera), so the projectile stays on the plane
+	SetActorRotation(FQuat(FVector::YAxisVector, TurnAngle) * GetActorQuat());
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	static constexpr int32 NumBenchmarkEnemies = 256;
+	static constexpr float BenchmarkSearchRadius = 2000.0f;
+
+	// Times the nearest enemy search of homing projectiles that all need a new target on the same frame (the worst case),
+	// against random enemies in a grid sized like the arena
+	void RunHomingBenchmark()
+	{
+		FSpaceShooterBenchmark Benchmark;
+
+		TArray<FVector2D> EnemyPositions;
+		TArray<float> EnemyRadii;
+		for (int32 i = 0; i < NumBenchmarkEnemies; ++i)
+		{
+			EnemyPositions.Add(Benchmark.RandomPosition());
+			EnemyRadii.Add(50.0f);
+		}
+
+		FUniformGrid2D EnemyGrid;
+		EnemyGrid.Init(FSpaceShooterBenchmark::GetArenaBounds(), 200.0f);
+		EnemyGrid.Build(EnemyPositions, EnemyRadii);
+
+		for (const int32 NumProjectiles : { 500, 2000, 10000 })
+		{
+			TArray<FVector2D> ProjectilePositions;
+			for (int32 i = 0; i < NumProjectiles; ++i)
+			{
+				ProjectilePositions.Add(Benchmark.RandomPosition());
+			}
+
+			TArray<int32> Targets;
+			Targets.SetNumUninitialized(NumProjectiles);
+			auto FindTarget = [&EnemyGrid, &ProjectilePositions, &Targets](int32 Index)
+			{
+				Targets[Index] = EnemyGrid.FindNearest(ProjectilePositions[Index], BenchmarkSearchRadius, [](int32) { return true; });
+			};
+
+			const double SerialMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([&FindTarget, NumProjectiles]()
+			{
+				for (int32 i = 0; i < NumProjectiles; ++i)
+				{
+					FindTarget(i);
+				}
+			});
+			const double ParallelMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([&FindTarget, NumProjectiles]()
+			{
+				ParallelFor(TEXT("BenchmarkHoming"), NumProjectiles, 64, FindTarget);
+			});
+
+			UE_LOG(LogSpaceShooterBenchmark, Log, TEXT("%d homing projectiles vs %d enemies: retarget %.3f ms serial, %.3f ms parallel (%.1f ns per projectile)"),
+				NumProjectiles, NumBenchmarkEnemies, SerialMilliseconds, ParallelMilliseconds, ParallelMilliseconds * 1.0e6 / NumProjectiles);
+		}
+	}
+}
+
+static FAutoConsoleCommand BenchmarkHomingCommand(
+	TEXT("SpaceShooter.BenchmarkHoming"),
+	TEXT("Times the nearest enemy search for 500, 2000 and 10000 homing projectiles retargeting on the same frame"),
+	FConsoleCommandDelegate::CreateStatic(&RunHomingBenchmark));
+#endif // !UE_BUILD_SHIPPING
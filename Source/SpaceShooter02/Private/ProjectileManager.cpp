@@ -0,0 +1,406 @@
+// Copyright 2024 Richard Skala
+
+#include "ProjectileManager.h"
+
+#include "HAL/IConsoleManager.h"
+#include "NiagaraSystem.h"
+#include "PaperGroupedSpriteComponent.h"
+#include "PaperSprite.h"
+
+#include "ArenaCollisionSubsystem.h"
+#include "CombatCollisionSubsystem.h"
+#include "EnemyBase.h"
+#include "ImpactEffectSubsystem.h"
+#include "ProjectileBase.h"
+#include "ProjectileCircular.h"
+#include "SpaceShooter02.h"
+#include "SpaceShooterBenchmark.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Simulation"), STAT_ProjectileSimulation, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Projectile Sprite Update"), STAT_ProjectileSpriteUpdate, STATGROUP_SpaceShooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Simulated Projectiles"), STAT_NumSimulatedProjectiles, STATGROUP_SpaceShooter);
+
+DEFINE_LOG_CATEGORY_CLASS(AProjectileManager, LogProjectileManager)
+
+namespace
+{
+	// Lifetime used for projectile classes without a finite lifetime. Projectiles leave the arena long before this.
+	static constexpr float DefaultProjectileLifeTimeSeconds = 30.0f;
+}
+
+void AProjectileManager::FProjectileArrays::Reserve(int32 Number)
+{
+	Positions.Reserve(Number);
+	PreviousPositions.Reserve(Number);
+	Directions.Reserve(Number);
+	Rotations.Reserve(Number);
+	Speeds.Reserve(Number);
+	RemainingLifetimes.Reserve(Number);
+	ModifierCounters.Reserve(Number);
+	Owners.Reserve(Number);
+}
+
+void AProjectileManager::FProjectileArrays::Add(const FVector& Position, const FVector& Direction, const FQuat& Rotation, float Speed, float Lifetime, FProjectileModifierCounters Counters, AActor* Owner)
+{
+	Positions.Add(Position);
+	PreviousPositions.Add(Position);
+	Directions.Add(Direction);
+	Rotations.Add(Rotation);
+	Speeds.Add(Speed);
+	RemainingLifetimes.Add(Lifetime);
+	ModifierCounters.Add(Counters);
+	Owners.Add(Owner);
+}
+
+void AProjectileManager::FProjectileArrays::RemoveAtSwap(int32 Index)
+{
+	Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PreviousPositions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Directions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Rotations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Speeds.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RemainingLifetimes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	ModifierCounters.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Owners.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void AProjectileManager::FProjectileArrays::Reset()
+{
+	Positions.Reset();
+	PreviousPositions.Reset();
+	Directions.Reset();
+	Rotations.Reset();
+	Speeds.Reset();
+	RemainingLifetimes.Reset();
+	ModifierCounters.Reset();
+	Owners.Reset();
+}
+
+AProjectileManager::AProjectileManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	GroupedSpriteComp = CreateDefaultSubobject<UPaperGroupedSpriteComponent>(TEXT("GroupedSpriteComp"));
+	SetRootComponent(GroupedSpriteComp);
+	GroupedSpriteComp->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	GroupedSpriteComp->SetMobility(EComponentMobility::Movable);
+}
+
+void AProjectileManager::BeginPlay()
+{
+	Super::BeginPlay();
+	ArenaCollision = UWorld::GetSubsystem<UArenaCollisionSubsystem>(GetWorld());
+	ImpactEffects = UWorld::GetSubsystem<UImpactEffectSubsystem>(GetWorld());
+
+	if (UCombatCollisionSubsystem* CombatCollisionSubsystem = UWorld::GetSubsystem<UCombatCollisionSubsystem>(GetWorld()))
+	{
+		CombatCollisionSubsystem->RegisterProjectileManager(this);
+	}
+}
+
+void AProjectileManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UCombatCollisionSubsystem* CombatCollisionSubsystem = UWorld::GetSubsystem<UCombatCollisionSubsystem>(GetWorld()))
+	{
+		CombatCollisionSubsystem->UnregisterProjectileManager(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AProjectileManager::InitProjectileManager(TSubclassOf<AProjectileBase> InProjectileClass, int32 InitialCapacity, EProjectileManagerTarget InTarget)
+{
+	if (!ensure(InProjectileClass != nullptr))
+	{
+		return;
+	}
+
+	ProjectileClass = InProjectileClass;
+	Target = InTarget;
+
+	const AProjectileBase* ProjectileCDO = ProjectileClass->GetDefaultObject<AProjectileBase>();
+	ProjectileSprite = ProjectileCDO->GetProjectileSprite();
+	ProjectileImpactEffect = ProjectileCDO->GetProjectileImpactEffect();
+	SpriteRelativeTransform = ProjectileCDO->GetProjectileSpriteRelativeTransform();
+	SpriteColor = ProjectileCDO->GetProjectileSpriteColor();
+	MoveSpeed = ProjectileCDO->GetMoveSpeed();
+	CollisionRadius = ProjectileCDO->GetCollisionRadius();
+	CollisionHalfExtent = ProjectileCDO->GetCollisionHalfExtent();
+	ProjectileShape = ProjectileCDO->GetProjectileShape();
+	LifeTimeSeconds = ProjectileCDO->HasFiniteLifetime() ? ProjectileCDO->GetLifeTimeSeconds() : DefaultProjectileLifeTimeSeconds;
+	InitialModifierCounters = FProjectileModifierCounters(ProjectileCDO->GetRicochetCount(), ProjectileCDO->GetPierceCount());
+
+	Projectiles.Reserve(InitialCapacity);
+
+	// Keep the same material as the projectile actors (e.g. for color shifting)
+	if (UMaterialInterface* SpriteMaterial = ProjectileCDO->GetProjectileSpriteMaterial())
+	{
+		GroupedSpriteComp->SetMaterial(0, SpriteMaterial);
+	}
+
+	UE_LOG(LogProjectileManager, Log, TEXT("Simulating %s projectiles - Speed: %f, Radius: %f, Lifetime: %f, Ricochets: %d, Pierces: %d"),
+		*ProjectileClass->GetName(), MoveSpeed, CollisionRadius, LifeTimeSeconds, ProjectileCDO->GetRicochetCount(), ProjectileCDO->GetPierceCount());
+}
+
+void AProjectileManager::FireProjectile(const FVector& Position, const FVector& Direction, float Speed, AActor* InOwner)
+{
+	// Turn about the world Y axis (the axis facing the camera) from "up" to the direction
+	const FQuat RotationQuat(FVector::YAxisVector, FMath::Atan2(Direction.X, Direction.Z));
+	Projectiles.Add(Position, Direction, RotationQuat, Speed, LifeTimeSeconds, InitialModifierCounters, InOwner);
+}
+
+void AProjectileManager::FireVolley(TConstArrayView<FTransform> FireTransforms, AActor* InOwner)
+{
+	Projectiles.Reserve(Projectiles.Num() + FireTransforms.Num());
+	for (const FTransform& FireTransform : FireTransforms)
+	{
+		// Projectiles move along their "up" direction, like AProjectileBase
+		const FQuat RotationQuat = FireTransform.GetRotation();
+		Projectiles.Add(FireTransform.GetLocation(), RotationQuat.GetUpVector(), RotationQuat, MoveSpeed, LifeTimeSeconds, InitialModifierCounters, InOwner);
+	}
+}
+
+void AProjectileManager::OnProjectileHitEnemy(int32 ProjectileIndex, AEnemyBase* Enemy)
+{
+	// Projectiles spent on an earlier hit this frame hit nothing else
+	if (Projectiles.RemainingLifetimes[ProjectileIndex] <= 0.0f)
+	{
+		return;
+	}
+
+	Enemy->DamageEnemy();
+	if (!Projectiles.ModifierCounters[ProjectileIndex].ConsumePierce())
+	{
+		// Removed on the next update
+		Projectiles.RemainingLifetimes[ProjectileIndex] = 0.0f;
+	}
+}
+
+void AProjectileManager::ResetProjectiles()
+{
+	Projectiles.Reset();
+	UpdateSpriteInstances();
+}
+
+void AProjectileManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ProjectileSimulation);
+		UpdateMovement(DeltaTime);
+		UpdateArenaCollision();
+		RemoveExpiredProjectiles();
+	}
+
+	UpdateSpriteInstances();
+
+	// Enemy bullets are simulated by managers of their own, so add up every manager
+	const int32 NumProjectiles = Projectiles.Num();
+	INC_DWORD_STAT_BY(STAT_NumSimulatedProjectiles, NumProjectiles);
+}
+
+void AProjectileManager::UpdateMovement(float DeltaTime)
+{
+	Projectiles.PreviousPositions.Reset();
+	Projectiles.PreviousPositions.Append(Projectiles.Positions);
+
+	const int32 NumProjectiles = Projectiles.Num();
+	FVector* Positions = Projectiles.Positions.GetData();
+	const FVector* Directions = Projectiles.Directions.GetData();
+	const float* Speeds = Projectiles.Speeds.GetData();
+	float* RemainingLifetimes = Projectiles.RemainingLifetimes.GetData();
+
+	for (int32 i = 0; i < NumProjectiles; ++i)
+	{
+		Positions[i] += Directions[i] * (Speeds[i] * DeltaTime);
+		RemainingLifetimes[i] -= DeltaTime;
+	}
+}
+
+void AProjectileManager::UpdateArenaCollision()
+{
+	UArenaCollisionSubsystem* ArenaCollisionSubsystem = ArenaCollision.Get();
+	if (ArenaCollisionSubsystem == nullptr)
+	{
+		return;
+	}
+
+	// Test this frame's movement of every projectile against the level borders
+	ArenaHits.Reset();
+	ArenaCollisionSubsystem->SegmentsVsArena(Projectiles.PreviousPositions, Projectiles.Positions, ArenaHits);
+
+	UImpactEffectSubsystem* ImpactEffectSubsystem = ImpactEffects.Get();
+	for (const FArenaHit& ArenaHit : ArenaHits)
+	{
+		// Play the impact effect facing away from the wall
+		if (ProjectileImpactEffect != nullptr && ImpactEffectSubsystem != nullptr)
+		{
+			const FRotator ImpactEffectRotation = FRotationMatrix::MakeFromZ(ArenaHit.ImpactNormal).Rotator();
+			ImpactEffectSubsystem->SpawnImpactEffect(ProjectileImpactEffect, ArenaHit.ImpactPoint, ImpactEffectRotation);
+		}
+
+		const int32 ProjectileIndex = ArenaHit.SegmentIndex;
+		if (Projectiles.ModifierCounters[ProjectileIndex].ConsumeBounce())
+		{
+			// Ricochet, and travel the rest of this frame's movement along the reflected direction. A second wall in the
+			// way (e.g. in a corner) is not bounced off until the next frame, or removes the projectile if it ends up outside.
+			const FVector& PreviousPosition = Projectiles.PreviousPositions[ProjectileIndex];
+			FVector& Position = Projectiles.Positions[ProjectileIndex];
+			const float RemainingDistance = (1.0f - ArenaHit.Time) * static_cast<float>(FVector::Dist(PreviousPosition, Position));
+			Position = FProjectileRicochet::Bounce(ArenaHit.ImpactPoint, ArenaHit.ImpactNormal, RemainingDistance,
+				Projectiles.Directions[ProjectileIndex], Projectiles.Rotations[ProjectileIndex]);
+			continue;
+		}
+		Projectiles.RemainingLifetimes[ProjectileIndex] = 0.0f;
+	}
+
+	// Projectiles fired from outside the arena (or that slipped past a border) are removed without an effect
+	OutsideArenaIndices.Reset();
+	ArenaCollisionSubsystem->PointsOutsideArena(Projectiles.Positions, OutsideArenaIndices);
+	for (const int32 ProjectileIndex : OutsideArenaIndices)
+	{
+		Projectiles.RemainingLifetimes[ProjectileIndex] = 0.0f;
+	}
+}
+
+void AProjectileManager::RemoveExpiredProjectiles()
+{
+	// Iterate backwards so swapped-in projectiles have already been checked
+	for (int32 i = Projectiles.Num() - 1; i >= 0; --i)
+	{
+		if (Projectiles.RemainingLifetimes[i] <= 0.0f)
+		{
+			Projectiles.RemoveAtSwap(i);
+		}
+	}
+}
+
+void AProjectileManager::UpdateSpriteInstances()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileSpriteUpdate);
+
+	if (GroupedSpriteComp == nullptr || ProjectileSprite == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumProjectiles = Projectiles.Num();
+	if (NumProjectiles == 0 && NumVisibleSpriteInstances == 0)
+	{
+		return;
+	}
+
+	// Add instances as the projectile count grows. Instances are never removed, only collapsed when unused.
+	const int32 NumInstances = GroupedSpriteComp->GetInstanceCount();
+	for (int32 i = NumInstances; i < NumProjectiles; ++i)
+	{
+		GroupedSpriteComp->AddInstance(FTransform::Identity, ProjectileSprite, true, SpriteColor);
+	}
+
+	for (int32 i = 0; i < NumProjectiles; ++i)
+	{
+		const FTransform ProjectileTransform(Projectiles.Rotations[i], Projectiles.Positions[i]);
+		GroupedSpriteComp->UpdateInstanceTransform(i, SpriteRelativeTransform * ProjectileTransform, true, false, true);
+	}
+
+	// Collapse the instances of projectiles removed since the last update
+	const FTransform CollapsedTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+	for (int32 i = NumProjectiles; i < NumVisibleSpriteInstances; ++i)
+	{
+		GroupedSpriteComp->UpdateInstanceTransform(i, CollapsedTransform, true, false, true);
+	}
+	NumVisibleSpriteInstances = NumProjectiles;
+
+	// Send every instance to the renderer at once
+	GroupedSpriteComp->MarkRenderStateDirty();
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	static constexpr int32 NumBenchmarkFrames = 120;
+	static constexpr float BenchmarkFrameSeconds = 1.0f / 60.0f;
+
+	// Times the per-frame update (movement, arena collision and sprite update) of a projectile manager holding the given
+	// numbers of projectiles (default 1000, 10000 and 20000), in the world's arena. Projectiles that expire are replaced
+	// between frames, so every frame updates the full count. The manager is destroyed once the benchmark ends.
+	void RunProjectileManagerBenchmark(const TArray<FString>& Args, UWorld* World)
+	{
+		UArenaCollisionSubsystem* ArenaCollisionSubsystem = UWorld::GetSubsystem<UArenaCollisionSubsystem>(World);
+		if (World == nullptr || ArenaCollisionSubsystem == nullptr || !ArenaCollisionSubsystem->GetArenaBounds().IsValid)
+		{
+			UE_LOG(LogSpaceShooterBenchmark, Warning, TEXT("SpaceShooter.BenchmarkProjectileManager - No arena to fire into"));
+			return;
+		}
+
+		TArray<int32> NumsProjectiles;
+		for (const FString& Arg : Args)
+		{
+			NumsProjectiles.Add(FMath::Max(FCString::Atoi(*Arg), 1));
+		}
+		if (NumsProjectiles.Num() == 0)
+		{
+			NumsProjectiles = { 1000, 10000, 20000 };
+		}
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		AProjectileManager* ProjectileManager = World->SpawnActor<AProjectileManager>(AProjectileManager::StaticClass(), FTransform::Identity, SpawnParameters);
+		if (ProjectileManager == nullptr)
+		{
+			return;
+		}
+		ProjectileManager->InitProjectileManager(AProjectileCircular::StaticClass(), NumsProjectiles.Last());
+
+		// Projectiles are fired over the real arena, on the XZ plane
+		FSpaceShooterBenchmark Benchmark;
+		const FBox& ArenaBounds = ArenaCollisionSubsystem->GetArenaBounds();
+		const FBox2D ArenaPlaneBounds(FVector2D(ArenaBounds.Min.X, ArenaBounds.Min.Z), FVector2D(ArenaBounds.Max.X, ArenaBounds.Max.Z));
+		const double PlaneY = ArenaBounds.GetCenter().Y;
+		auto FireUpTo = [&Benchmark, &ArenaPlaneBounds, PlaneY, ProjectileManager](int32 NumProjectiles)
+		{
+			while (ProjectileManager->GetNumProjectiles() < NumProjectiles)
+			{
+				const FVector2D PlanePosition = Benchmark.RandomPosition(ArenaPlaneBounds);
+				const FVector2D PlaneDirection = Benchmark.RandomDirection();
+				ProjectileManager->FireProjectile(FVector(PlanePosition.X, PlaneY, PlanePosition.Y), FVector(PlaneDirection.X, 0.0, PlaneDirection.Y),
+					Benchmark.GetRandomStream().FRandRange(500.0f, 1500.0f), nullptr);
+			}
+		};
+
+		for (const int32 NumProjectiles : NumsProjectiles)
+		{
+			ProjectileManager->ResetProjectiles();
+
+			double TotalMilliseconds = 0.0;
+			double WorstFrameMilliseconds = 0.0;
+			for (int32 Frame = 0; Frame < NumBenchmarkFrames; ++Frame)
+			{
+				FireUpTo(NumProjectiles);
+				const double FrameMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([ProjectileManager]()
+				{
+					ProjectileManager->Tick(BenchmarkFrameSeconds);
+				});
+				TotalMilliseconds += FrameMilliseconds;
+				WorstFrameMilliseconds = FMath::Max(WorstFrameMilliseconds, FrameMilliseconds);
+			}
+
+			const double AverageMilliseconds = TotalMilliseconds / NumBenchmarkFrames;
+			UE_LOG(LogSpaceShooterBenchmark, Log, TEXT("%d managed projectiles: update %.3f ms per frame (%.1f ns per projectile), worst frame %.3f ms%s"),
+				NumProjectiles, AverageMilliseconds, AverageMilliseconds * 1.0e6 / NumProjectiles, WorstFrameMilliseconds,
+				AverageMilliseconds > BenchmarkFrameSeconds * 1000.0 ? TEXT(" - OVER 60 FPS FRAME") : TEXT(""));
+		}
+
+		// Don't leave the benchmark's projectiles in the game
+		ProjectileManager->ResetProjectiles();
+		ProjectileManager->Destroy();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkProjectileManagerCommand(
+	TEXT("SpaceShooter.BenchmarkProjectileManager"),
+	TEXT("Times the projectile manager update (movement, arena collision and sprite update) for the given numbers of projectiles (default 1000, 10000 and 20000)"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunProjectileManagerBenchmark));
+#endif // !UE_BUILD_SHIPPING
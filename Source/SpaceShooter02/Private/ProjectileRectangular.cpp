@@ -36,23 +36,15 @@ const TCHAR* AProjectileRectangular::GetDefaultSpritePath() const
 	return ProjectileRectangular::DefaultProjectileSpritePath;
 }
 
-void AProjectileRectangular::OnCollisionOverlap(
-	UPrimitiveComponent* OverlappedComponent,
-	AActor* OtherActor,
-	UPrimitiveComponent* OtherComp,
-	int32 OtherBodyIndex,
-	bool bFromSweep,
-	const FHitResult& SweepResult)
+void AProjectileRectangular::OnEnemyHit(AEnemyBase* Enemy)
 {
-	// Ignore this collision if the colliding actor is the Instigator (i.e. the Actor that "fired" this projectile)
-	if (OtherActor != nullptr && OtherActor == GetInstigator())
+	// Ignore this hit if the enemy is the Instigator (i.e. the Actor that "fired" this projectile)
+	if (Enemy == nullptr || Enemy == GetInstigator())
 	{
 		return;
 	}
 
-	if (AEnemyBase* CollidingEnemy = Cast<AEnemyBase>(OtherActor))
-	{
-		// The colliding actor is an enemy. Deal damage / destroy the enemy.
-		CollidingEnemy->DestroyEnemy();
-	}
+	// Deal damage / destroy the enemy
+	Enemy->DamageEnemy();
+	ConsumeEnemyPierce();
 }
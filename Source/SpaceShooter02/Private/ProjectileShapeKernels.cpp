@@ -0,0 +1,75 @@
+// Copyright 2024 Richard Skala
+
+#include "ProjectileShapeKernels.h"
+
+#include "HAL/IConsoleManager.h"
+
+#include "SpaceShooterBenchmark.h"
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	static constexpr int32 NumBenchmarkProjectiles = 1024;
+	static constexpr int32 NumBenchmarkBoxes = 256;
+
+	// Sweeps every projectile of the batch against every box and logs the average cost of one hit test
+	template<typename ShapeType>
+	void BenchmarkShapeKernel(const TCHAR* KernelName, const TProjectileBatch<ShapeType>& Batch, TConstArrayView<FVector2D> BoxCenters, TConstArrayView<FVector2D> BoxHalfExtents)
+	{
+		int32 NumHits = 0;
+		const double ElapsedMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([&Batch, &BoxCenters, &BoxHalfExtents, &NumHits]()
+		{
+			for (int32 ProjectileIndex = 0; ProjectileIndex < Batch.Num(); ++ProjectileIndex)
+			{
+				for (int32 BoxIndex = 0; BoxIndex < BoxCenters.Num(); ++BoxIndex)
+				{
+					float Time = 0.0f;
+					if (Batch.Shapes[ProjectileIndex].SweepVsBox(Batch.Starts[ProjectileIndex], Batch.Deltas[ProjectileIndex], BoxCenters[BoxIndex], BoxHalfExtents[BoxIndex], Time))
+					{
+						++NumHits;
+					}
+				}
+			}
+		});
+
+		const int32 NumTests = Batch.Num() * BoxCenters.Num();
+		UE_LOG(LogSpaceShooterBenchmark, Log, TEXT("%s kernel: %d hit tests in %.3f ms (%.2f ns per test, %d hits)"),
+			KernelName, NumTests, ElapsedMilliseconds, ElapsedMilliseconds * 1.0e6 / NumTests, NumHits);
+	}
+
+	void RunShapeKernelBenchmark()
+	{
+		// Sizes are roughly those of the game's projectiles, enemies and per-frame movement
+		FSpaceShooterBenchmark Benchmark;
+		FRandomStream& RandomStream = Benchmark.GetRandomStream();
+
+		TArray<FVector2D> BoxCenters;
+		TArray<FVector2D> BoxHalfExtents;
+		for (int32 i = 0; i < NumBenchmarkBoxes; ++i)
+		{
+			BoxCenters.Add(Benchmark.RandomPosition());
+			BoxHalfExtents.Add(FVector2D(RandomStream.FRandRange(20.0, 60.0), RandomStream.FRandRange(20.0, 60.0)));
+		}
+
+		TProjectileBatch<FCircleProjectileShape> CircleBatch;
+		TProjectileBatch<FOrientedBoxProjectileShape> OrientedBoxBatch;
+		for (int32 i = 0; i < NumBenchmarkProjectiles; ++i)
+		{
+			const FVector2D Start = Benchmark.RandomPosition();
+			const FVector2D Forward = Benchmark.RandomDirection();
+			const FVector2D End = Start + Forward * RandomStream.FRandRange(10.0, 200.0);
+
+			CircleBatch.Add(FCircleProjectileShape{ 10.0f }, Start, End, i);
+			OrientedBoxBatch.Add(FOrientedBoxProjectileShape{ Forward, FVector2D(5.0, 20.0) }, Start, End, i);
+		}
+
+		BenchmarkShapeKernel(TEXT("Circle"), CircleBatch, BoxCenters, BoxHalfExtents);
+		BenchmarkShapeKernel(TEXT("Oriented box"), OrientedBoxBatch, BoxCenters, BoxHalfExtents);
+	}
+}
+
+static FAutoConsoleCommand BenchmarkShapeKernelsCommand(
+	TEXT("SpaceShooter.BenchmarkShapeKernels"),
+	TEXT("Times the projectile shape kernels against random enemy boxes and logs the cost of one hit test for each"),
+	FConsoleCommandDelegate::CreateStatic(&RunShapeKernelBenchmark));
+#endif // !UE_BUILD_SHIPPING
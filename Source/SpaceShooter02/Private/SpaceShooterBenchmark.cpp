@@ -0,0 +1,35 @@
+// Copyright 2024 Richard Skala
+
+#include "SpaceShooterBenchmark.h"
+
+#if !UE_BUILD_SHIPPING
+DEFINE_LOG_CATEGORY(LogSpaceShooterBenchmark)
+
+namespace
+{
+	static constexpr int32 BenchmarkRandomSeed = 2024;
+	static constexpr double BenchmarkArenaHalfExtent = 2000.0;
+}
+
+FSpaceShooterBenchmark::FSpaceShooterBenchmark()
+	: RandomStream(BenchmarkRandomSeed)
+{
+}
+
+FBox2D FSpaceShooterBenchmark::GetArenaBounds()
+{
+	return FBox2D(FVector2D(-BenchmarkArenaHalfExtent), FVector2D(BenchmarkArenaHalfExtent));
+}
+
+FVector2D FSpaceShooterBenchmark::RandomPosition(const FBox2D& Bounds)
+{
+	return FVector2D(RandomStream.FRandRange(Bounds.Min.X, Bounds.Max.X), RandomStream.FRandRange(Bounds.Min.Y, Bounds.Max.Y));
+}
+
+FVector2D FSpaceShooterBenchmark::RandomDirection()
+{
+	// Angles are measured from +Z towards +X
+	const double Angle = RandomStream.FRandRange(0.0, UE_TWO_PI);
+	return FVector2D(FMath::Sin(Angle), FMath::Cos(Angle));
+}
+#endif // !UE_BUILD_SHIPPING
@@ -9,6 +9,8 @@
 
 #include "AudioEnums.h"
 #include "AudioController.h"
+#include "PoolActorContainer.h"
+#include "PoolProfileSaveGame.h"
 #include "SpaceShooterGameState.h"
 #include "SpaceShooterSaveGame.h"
 
@@ -390,6 +392,42 @@ FString USpaceShooterGameInstance::GetGameVersionString() const
 	return FString::Printf(TEXT("v%s"), *AppVersion);
 }
 
+int32 USpaceShooterGameInstance::GetProfiledPoolSize(FName PoolName, int32 DefaultPoolSize) const
+{
+	const FPoolProfileData* PoolProfile = PoolProfileSaveGame != nullptr ? PoolProfileSaveGame->FindPoolProfile(PoolName) : nullptr;
+	if (PoolProfile == nullptr)
+	{
+		return DefaultPoolSize;
+	}
+
+	int32 ProfiledPoolSize = FMath::CeilToInt32(PoolProfile->PeakNumActive * (1.0f + PoolSizeHeadroom));
+	ProfiledPoolSize = FMath::Max(ProfiledPoolSize, MinProfiledPoolSize);
+
+	UE_LOG(LogSpaceShooterGameInstance, Log, TEXT("Pool %s sized to %d from profile (%s)"), *PoolName.ToString(), ProfiledPoolSize, *PoolProfile->ToString());
+	return ProfiledPoolSize;
+}
+
+void USpaceShooterGameInstance::RecordPoolProfile(const FPoolActorContainerBase& Pool)
+{
+	if (PoolProfileSaveGame != nullptr)
+	{
+		PoolProfileSaveGame->RecordPoolProfile(Pool);
+	}
+}
+
+void USpaceShooterGameInstance::SavePoolProfile()
+{
+	if (PoolProfileSaveGame != nullptr)
+	{
+		// Saved asynchronously, as this happens on the game over frame
+		UGameplayStatics::AsyncSaveGameToSlot(PoolProfileSaveGame, PoolProfileSaveSlotName, DefaultSaveSlotIndex,
+			FAsyncSaveGameToSlotDelegate::CreateWeakLambda(this, [](const FString& SlotName, const int32 UserIndex, bool bSaveGameSuccess)
+			{
+				UE_CLOG(!bSaveGameSuccess, LogSpaceShooterGameInstance, Warning, TEXT("Failed to save pool profile to slot %s"), *SlotName);
+			}));
+	}
+}
+
 void USpaceShooterGameInstance::Init()
 {
 	Super::Init();
@@ -421,6 +459,18 @@ void USpaceShooterGameInstance::Init()
 		UE_CLOG(!bSaveGameSuccess, LogSpaceShooterGameInstance, Warning, TEXT("Failed to create Save Game"));
 	}
 
+	// Load the pool profile from the last run, or start with an empty one (pools then use their default sizes)
+	if (UGameplayStatics::DoesSaveGameExist(PoolProfileSaveSlotName, DefaultSaveSlotIndex))
+	{
+		PoolProfileSaveGame = Cast<UPoolProfileSaveGame>(UGameplayStatics::LoadGameFromSlot(PoolProfileSaveSlotName, DefaultSaveSlotIndex));
+		UE_CLOG(PoolProfileSaveGame == nullptr, LogSpaceShooterGameInstance, Warning, TEXT("Failed to load pool profile. Using default pool sizes."));
+	}
+	if (PoolProfileSaveGame == nullptr)
+	{
+		PoolProfileSaveGame = Cast<UPoolProfileSaveGame>(UGameplayStatics::CreateSaveGameObject(UPoolProfileSaveGame::StaticClass()));
+		ensure(PoolProfileSaveGame != nullptr);
+	}
+
 	// Create the Audio Controller
 	if (ensure(AudioControllerClass != nullptr))
 	{
@@ -8,6 +8,7 @@
 #include "TimerManager.h"
 
 #include "EnemyBase.h"
+#include "EnemyBulletSubsystem.h"
 #include "EnemySpawner.h"
 //#include "ExplosionBase.h"
 #include "EnemyPoolController.h"
@@ -19,6 +20,7 @@
 #include "ProjectileBase.h"
 #include "ProjectileController.h"
 #include "SpaceShooterGameInstance.h"
+#include "SpaceShooterPoolSubsystem.h"
 #include "SpawnAnimController.h"
 #include "UI/SpaceShooterMenuController.h"
 
@@ -54,6 +56,21 @@ void ASpaceShooterGameState::StartGame()
 		}
 	}
 
+	if (USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld()))
+	{
+		// Pools only shrink while no game is running
+		PoolSubsystem->SetPoolShrinkEnabled(false);
+
+		// Finish creating any pooled actors that were not created while the menus were showing
+		PoolSubsystem->FlushPrewarm();
+
+		// The pools are full. Keep garbage collection from traversing every pooled actor during the game.
+		PoolSubsystem->ClusterPoolActors();
+
+		// Gameplay should not create any UObjects from here on
+		PoolSubsystem->BeginGameplayObjectCreationTracking();
+	}
+
 	// Enable the player ship (set visible and allow controlling of the ship)
 	if (PlayerShipPawn != nullptr)
 	{
@@ -97,6 +114,13 @@ void ASpaceShooterGameState::EndGame(int32 FinalScore)
 {
 	UE_LOG(LogSpaceShooterGameState, Log, TEXT("ASpaceShooterGameState::EndGame - %s"), *GetName());
 
+	// Spread the pool cleanup over the game over delay instead of doing it all when the delay ends
+	if (USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld()))
+	{
+		PoolSubsystem->EndGameplayObjectCreationTracking();
+		PoolSubsystem->BeginAmortizedReset(DelayAfterGameOver);
+	}
+
 	if (UWorld* World = GetWorld())
 	{
 		FTimerHandle TimerHandle;
@@ -125,18 +149,19 @@ void ASpaceShooterGameState::AddCurrentScoreMultiplier(int32 AmountToAdd)
 	OnPlayerMultiplierChanged.Broadcast(CurrentScoreMultiplier);
 }
 
-void ASpaceShooterGameState::FireProjectile(FVector ProjectilePosition, FRotator ProjectileRotation, APawn* InInstigator)
+void ASpaceShooterGameState::FireVolley(TConstArrayView<FTransform> FireTransforms, APawn* InInstigator)
 {
 	if (ProjectileController != nullptr)
 	{
-		AProjectileBase* Projectile = ProjectileController->GetInactiveProjectile();
-		if (Projectile != nullptr)
-		{
-			Projectile->SetInstigator(InInstigator);
-			Projectile->SetActorLocationAndRotation(ProjectilePosition, ProjectileRotation);
-			Projectile->ActivatePoolObject();
-			TotalProjectilesFiredThisGame++;
-		}
+		TotalProjectilesFiredThisGame += ProjectileController->FireVolley(FireTransforms, InInstigator);
+	}
+}
+
+void ASpaceShooterGameState::FireHomingVolley(TConstArrayView<FTransform> FireTransforms, APawn* InInstigator)
+{
+	if (ProjectileController != nullptr)
+	{
+		TotalProjectilesFiredThisGame += ProjectileController->FireHomingVolley(FireTransforms, InInstigator);
 	}
 }
 
@@ -156,6 +181,12 @@ void ASpaceShooterGameState::BeginPlay()
 	// Start game in Main Menu
 	ShooterMenuGameState = EShooterMenuGameState::MainMenu;
 
+	// Pooled actors are created over the next frames while the main menu is showing
+	if (USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld()))
+	{
+		PoolSubsystem->SetPrewarmFrameBudgetMs(PoolPrewarmFrameBudgetMs);
+	}
+
 	// Create projectile controller
 	if (ensure(ProjectileControllerClass != nullptr))
 	{
@@ -257,7 +288,7 @@ void ASpaceShooterGameState::OnPlayerShipDestroyed()
 	EndGame(PlayerScore);
 }
 
-void ASpaceShooterGameState::OnEnemyDeath(FVector EnemyDeathPosition, UNiagaraSystem* EnemyDeathEffect, bool bKilledFromBoost)
+void ASpaceShooterGameState::OnEnemyDeath(FVector EnemyDeathPosition, UNiagaraSystem* EnemyDeathEffect, bool bKilledFromBoost, int32 EnemyScoreValue)
 {
 	int32 ScoreToAdd = EnemyScoreValue * CurrentScoreMultiplier;
 	PlayerScore += ScoreToAdd;
@@ -392,25 +423,34 @@ void ASpaceShooterGameState::OnGameOverTimerTimeout(int32 FinalScore)
 		CurrentScoreMultiplier,
 		GameplaySessionLength);
 
-	// Reset all object pools
-	if (ProjectileController != nullptr)
+	// Save pool occupancy before the pools are reset, so the next launch can size them
+	USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld());
+	if (PoolSubsystem != nullptr)
 	{
-		ProjectileController->ResetProjectilePool();
+		PoolSubsystem->RecordPoolProfiles();
 	}
-	
-	if (PickupItemController != nullptr)
+
+	if (PoolSubsystem != nullptr)
 	{
-		PickupItemController->ResetScoreMultiplierPool();
+		// Most pooled actors were already deactivated over the game over delay. Reset whatever is left.
+		PoolSubsystem->FinishAmortizedReset();
+
+		// While no game is running, let pools that grew during the game shrink back. Shrinking destroys actors, so they
+		// must leave the GC cluster first.
+		PoolSubsystem->DissolvePoolActorCluster();
+		PoolSubsystem->SetPoolShrinkEnabled(true);
 	}
 
-	if (ExplosionSpriteController != nullptr)
+	// Projectiles simulated by the projectile manager are not pooled actors, so they are not part of the pool reset
+	if (ProjectileController != nullptr)
 	{
-		ExplosionSpriteController->ResetExplosionSpritePools();
+		ProjectileController->ResetProjectilePool();
 	}
 
-	if (EnemyPoolController != nullptr)
+	// Neither are enemy bullets
+	if (UEnemyBulletSubsystem* EnemyBulletSubsystem = UWorld::GetSubsystem<UEnemyBulletSubsystem>(GetWorld()))
 	{
-		EnemyPoolController->ResetEnemyPools();
+		EnemyBulletSubsystem->ResetEnemyBullets();
 	}
 }
 
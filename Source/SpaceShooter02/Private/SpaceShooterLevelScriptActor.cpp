@@ -9,11 +9,17 @@ DEFINE_LOG_CATEGORY_STATIC(LogSpaceShooterLevelScript, Log, All)
 
 void ASpaceShooterLevelScriptActor::GetLevelBoundingBoxPositionAndExtent(FVector& OutPosition, FVector& OutExtent) const
 {
+	OutExtent = LevelBoundingBoxExtent;
 	if (LevelBoundingBox != nullptr)
 	{
 		OutPosition = LevelBoundingBox->GetActorLocation();
+
+		// Read the extent directly if this is called before BeginPlay (e.g. by a world subsystem)
+		if (UBoxComponent* LevelBoundingBoxComp = Cast<UBoxComponent>(LevelBoundingBox->GetRootComponent()))
+		{
+			OutExtent = LevelBoundingBoxComp->GetUnscaledBoxExtent();
+		}
 	}
-	OutExtent = LevelBoundingBoxExtent;
 }
 
 void ASpaceShooterLevelScriptActor::BeginPlay()
@@ -0,0 +1,493 @@
+// Copyright 2024 Richard Skala
+
+#include "SpaceShooterPoolSubsystem.h"
+
+#include "Kismet/GameplayStatics.h"
+
+#include "PoolActorCluster.h"
+#include "PoolPrewarmScheduler.h"
+#include "SpaceShooter02.h"
+#include "SpaceShooterGameInstance.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pool State Flush"), STAT_PoolStateFlush, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Pool Teardown"), STAT_PoolTeardown, STATGROUP_SpaceShooter);
+DECLARE_CYCLE_STAT(TEXT("Pool Lifetime Expiry"), STAT_PoolLifetimeExpiry, STATGROUP_SpaceShooter);
+
+namespace
+{
+	// Number of actors deactivated between frame budget checks during an amortized reset
+	static constexpr int32 TeardownBatchSize = 8;
+
+	// Lower limits for the config settings, so a bad value can't check or budget every frame at zero
+	static constexpr float MinPoolShrinkCheckInterval = 0.1f;
+	static constexpr float MinTeardownFrameBudgetMs = 0.1f;
+}
+
+DEFINE_LOG_CATEGORY_STATIC(LogSpaceShooterPoolSubsystem, Log, All)
+
+void USpaceShooterPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PrewarmScheduler = NewObject<UPoolPrewarmScheduler>(this);
+	ensure(PrewarmScheduler != nullptr);
+
+	LifetimeWheel.Start(GetWorld() != nullptr ? GetWorld()->GetTimeSeconds() : 0.0);
+
+	// Queued state changes are applied after every actor, timer and tickable object has ticked, before the frame is rendered
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ThisClass::OnWorldPostActorTick);
+}
+
+void USpaceShooterPoolSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	PendingPoolObjectStateChanges.Empty();
+	LifetimeWheel.Reset();
+
+	DissolvePoolActorCluster();
+#if !UE_BUILD_SHIPPING
+	GameplayObjectCreationTracker.Stop();
+#endif
+
+	// Detach the pooled actors before the pools are freed
+	for (TPair<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>>& PoolPair : Pools)
+	{
+		PoolPair.Value->Empty();
+	}
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+bool USpaceShooterPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USpaceShooterPoolSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (UWorld* World = GetWorld())
+	{
+		SCOPE_CYCLE_COUNTER(STAT_PoolLifetimeExpiry);
+		LifetimeWheel.Advance(World->GetTimeSeconds(), [](APoolActor* PoolActor, uint32 Generation)
+		{
+			// Skip expiries cancelled by a deactivation or pause since they were scheduled
+			if (PoolActor->LifetimeGeneration == Generation && PoolActor->IsPoolObjectActive())
+			{
+				PoolActor->OnLifetimeExpired();
+			}
+		});
+	}
+
+	if (bAmortizedResetInProgress)
+	{
+		UpdateAmortizedReset(DeltaTime);
+	}
+
+	if (bPoolShrinkEnabled)
+	{
+		UpdatePoolShrink(DeltaTime);
+	}
+
+	CheckGameplayObjectCreation();
+}
+
+void USpaceShooterPoolSubsystem::UpdatePoolShrink(float DeltaTime)
+{
+	TimeSinceLastShrinkCheck += DeltaTime;
+	if (TimeSinceLastShrinkCheck < FMath::Max(PoolShrinkCheckInterval, MinPoolShrinkCheckInterval))
+	{
+		return;
+	}
+	TimeSinceLastShrinkCheck = 0.0f;
+
+	const double CurrentTimeSeconds = GetWorld() != nullptr ? GetWorld()->GetTimeSeconds() : 0.0;
+	for (TPair<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>>& PoolPair : Pools)
+	{
+		PoolPair.Value->UpdateShrink(CurrentTimeSeconds);
+	}
+}
+
+void USpaceShooterPoolSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	USpaceShooterPoolSubsystem* This = CastChecked<USpaceShooterPoolSubsystem>(InThis);
+	for (TPair<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>>& PoolPair : This->Pools)
+	{
+		PoolPair.Value->AddReferencedObjects(Collector);
+	}
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void USpaceShooterPoolSubsystem::CreatePool(TSubclassOf<APoolActor> PoolActorClass, int32 DefaultPoolSize, const FPoolGrowthSettings& GrowthSettings)
+{
+	if (!ensureAlways(PoolActorClass != nullptr) || Pools.Contains(PoolActorClass))
+	{
+		return;
+	}
+
+	TPoolActorContainer<APoolActor>& Pool = *Pools.Add(PoolActorClass, MakeUnique<TPoolActorContainer<APoolActor>>());
+	Pool.InitPool(this, PoolActorClass->GetFName(), GrowthSettings, FCreatePoolActorDelegate::CreateWeakLambda(this, [this, PoolActorClass]()
+	{
+		return CreateAndAddPoolActor(PoolActorClass);
+	}));
+
+	// Tick the whole pool from one tick function (or not at all, if the class has no per-frame work).
+	// Blueprint classes that implement Tick keep ticking per actor.
+	if (!PoolActorClass->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AActor, ReceiveTick)))
+	{
+		Pool.EnablePoolTick(GetWorld(), PoolActorClass->GetDefaultObject<APoolActor>()->GetPoolActorBatchTickFunction());
+	}
+	else
+	{
+		UE_LOG(LogSpaceShooterPoolSubsystem, Log, TEXT("%s implements Tick in Blueprint. Its pooled actors tick individually."), *PoolActorClass->GetName());
+	}
+
+	// Size the pool from the last run's profile, if there is one
+	int32 PoolSize = DefaultPoolSize;
+	if (USpaceShooterGameInstance* GameInstance = Cast<USpaceShooterGameInstance>(UGameplayStatics::GetGameInstance(GetWorld())))
+	{
+		PoolSize = GameInstance->GetProfiledPoolSize(Pool.GetPoolName(), DefaultPoolSize);
+	}
+	Pool.SetStartupPoolSize(PoolSize);
+
+	// Spread the spawns over several frames
+	if (PrewarmScheduler != nullptr)
+	{
+		PrewarmScheduler->AddPrewarmRequest(Pool.GetPoolName(), PoolSize, FSimpleDelegate::CreateWeakLambda(this, [this, PoolActorClass]()
+		{
+			CreateAndAddPoolActor(PoolActorClass);
+		}));
+	}
+	else
+	{
+		for (int32 i = 0; i < PoolSize; ++i)
+		{
+			CreateAndAddPoolActor(PoolActorClass);
+		}
+	}
+}
+
+APoolActor* USpaceShooterPoolSubsystem::AcquirePoolActor(TSubclassOf<APoolActor> PoolActorClass)
+{
+	FPoolActorContainerBase* Pool = FindPool(PoolActorClass);
+	if (!ensureMsgf(Pool != nullptr, TEXT("%s - No pool for class %s"), ANSI_TO_TCHAR(__FUNCTION__), *GetNameSafe(PoolActorClass)))
+	{
+		return nullptr;
+	}
+
+	// The pool grows according to its growth settings if it is empty
+	return static_cast<TPoolActorContainer<APoolActor>*>(Pool)->AcquireOrGrow();
+}
+
+int32 USpaceShooterPoolSubsystem::AcquirePoolActors(TSubclassOf<APoolActor> PoolActorClass, int32 Num, TArray<APoolActor*>& OutPoolActors)
+{
+	FPoolActorContainerBase* Pool = FindPool(PoolActorClass);
+	if (!ensureMsgf(Pool != nullptr, TEXT("%s - No pool for class %s"), ANSI_TO_TCHAR(__FUNCTION__), *GetNameSafe(PoolActorClass)))
+	{
+		return 0;
+	}
+
+	return static_cast<TPoolActorContainer<APoolActor>*>(Pool)->AcquireMultiple(Num, OutPoolActors);
+}
+
+void USpaceShooterPoolSubsystem::ResetPool(TSubclassOf<APoolActor> PoolActorClass)
+{
+	if (FPoolActorContainerBase* Pool = FindPool(PoolActorClass))
+	{
+		Pool->ResetPool();
+	}
+}
+
+void USpaceShooterPoolSubsystem::BeginAmortizedReset(float DurationSeconds)
+{
+	bAmortizedResetInProgress = true;
+	AmortizedResetTimeRemaining = DurationSeconds;
+}
+
+void USpaceShooterPoolSubsystem::FinishAmortizedReset()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoolTeardown);
+
+	int32 NumActiveRemaining = 0;
+	for (TPair<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>>& PoolPair : Pools)
+	{
+		NumActiveRemaining += PoolPair.Value->ResetPool();
+	}
+	UE_CLOG(bAmortizedResetInProgress, LogSpaceShooterPoolSubsystem, Verbose, TEXT("Amortized pool reset finished. %d actors were left for the last frame."), NumActiveRemaining);
+
+	bAmortizedResetInProgress = false;
+	AmortizedResetTimeRemaining = 0.0f;
+}
+
+float USpaceShooterPoolSubsystem::GetTeardownFrameBudgetMs() const
+{
+	return FMath::Max(TeardownFrameBudgetMs, MinTeardownFrameBudgetMs);
+}
+
+void USpaceShooterPoolSubsystem::UpdateAmortizedReset(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoolTeardown);
+
+	AmortizedResetTimeRemaining = FMath::Max(AmortizedResetTimeRemaining - DeltaTime, 0.0f);
+
+	int32 NumActive = 0;
+	for (const TPair<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>>& PoolPair : Pools)
+	{
+		NumActive += PoolPair.Value->GetNumActive();
+	}
+
+	if (NumActive <= 0)
+	{
+		return;
+	}
+
+	// Spread the remaining actors evenly over the frames left in the window
+	int32 NumToReset = NumActive;
+	if (AmortizedResetTimeRemaining > DeltaTime)
+	{
+		NumToReset = FMath::CeilToInt32(NumActive * (DeltaTime / AmortizedResetTimeRemaining));
+	}
+
+	const double BudgetEndTimeSeconds = FPlatformTime::Seconds() + GetTeardownFrameBudgetMs() / 1000.0;
+	for (TPair<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>>& PoolPair : Pools)
+	{
+		while (NumToReset > 0 && PoolPair.Value->GetNumActive() > 0)
+		{
+			const int32 NumReset = PoolPair.Value->ResetPool(FMath::Min(NumToReset, TeardownBatchSize));
+			NumToReset -= FMath::Max(NumReset, 1);
+
+			if (FPlatformTime::Seconds() >= BudgetEndTimeSeconds)
+			{
+				// Out of budget. The rest is picked up next frame, or by FinishAmortizedReset.
+				return;
+			}
+		}
+	}
+}
+
+FPoolActorContainerBase* USpaceShooterPoolSubsystem::FindPool(TSubclassOf<APoolActor> PoolActorClass) const
+{
+	const TUniquePtr<TPoolActorContainer<APoolActor>>* Pool = Pools.Find(PoolActorClass);
+	return Pool != nullptr ? Pool->Get() : nullptr;
+}
+
+void USpaceShooterPoolSubsystem::FlushPrewarm()
+{
+	if (PrewarmScheduler != nullptr)
+	{
+		PrewarmScheduler->Flush();
+	}
+}
+
+void USpaceShooterPoolSubsystem::SetPrewarmFrameBudgetMs(float InPrewarmFrameBudgetMs)
+{
+	if (PrewarmScheduler != nullptr)
+	{
+		PrewarmScheduler->SetFrameBudgetMs(InPrewarmFrameBudgetMs);
+	}
+}
+
+void USpaceShooterPoolSubsystem::SetPoolShrinkEnabled(bool bInPoolShrinkEnabled)
+{
+	bPoolShrinkEnabled = bInPoolShrinkEnabled;
+	TimeSinceLastShrinkCheck = 0.0f;
+}
+
+void USpaceShooterPoolSubsystem::RecordPoolProfiles()
+{
+	USpaceShooterGameInstance* GameInstance = Cast<USpaceShooterGameInstance>(UGameplayStatics::GetGameInstance(GetWorld()));
+	if (GameInstance == nullptr)
+	{
+		return;
+	}
+
+	for (TPair<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>>& PoolPair : Pools)
+	{
+		const FPoolActorContainerBase& Pool = *PoolPair.Value;
+		UE_LOG(LogSpaceShooterPoolSubsystem, Log, TEXT("Pool %s - Size: %d, Active: %d, Peak: %d, Misses: %d, Grow Events: %d"),
+			*Pool.GetPoolName().ToString(), Pool.GetNum(), Pool.GetNumActive(), Pool.GetPeakNumActive(), Pool.GetNumMisses(), Pool.GetNumGrowEvents());
+		GameInstance->RecordPoolProfile(Pool);
+	}
+
+	GameInstance->SavePoolProfile();
+}
+
+void USpaceShooterPoolSubsystem::QueuePoolObjectStateChange(APoolActor* PoolActor)
+{
+	if (PoolActor != nullptr && !PoolActor->bPoolObjectStateChangeQueued)
+	{
+		PoolActor->bPoolObjectStateChangeQueued = true;
+		PendingPoolObjectStateChanges.Add(PoolActor);
+	}
+}
+
+void USpaceShooterPoolSubsystem::ClusterPoolActors()
+{
+	if (!bClusterPoolActors || !UPoolActorCluster::CanCreatePoolActorClusters())
+	{
+		return;
+	}
+
+	TArray<APoolActor*> AllPoolActors;
+	for (const TPair<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>>& PoolPair : Pools)
+	{
+		PoolPair.Value->GetAllPoolActors(AllPoolActors);
+	}
+
+	// Nothing to do if the pools have not changed since the cluster was created
+	if (PoolActorCluster != nullptr && PoolActorCluster->IsClustered() && PoolActorCluster->GetNumClusteredPoolActors() == AllPoolActors.Num())
+	{
+		return;
+	}
+
+	// A cluster cannot be extended, so replace it
+	DissolvePoolActorCluster();
+	PoolActorCluster = NewObject<UPoolActorCluster>(this);
+	PoolActorCluster->CreatePoolActorCluster(AllPoolActors);
+}
+
+void USpaceShooterPoolSubsystem::DissolvePoolActorCluster()
+{
+	if (PoolActorCluster != nullptr)
+	{
+		PoolActorCluster->DissolvePoolActorCluster();
+		PoolActorCluster = nullptr;
+	}
+}
+
+void USpaceShooterPoolSubsystem::BeginGameplayObjectCreationTracking()
+{
+#if !UE_BUILD_SHIPPING
+	if (bTrackGameplayObjectCreation)
+	{
+		GameplayObjectCreationTracker.Start();
+		GameplayObjectCreationTrackingStartTimeSeconds = FPlatformTime::Seconds();
+		LastNumGameplayObjectsCreated = 0;
+		NumGameplayFramesTracked = 0;
+		NumGameplayFramesCreatingObjects = 0;
+	}
+#endif
+}
+
+void USpaceShooterPoolSubsystem::EndGameplayObjectCreationTracking()
+{
+#if !UE_BUILD_SHIPPING
+	if (!GameplayObjectCreationTracker.IsTracking())
+	{
+		return;
+	}
+	GameplayObjectCreationTracker.Stop();
+
+	const int32 NumCreated = GameplayObjectCreationTracker.GetNumCreated();
+	const double TrackedSeconds = FPlatformTime::Seconds() - GameplayObjectCreationTrackingStartTimeSeconds;
+	if (NumCreated == 0)
+	{
+		UE_LOG(LogSpaceShooterPoolSubsystem, Log, TEXT("No UObjects were created during %.1f seconds (%d frames) of gameplay"), TrackedSeconds, NumGameplayFramesTracked);
+		return;
+	}
+
+	// Anything created during gameplay eventually becomes garbage. Log the worst offenders so they can be pooled.
+	UE_LOG(LogSpaceShooterPoolSubsystem, Warning, TEXT("%d UObjects were created during %.1f seconds of gameplay, on %d of %d frames"),
+		NumCreated, TrackedSeconds, NumGameplayFramesCreatingObjects, NumGameplayFramesTracked);
+
+	static constexpr int32 MaxNumClassesToLog = 10;
+	TArray<TPair<FName, int32>> NumCreatedPerClass;
+	GameplayObjectCreationTracker.GetNumCreatedPerClass(NumCreatedPerClass);
+	for (int32 i = 0; i < NumCreatedPerClass.Num() && i < MaxNumClassesToLog; ++i)
+	{
+		UE_LOG(LogSpaceShooterPoolSubsystem, Warning, TEXT("    %s: %d"), *NumCreatedPerClass[i].Key.ToString(), NumCreatedPerClass[i].Value);
+	}
+#endif
+}
+
+void USpaceShooterPoolSubsystem::CheckGameplayObjectCreation()
+{
+#if !UE_BUILD_SHIPPING
+	if (!GameplayObjectCreationTracker.IsTracking())
+	{
+		return;
+	}
+
+	++NumGameplayFramesTracked;
+	const int32 NumCreated = GameplayObjectCreationTracker.GetNumCreated();
+	const int32 NumCreatedThisFrame = NumCreated - LastNumGameplayObjectsCreated;
+	LastNumGameplayObjectsCreated = NumCreated;
+	if (NumCreatedThisFrame <= 0)
+	{
+		return;
+	}
+
+	++NumGameplayFramesCreatingObjects;
+	if (NumGameplayFramesCreatingObjects == 1)
+	{
+		// Name the classes on the first offending frame, while the cause is still on screen
+		TArray<TPair<FName, int32>> NumCreatedPerClass;
+		GameplayObjectCreationTracker.GetNumCreatedPerClass(NumCreatedPerClass);
+		const FName MostCreatedClass = NumCreatedPerClass.Num() > 0 ? NumCreatedPerClass[0].Key : NAME_None;
+		UE_LOG(LogSpaceShooterPoolSubsystem, Warning, TEXT("%d UObjects were created during gameplay frame %d (most created: %s). Steady-state gameplay should create none."),
+			NumCreatedThisFrame, NumGameplayFramesTracked, *MostCreatedClass.ToString());
+	}
+#endif
+}
+
+void USpaceShooterPoolSubsystem::ScheduleLifetimeExpiry(APoolActor* PoolActor, double ExpiryTimeSeconds)
+{
+	if (PoolActor != nullptr)
+	{
+		LifetimeWheel.Schedule(PoolActor, PoolActor->LifetimeGeneration, ExpiryTimeSeconds);
+	}
+}
+
+void USpaceShooterPoolSubsystem::FlushPoolObjectStateChanges()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PoolStateFlush);
+
+	// Enabling collision can trigger overlaps that queue more changes, so the array may grow while it is iterated
+	for (int32 i = 0; i < PendingPoolObjectStateChanges.Num(); ++i)
+	{
+		if (APoolActor* PoolActor = PendingPoolObjectStateChanges[i].Get())
+		{
+			PoolActor->bPoolObjectStateChangeQueued = false;
+			PoolActor->ApplyPoolObjectState();
+		}
+	}
+	PendingPoolObjectStateChanges.Reset();
+}
+
+void USpaceShooterPoolSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaTime)
+{
+	if (World == GetWorld())
+	{
+		FlushPoolObjectStateChanges();
+	}
+}
+
+APoolActor* USpaceShooterPoolSubsystem::CreateAndAddPoolActor(TSubclassOf<APoolActor> PoolActorClass)
+{
+	TUniquePtr<TPoolActorContainer<APoolActor>>* Pool = Pools.Find(PoolActorClass);
+	UWorld* World = GetWorld();
+	if (Pool == nullptr || World == nullptr || PoolActorClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Name = (*Pool)->MakeSpawnName();
+	SpawnParameters.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	//SpawnParameters.bNoFail = true; // Enable this to capture when SpawnActor fails
+	// The failure happens in LevelActor.cpp, line 738. Enable logging in console with: Log LogSpawn VeryVerbose
+
+	APoolActor* NewPoolActor = World->SpawnActor<APoolActor>(PoolActorClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParameters);
+	if (NewPoolActor != nullptr)
+	{
+		(*Pool)->AddPoolActor(NewPoolActor);
+	}
+	else
+	{
+		UE_LOG(LogSpaceShooterPoolSubsystem, Warning, TEXT("Failed to create pooled actor with class %s"), *PoolActorClass->GetName());
+	}
+	return NewPoolActor;
+}
@@ -4,8 +4,6 @@
 
 #include "PaperFlipbookComponent.h"
 
-const FVector ASpawnAnimBase::InactivePosition = FVector(-9000.0f, -9000.0f, 9000.0f);
-
 ASpawnAnimBase::ASpawnAnimBase()
 {
 	PrimaryActorTick.bCanEverTick = true;
@@ -43,6 +41,11 @@ void ASpawnAnimBase::DeactivatePoolObject()
 	}
 }
 
+float ASpawnAnimBase::GetSpawnAnimLength() const
+{
+	return SpawnAnimFlipbookComp != nullptr ? SpawnAnimFlipbookComp->GetFlipbookLength() : 0.0f;
+}
+
 void ASpawnAnimBase::BeginPlay()
 {
 	Super::BeginPlay();
@@ -54,11 +57,6 @@ void ASpawnAnimBase::BeginPlay()
 	}
 }
 
-FVector ASpawnAnimBase::GetInactivePoolObjectPosition() const
-{
-	return InactivePosition;
-}
-
 void ASpawnAnimBase::OnSpawnAnimationFinished()
 {
 	// This spawn animation has finished. Deactivate it.
@@ -2,41 +2,23 @@
 
 #include "SpawnAnimController.h"
 
+#include "SpaceShooterPoolSubsystem.h"
 #include "SpawnAnimBase.h"
 
 void USpawnAnimController::InitSpawnAnimPool()
 {
-	for (TSubclassOf<class ASpawnAnimBase> SpawnAnimClass : SpawnAnimClasses)
+	USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld());
+	if (PoolSubsystem == nullptr || SpawnAnimClasses.Num() <= 0)
 	{
-		if (SpawnAnimClass != nullptr)
-		{
-			int32 NumIterationsPerClass = static_cast<int32>(MAX_SPAWN_ANIMS / SpawnAnimClasses.Num());
-			for (int32 i = 0; i < NumIterationsPerClass; ++i)
-			{
-				CreateAndAddNewSpawnAnim(SpawnAnimClass);
-			}
-		}
+		return;
 	}
 
-	// Shuffle the pool
-	// https://forums.unrealengine.com/t/how-to-shuffle-a-tarray/286257/6
-	int64 DateInSeconds = FDateTime::Now().ToUnixTimestamp();
-	FRandomStream SRand = FRandomStream();
-	SRand.Initialize(DateInSeconds);
-
-	SpawnAnimPool.Sort([&SRand](const ASpawnAnimBase& A, const ASpawnAnimBase& B)
-	{
-		return SRand.GetFraction() < 0.5f;
-	});
-}
-
-void USpawnAnimController::ResetSpawnAnimPool()
-{
-	for (ASpawnAnimBase* SpawnAnim : SpawnAnimPool)
+	const int32 NumSpawnAnimsPerClass = FMath::DivideAndRoundUp(MAX_SPAWN_ANIMS, SpawnAnimClasses.Num());
+	for (TSubclassOf<ASpawnAnimBase> SpawnAnimClass : SpawnAnimClasses)
 	{
-		if (SpawnAnim != nullptr)
+		if (SpawnAnimClass != nullptr)
 		{
-			SpawnAnim->DeactivatePoolObject();
+			PoolSubsystem->CreatePool(SpawnAnimClass, NumSpawnAnimsPerClass, GrowthSettings);
 		}
 	}
 }
@@ -44,44 +26,12 @@ void USpawnAnimController::ResetSpawnAnimPool()
 ASpawnAnimBase* USpawnAnimController::GetInactiveSpawnAnim()
 {
 	ASpawnAnimBase* InactiveSpawnAnim = nullptr;
-	for (ASpawnAnimBase* SpawnAnim : SpawnAnimPool)
+	USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(GetWorld());
+	if (PoolSubsystem != nullptr && SpawnAnimClasses.Num() > 0)
 	{
-		if (SpawnAnim != nullptr && !SpawnAnim->IsPoolObjectActive())
-		{
-			InactiveSpawnAnim = SpawnAnim;
-			break;
-		}
-	}
-	if (InactiveSpawnAnim == nullptr)
-	{
-		if (SpawnAnimClasses.Num() > 0)
-		{
-			int32 RandomIndex = FMath::RandRange(0, SpawnAnimClasses.Num() - 1);
-			TSubclassOf<ASpawnAnimBase> SpawnAnimClass = SpawnAnimClasses[RandomIndex];
-			InactiveSpawnAnim = CreateAndAddNewSpawnAnim(SpawnAnimClass);
-		}
+		// Pick a random spawn anim class for variety
+		int32 RandomIndex = FMath::RandRange(0, SpawnAnimClasses.Num() - 1);
+		InactiveSpawnAnim = PoolSubsystem->AcquirePoolActor(SpawnAnimClasses[RandomIndex]);
 	}
 	return InactiveSpawnAnim;
 }
-
-ASpawnAnimBase* USpawnAnimController::CreateAndAddNewSpawnAnim(TSubclassOf<class ASpawnAnimBase> SpawnAnimClass)
-{
-	ASpawnAnimBase* NewSpawnAnim = nullptr;
-	if (SpawnAnimClass != nullptr)
-	{
-		if (UWorld* World = GetWorld())
-		{
-			FActorSpawnParameters SpawnParams;
-			SpawnParams.Name = TEXT("EnemySpawnAnim");
-			SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
-			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-
-			NewSpawnAnim = World->SpawnActor<ASpawnAnimBase>(SpawnAnimClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
-			if (NewSpawnAnim != nullptr)
-			{
-				SpawnAnimPool.Add(NewSpawnAnim);
-			}
-		}
-	}
-	return NewSpawnAnim;
-}
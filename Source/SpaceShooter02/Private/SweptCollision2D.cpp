@@ -0,0 +1,145 @@
+// Copyright 2024 Richard Skala
+
+#include "SweptCollision2D.h"
+
+bool FSweptCollision2D::SweptCircleVsBox(const FVector2D& Start, const FVector2D& Delta, float Radius, const FVector2D& BoxCenter, const FVector2D& BoxHalfExtent, float& OutTime)
+{
+	// Work relative to the box center
+	const FVector2D LocalStart = Start - BoxCenter;
+
+	// Already touching at the start of the movement
+	const FVector2D ClosestPoint(
+		FMath::Clamp(LocalStart.X, -BoxHalfExtent.X, BoxHalfExtent.X),
+		FMath::Clamp(LocalStart.Y, -BoxHalfExtent.Y, BoxHalfExtent.Y));
+	if (FVector2D::DistSquared(LocalStart, ClosestPoint) <= FMath::Square(Radius))
+	{
+		OutTime = 0.0f;
+		return true;
+	}
+
+	// Slab test of the circle's center against the box grown by the radius
+	const FVector2D GrownHalfExtent = BoxHalfExtent + FVector2D(Radius);
+	double EntryTime = 0.0;
+	double ExitTime = 1.0;
+	for (int32 Axis = 0; Axis < 2; ++Axis)
+	{
+		if (FMath::IsNearlyZero(Delta[Axis]))
+		{
+			// Moving parallel to this slab. Misses unless already between its sides.
+			if (FMath::Abs(LocalStart[Axis]) > GrownHalfExtent[Axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		const double InvDelta = 1.0 / Delta[Axis];
+		double SlabEntryTime = (-GrownHalfExtent[Axis] - LocalStart[Axis]) * InvDelta;
+		double SlabExitTime = (GrownHalfExtent[Axis] - LocalStart[Axis]) * InvDelta;
+		if (SlabEntryTime > SlabExitTime)
+		{
+			Swap(SlabEntryTime, SlabExitTime);
+		}
+
+		EntryTime = FMath::Max(EntryTime, SlabEntryTime);
+		ExitTime = FMath::Min(ExitTime, SlabExitTime);
+		if (EntryTime > ExitTime)
+		{
+			return false;
+		}
+	}
+
+	// The grown box has square corners, but the real shape (the box swept by the circle) has rounded ones.
+	// If the center enters beside a corner of the box, it can only touch the box through that corner's circle.
+	const FVector2D EntryPoint = LocalStart + Delta * EntryTime;
+	if (FMath::Abs(EntryPoint.X) > BoxHalfExtent.X && FMath::Abs(EntryPoint.Y) > BoxHalfExtent.Y)
+	{
+		const FVector2D Corner(FMath::Sign(EntryPoint.X) * BoxHalfExtent.X, FMath::Sign(EntryPoint.Y) * BoxHalfExtent.Y);
+		return SegmentVsCircle(LocalStart, Delta, Corner, Radius, OutTime);
+	}
+
+	OutTime = static_cast<float>(EntryTime);
+	return true;
+}
+
+bool FSweptCollision2D::SweptOrientedBoxVsBox(const FVector2D& Start, const FVector2D& Delta, const FVector2D& Forward, const FVector2D& HalfExtent, const FVector2D& BoxCenter, const FVector2D& BoxHalfExtent, float& OutTime)
+{
+	// Separating axis test over the movement. Two boxes only need the face normals of both boxes as axes.
+	// On each axis, find when the projected boxes start and stop overlapping. The boxes touch once they overlap on every axis.
+	const FVector2D Right(Forward.Y, -Forward.X);
+	const FVector2D Axes[] = { FVector2D(1.0, 0.0), FVector2D(0.0, 1.0), Right, Forward };
+	const FVector2D LocalStart = Start - BoxCenter;
+
+	double EntryTime = 0.0;
+	double ExitTime = 1.0;
+	for (const FVector2D& Axis : Axes)
+	{
+		const double Distance = LocalStart.Dot(Axis);
+		const double Speed = Delta.Dot(Axis);
+		const double MovingRadius = HalfExtent.X * FMath::Abs(Right.Dot(Axis)) + HalfExtent.Y * FMath::Abs(Forward.Dot(Axis));
+		const double BoxRadius = BoxHalfExtent.X * FMath::Abs(Axis.X) + BoxHalfExtent.Y * FMath::Abs(Axis.Y);
+		const double CombinedRadius = MovingRadius + BoxRadius;
+
+		if (FMath::IsNearlyZero(Speed))
+		{
+			// Not moving along this axis. Misses unless already overlapping on it.
+			if (FMath::Abs(Distance) > CombinedRadius)
+			{
+				return false;
+			}
+			continue;
+		}
+
+		double AxisEntryTime = (-CombinedRadius - Distance) / Speed;
+		double AxisExitTime = (CombinedRadius - Distance) / Speed;
+		if (AxisEntryTime > AxisExitTime)
+		{
+			Swap(AxisEntryTime, AxisExitTime);
+		}
+
+		EntryTime = FMath::Max(EntryTime, AxisEntryTime);
+		ExitTime = FMath::Min(ExitTime, AxisExitTime);
+		if (EntryTime > ExitTime)
+		{
+			return false;
+		}
+	}
+
+	OutTime = static_cast<float>(EntryTime);
+	return true;
+}
+
+bool FSweptCollision2D::SegmentVsCircle(const FVector2D& Start, const FVector2D& Delta, const FVector2D& Center, float Radius, float& OutTime)
+{
+	// Solve |Start + Delta * t - Center| = Radius for the smallest t in [0, 1]
+	const FVector2D ToStart = Start - Center;
+	const double C = ToStart.SizeSquared() - FMath::Square(Radius);
+	if (C <= 0.0)
+	{
+		OutTime = 0.0f;
+		return true;
+	}
+
+	const double A = Delta.SizeSquared();
+	const double B = ToStart.Dot(Delta);
+	if (A <= UE_SMALL_NUMBER || B >= 0.0)
+	{
+		// Not moving, or moving away from the circle
+		return false;
+	}
+
+	const double Discriminant = B * B - A * C;
+	if (Discriminant < 0.0)
+	{
+		return false;
+	}
+
+	const double Time = (-B - FMath::Sqrt(Discriminant)) / A;
+	if (Time > 1.0)
+	{
+		return false;
+	}
+
+	OutTime = static_cast<float>(Time);
+	return true;
+}
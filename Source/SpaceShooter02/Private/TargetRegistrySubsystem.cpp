@@ -0,0 +1,34 @@
+// Copyright 2024 Richard Skala
+
+#include "TargetRegistrySubsystem.h"
+
+void UTargetRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const int32 PlayerTargetIndex = RegisterTarget();
+	check(PlayerTargetIndex == PLAYER_TARGET_INDEX);
+}
+
+bool UTargetRegistrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UTargetRegistrySubsystem::RegisterTarget()
+{
+	return Targets.AddDefaulted();
+}
+
+void UTargetRegistrySubsystem::PublishTarget(int32 TargetIndex, const FVector& Position, const FVector& Velocity, bool bAlive)
+{
+	if (!ensure(Targets.IsValidIndex(TargetIndex)))
+	{
+		return;
+	}
+
+	FTargetSnapshot& Target = Targets[TargetIndex];
+	Target.Position = Position;
+	Target.Velocity = Velocity;
+	Target.bAlive = bAlive;
+}
@@ -0,0 +1,152 @@
+// Copyright 2024 Richard Skala
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "Tests/AutomationCommon.h"
+
+#include "PlayerShipPawn.h"
+#include "SpaceShooterGameState.h"
+#include "SpaceShooterPoolSubsystem.h"
+
+namespace
+{
+	// The first kills play effects and fill lazily created pools (Niagara world pool, impact effects). They are not counted.
+	static constexpr double FightWarmupSeconds = 5.0;
+	static constexpr double FightSeconds = 60.0;
+
+	// The player ship fires a ring of projectiles, turned a little each volley, so shots sweep the whole arena
+	static constexpr double FightFireIntervalSeconds = 0.1;
+	static constexpr int32 NumFightFirePoints = 8;
+	static constexpr float FightFireTurnDegrees = 7.0f;
+
+	UWorld* FindGameWorld()
+	{
+		if (GEngine != nullptr)
+		{
+			for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+			{
+				if (WorldContext.WorldType == EWorldType::Game || WorldContext.WorldType == EWorldType::PIE)
+				{
+					return WorldContext.World();
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	// Plays a game with an invincible player ship that keeps firing, and fails the test if any frame after the warm-up
+	// creates a UObject (as counted by the pool subsystem's gameplay object creation tracking)
+	class FScriptedFightCommand : public IAutomationLatentCommand
+	{
+	public:
+		explicit FScriptedFightCommand(FAutomationTestBase* InTest)
+			: Test(InTest)
+		{
+		}
+
+		virtual bool Update() override
+		{
+			UWorld* World = FindGameWorld();
+			ASpaceShooterGameState* GameState = World != nullptr ? World->GetGameState<ASpaceShooterGameState>() : nullptr;
+			USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(World);
+			APlayerShipPawn* PlayerShip = World != nullptr ? Cast<APlayerShipPawn>(UGameplayStatics::GetActorOfClass(World, APlayerShipPawn::StaticClass())) : nullptr;
+			if (GameState == nullptr || PoolSubsystem == nullptr || PlayerShip == nullptr)
+			{
+				Test->AddError(TEXT("The game map has no space shooter game state, pool subsystem or player ship"));
+				return true;
+			}
+
+			const double CurrentTimeSeconds = World->GetTimeSeconds();
+			if (FightStartTimeSeconds < 0.0)
+			{
+				PlayerShip->SetPlayerInvincible(true);
+				GameState->StartGame();
+				FightStartTimeSeconds = CurrentTimeSeconds;
+				if (!PoolSubsystem->IsTrackingGameplayObjectCreation())
+				{
+					Test->AddError(TEXT("Gameplay object creation is not tracked. Is bTrackGameplayObjectCreation off?"));
+					return true;
+				}
+				return false;
+			}
+
+			if (!PoolSubsystem->IsTrackingGameplayObjectCreation())
+			{
+				Test->AddError(TEXT("The game ended during the fight"));
+				return true;
+			}
+
+			if (CurrentTimeSeconds - LastFireTimeSeconds >= FightFireIntervalSeconds)
+			{
+				FireVolley(GameState, PlayerShip);
+				LastFireTimeSeconds = CurrentTimeSeconds;
+			}
+
+			const double FightTimeSeconds = CurrentTimeSeconds - FightStartTimeSeconds;
+			if (NumFramesCreatingObjectsAtWarmupEnd == INDEX_NONE)
+			{
+				if (FightTimeSeconds >= FightWarmupSeconds)
+				{
+					NumFramesCreatingObjectsAtWarmupEnd = PoolSubsystem->GetNumGameplayFramesCreatingObjects();
+					NumFramesTrackedAtWarmupEnd = PoolSubsystem->GetNumGameplayFramesTracked();
+				}
+				return false;
+			}
+
+			if (FightTimeSeconds < FightWarmupSeconds + FightSeconds)
+			{
+				return false;
+			}
+
+			const int32 NumFramesTracked = PoolSubsystem->GetNumGameplayFramesTracked() - NumFramesTrackedAtWarmupEnd;
+			const int32 NumFramesCreatingObjects = PoolSubsystem->GetNumGameplayFramesCreatingObjects() - NumFramesCreatingObjectsAtWarmupEnd;
+			Test->AddInfo(FString::Printf(TEXT("%d of %d fight frames created UObjects"), NumFramesCreatingObjects, NumFramesTracked));
+			Test->TestTrue(TEXT("The fight ran for more than one frame"), NumFramesTracked > 1);
+			Test->TestEqual(TEXT("Fight frames that created UObjects"), NumFramesCreatingObjects, 0);
+
+			GameState->EndGame(GameState->GetPlayerScore());
+			PlayerShip->SetPlayerInvincible(false);
+			return true;
+		}
+
+	private:
+		void FireVolley(ASpaceShooterGameState* GameState, APlayerShipPawn* PlayerShip)
+		{
+			FireAngleDegrees = FMath::Fmod(FireAngleDegrees + FightFireTurnDegrees, 360.0f);
+
+			// Projectiles move along their up vector. Pitch turns it around the axis facing the camera.
+			const FVector Position = PlayerShip->GetActorLocation();
+			FireTransforms.Reset();
+			for (int32 i = 0; i < NumFightFirePoints; ++i)
+			{
+				FireTransforms.Add(FTransform(FRotator(FireAngleDegrees + i * 360.0f / NumFightFirePoints, 0.0f, 0.0f), Position));
+			}
+			GameState->FireVolley(FireTransforms, PlayerShip);
+		}
+
+	private:
+		FAutomationTestBase* Test = nullptr;
+		double FightStartTimeSeconds = -1.0;
+		double LastFireTimeSeconds = -1.0;
+		float FireAngleDegrees = 0.0f;
+		int32 NumFramesCreatingObjectsAtWarmupEnd = INDEX_NONE;
+		int32 NumFramesTrackedAtWarmupEnd = 0;
+		TArray<FTransform> FireTransforms;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGameplayObjectCreationTest, "SpaceShooter.Gameplay.NoObjectCreationDuringFight",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+// Runs a scripted 60 second fight on the game map and asserts that no frame of it creates a UObject
+bool FGameplayObjectCreationTest::RunTest(const FString& Parameters)
+{
+	AutomationOpenMap(TEXT("/Game/Maps/GameMap01"));
+	ADD_LATENT_AUTOMATION_COMMAND(FScriptedFightCommand(this));
+	return true;
+}
+#endif // WITH_DEV_AUTOMATION_TESTS
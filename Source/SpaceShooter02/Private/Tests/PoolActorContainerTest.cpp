@@ -0,0 +1,152 @@
+// Copyright 2024 Richard Skala
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Tests/AutomationCommon.h"
+
+#include "PoolActorContainer.h"
+#include "ProjectileCircular.h"
+
+namespace
+{
+	static constexpr int32 NumOccupancyTestPoolActors = 4096;
+	static constexpr int32 NumOccupancyLevels = 5; // 0%, 25%, 50%, 75% and 100%
+	static constexpr int32 NumAcquiresPerRound = 2000;
+	static constexpr int32 NumRoundsPerLevel = 5;
+
+	// Acquiring at any occupancy may cost at most this many times the acquire at 0% occupancy (plus a little slack for
+	// timer noise). A scan of the active list would cost thousands of times more at full occupancy.
+	static constexpr double MaxAcquireCostRatio = 4.0;
+	static constexpr double AcquireCostSlackNanoseconds = 100.0;
+
+	UWorld* FindGameWorld()
+	{
+		if (GEngine != nullptr)
+		{
+			for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+			{
+				if (WorldContext.WorldType == EWorldType::Game || WorldContext.WorldType == EWorldType::PIE)
+				{
+					return WorldContext.World();
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	// Fills a capped pool to each occupancy level and times acquiring (and activating) an actor. Below 100% the actor comes
+	// off the free list and is released again, at 100% the pool recycles its oldest active actor. Fails the test unless
+	// every level costs about the same.
+	class FPoolAcquireOccupancyCommand : public IAutomationLatentCommand
+	{
+	public:
+		explicit FPoolAcquireOccupancyCommand(FAutomationTestBase* InTest)
+			: Test(InTest)
+		{
+		}
+
+		virtual bool Update() override
+		{
+			UWorld* World = FindGameWorld();
+			if (World == nullptr)
+			{
+				Test->AddError(TEXT("No game world to spawn pooled actors in"));
+				return true;
+			}
+
+			FPoolGrowthSettings GrowthSettings;
+			GrowthSettings.GrowthPolicy = EPoolGrowthPolicy::CapAndRecycleOldest;
+			GrowthSettings.MaxPoolSize = NumOccupancyTestPoolActors;
+			GrowthSettings.ShrinkDelaySeconds = 0.0f;
+
+			TPoolActorContainer<APoolActor> Pool;
+			Pool.InitPool(World, TEXT("OccupancyTestPool"), GrowthSettings, FCreatePoolActorDelegate());
+			Pool.SetStartupPoolSize(NumOccupancyTestPoolActors);
+
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			SpawnParameters.ObjectFlags |= RF_Transient;
+			TArray<APoolActor*> PoolActors;
+			for (int32 i = 0; i < NumOccupancyTestPoolActors; ++i)
+			{
+				if (APoolActor* PoolActor = World->SpawnActor<AProjectileCircular>(AProjectileCircular::StaticClass(), FTransform::Identity, SpawnParameters))
+				{
+					Pool.AddPoolActor(PoolActor);
+					PoolActors.Add(PoolActor);
+				}
+			}
+
+			if (Test->TestEqual(TEXT("Pooled actors spawned"), Pool.GetNum(), NumOccupancyTestPoolActors))
+			{
+				TArray<double> AcquireNanoseconds;
+				for (int32 Level = 0; Level < NumOccupancyLevels; ++Level)
+				{
+					const int32 NumActive = NumOccupancyTestPoolActors * Level / (NumOccupancyLevels - 1);
+					while (Pool.GetNumActive() < NumActive)
+					{
+						Pool.Acquire()->ActivatePoolObject();
+					}
+					AcquireNanoseconds.Add(TimeAcquire(Pool));
+					Test->AddInfo(FString::Printf(TEXT("%d%% occupancy: %.1f ns per acquire"), 100 * NumActive / NumOccupancyTestPoolActors, AcquireNanoseconds.Last()));
+				}
+
+				for (int32 Level = 1; Level < NumOccupancyLevels; ++Level)
+				{
+					Test->TestTrue(FString::Printf(TEXT("Acquire at %d%% occupancy costs about the same as at 0%%"), 100 * Level / (NumOccupancyLevels - 1)),
+						AcquireNanoseconds[Level] <= AcquireNanoseconds[0] * MaxAcquireCostRatio + AcquireCostSlackNanoseconds);
+				}
+			}
+
+			// Don't leave the test's actors in the game
+			Pool.ResetPool();
+			Pool.Empty();
+			for (APoolActor* PoolActor : PoolActors)
+			{
+				PoolActor->Destroy();
+			}
+			return true;
+		}
+
+	private:
+		// Best of several rounds, in nanoseconds per acquire. The pool's occupancy is the same afterwards.
+		static double TimeAcquire(TPoolActorContainer<APoolActor>& Pool)
+		{
+			const bool bPoolIsFull = !Pool.HasFreePoolActor();
+			double BestNanoseconds = MAX_dbl;
+			for (int32 Round = 0; Round < NumRoundsPerLevel; ++Round)
+			{
+				const double StartTimeSeconds = FPlatformTime::Seconds();
+				for (int32 i = 0; i < NumAcquiresPerRound; ++i)
+				{
+					APoolActor* PoolActor = Pool.AcquireOrGrow();
+					PoolActor->ActivatePoolObject();
+					if (!bPoolIsFull)
+					{
+						PoolActor->DeactivatePoolObject();
+					}
+				}
+				BestNanoseconds = FMath::Min(BestNanoseconds, (FPlatformTime::Seconds() - StartTimeSeconds) * 1.0e9 / NumAcquiresPerRound);
+			}
+			return BestNanoseconds;
+		}
+
+	private:
+		FAutomationTestBase* Test = nullptr;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoolAcquireOccupancyTest, "SpaceShooter.Pool.AcquireCostIsFlatWithOccupancy",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+// Asserts that acquiring an actor from a capped pool costs the same at 0% to 100% occupancy, including recycling the
+// oldest active actor once the pool is full
+bool FPoolAcquireOccupancyTest::RunTest(const FString& Parameters)
+{
+	AutomationOpenMap(TEXT("/Game/Maps/GameMap01"));
+	ADD_LATENT_AUTOMATION_COMMAND(FPoolAcquireOccupancyCommand(this));
+	return true;
+}
+#endif // WITH_DEV_AUTOMATION_TESTS
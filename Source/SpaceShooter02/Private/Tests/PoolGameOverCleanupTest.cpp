@@ -0,0 +1,174 @@
+// Copyright 2024 Richard Skala
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "Tests/AutomationCommon.h"
+
+#include "PlayerShipPawn.h"
+#include "SpaceShooterGameState.h"
+#include "SpaceShooterPoolSubsystem.h"
+
+namespace
+{
+	static constexpr float CleanupFrameSeconds = 1.0f / 60.0f;
+
+	// Frames to simulate after the game over at most. The amortized reset is spread over the game over delay, which is far shorter.
+	static constexpr int32 MaxCleanupFrames = 600;
+
+	// Time a cleanup frame may take beyond the teardown budget: one batch past the budget check, applying the queued
+	// state changes, and the rest of EndGame on the game over frame
+	static constexpr double CleanupFrameSlackMs = 1.0;
+
+	UWorld* FindGameWorld()
+	{
+		if (GEngine != nullptr)
+		{
+			for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+			{
+				if (WorldContext.WorldType == EWorldType::Game || WorldContext.WorldType == EWorldType::PIE)
+				{
+					return WorldContext.World();
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	// Starts a game, activates every pooled actor and ends the game, then times each frame of the pool cleanup. Fails the
+	// test if the game over frame, or any frame after it, spends much more than the pool subsystem's teardown budget.
+	// Resetting every pool synchronously (as the game over frame used to) is timed too, for comparison.
+	class FGameOverCleanupCommand : public IAutomationLatentCommand
+	{
+	public:
+		explicit FGameOverCleanupCommand(FAutomationTestBase* InTest)
+			: Test(InTest)
+		{
+		}
+
+		virtual bool Update() override
+		{
+			UWorld* World = FindGameWorld();
+			ASpaceShooterGameState* GameState = World != nullptr ? World->GetGameState<ASpaceShooterGameState>() : nullptr;
+			USpaceShooterPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<USpaceShooterPoolSubsystem>(World);
+			APlayerShipPawn* PlayerShip = World != nullptr ? Cast<APlayerShipPawn>(UGameplayStatics::GetActorOfClass(World, APlayerShipPawn::StaticClass())) : nullptr;
+			if (GameState == nullptr || PoolSubsystem == nullptr || PlayerShip == nullptr)
+			{
+				Test->AddError(TEXT("The game map has no space shooter game state, pool subsystem or player ship"));
+				return true;
+			}
+
+			// Starting the game finishes pre-warming, so the pools are full size from the next frame
+			if (!bGameStarted)
+			{
+				PlayerShip->SetPlayerInvincible(true);
+				GameState->StartGame();
+				bGameStarted = true;
+				return false;
+			}
+
+			if (!bGameEnded)
+			{
+				MeasureCleanup(GameState, PoolSubsystem);
+				bGameEnded = true;
+				return false;
+			}
+
+			// Let the game over delay run out, so the game is back at the menu when the test ends
+			if (PoolSubsystem->IsAmortizedResetInProgress())
+			{
+				return false;
+			}
+
+			PlayerShip->SetPlayerInvincible(false);
+			return true;
+		}
+
+	private:
+		void MeasureCleanup(ASpaceShooterGameState* GameState, USpaceShooterPoolSubsystem* PoolSubsystem)
+		{
+			// Before: every pool reset in the game over frame
+			const int32 NumPoolActors = ActivateAllPoolActors(PoolSubsystem);
+			const double SynchronousStartTimeSeconds = FPlatformTime::Seconds();
+			PoolSubsystem->FinishAmortizedReset();
+			PoolSubsystem->FlushPoolObjectStateChanges();
+			const double SynchronousFrameMs = (FPlatformTime::Seconds() - SynchronousStartTimeSeconds) * 1000.0;
+
+			// After: the game over spreads the reset over the following frames. Each simulated frame runs the pool
+			// subsystem's tick and applies the state changes it queued, as the end of a real frame does.
+			ActivateAllPoolActors(PoolSubsystem);
+			double WorstFrameMs = 0.0;
+			int32 NumFrames = 0;
+			while (NumFrames < MaxCleanupFrames && (NumFrames == 0 || GetNumActivePoolActors(PoolSubsystem) > 0))
+			{
+				const double FrameStartTimeSeconds = FPlatformTime::Seconds();
+				if (NumFrames == 0)
+				{
+					GameState->EndGame(GameState->GetPlayerScore());
+				}
+				PoolSubsystem->Tick(CleanupFrameSeconds);
+				PoolSubsystem->FlushPoolObjectStateChanges();
+				WorstFrameMs = FMath::Max(WorstFrameMs, (FPlatformTime::Seconds() - FrameStartTimeSeconds) * 1000.0);
+				++NumFrames;
+			}
+
+			Test->AddInfo(FString::Printf(TEXT("%d pooled actors: synchronous reset %.2f ms, amortized reset worst frame %.2f ms over %d frames"),
+				NumPoolActors, SynchronousFrameMs, WorstFrameMs, NumFrames));
+			Test->TestTrue(TEXT("The pools had active actors at the game over"), NumPoolActors > 0);
+			Test->TestEqual(TEXT("Pooled actors left active after the cleanup frames"), GetNumActivePoolActors(PoolSubsystem), 0);
+			Test->TestTrue(FString::Printf(TEXT("Worst cleanup frame (%.2f ms) is within the teardown budget (%.2f ms)"), WorstFrameMs, PoolSubsystem->GetTeardownFrameBudgetMs()),
+				WorstFrameMs <= PoolSubsystem->GetTeardownFrameBudgetMs() + CleanupFrameSlackMs);
+		}
+
+		// Activates every inactive actor of every pool and returns the number of active actors
+		static int32 ActivateAllPoolActors(USpaceShooterPoolSubsystem* PoolSubsystem)
+		{
+			TArray<TSubclassOf<APoolActor>> PoolActorClasses;
+			PoolSubsystem->ForEachPool<APoolActor>([&PoolActorClasses](TSubclassOf<APoolActor> PoolActorClass, const TPoolActorContainer<APoolActor>& Pool)
+			{
+				PoolActorClasses.Add(PoolActorClass);
+			});
+
+			for (const TSubclassOf<APoolActor>& PoolActorClass : PoolActorClasses)
+			{
+				const FPoolActorContainerBase* Pool = PoolSubsystem->FindPool(PoolActorClass);
+				while (Pool != nullptr && Pool->HasFreePoolActor())
+				{
+					PoolSubsystem->AcquirePoolActor(PoolActorClass)->ActivatePoolObject();
+				}
+			}
+			PoolSubsystem->FlushPoolObjectStateChanges();
+			return GetNumActivePoolActors(PoolSubsystem);
+		}
+
+		static int32 GetNumActivePoolActors(const USpaceShooterPoolSubsystem* PoolSubsystem)
+		{
+			int32 NumActive = 0;
+			PoolSubsystem->ForEachPool<APoolActor>([&NumActive](TSubclassOf<APoolActor> PoolActorClass, const TPoolActorContainer<APoolActor>& Pool)
+			{
+				NumActive += Pool.GetNumActive();
+			});
+			return NumActive;
+		}
+
+	private:
+		FAutomationTestBase* Test = nullptr;
+		bool bGameStarted = false;
+		bool bGameEnded = false;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoolGameOverCleanupTest, "SpaceShooter.Pool.GameOverCleanupWithinBudget",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+// Ends a game with every pool full and asserts that no frame of the pool cleanup goes much over the teardown budget
+bool FPoolGameOverCleanupTest::RunTest(const FString& Parameters)
+{
+	AutomationOpenMap(TEXT("/Game/Maps/GameMap01"));
+	ADD_LATENT_AUTOMATION_COMMAND(FGameOverCleanupCommand(this));
+	return true;
+}
+#endif // WITH_DEV_AUTOMATION_TESTS
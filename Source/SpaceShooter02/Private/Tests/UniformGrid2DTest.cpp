@@ -0,0 +1,161 @@
+// Copyright 2024 Richard Skala
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "UniformGrid2D.h"
+
+namespace
+{
+	static constexpr double GridTestHalfExtent = 1000.0;
+	static constexpr float GridTestCellSize = 100.0f;
+
+	// Random items and queries also fall this far outside the grid bounds, where they are clamped into the edge cells
+	static constexpr double GridTestOutsideMargin = 300.0;
+
+	static constexpr int32 NumGridTestRandomItems = 400;
+	static constexpr int32 NumGridTestRandomQueries = 400;
+
+	// Only the first few mismatches are reported in full
+	static constexpr int32 MaxGridTestMismatchesReported = 10;
+
+	// Positions on cell edges, cell corners and the bounds, where an off-by-one cell lookup would miss items
+	void AddEdgePositions(TArray<FVector2D>& OutPositions)
+	{
+		for (const double X : { -GridTestHalfExtent, -GridTestHalfExtent + GridTestCellSize, -50.0, 0.0, 100.0, 300.0, GridTestHalfExtent - GridTestCellSize, GridTestHalfExtent })
+		{
+			for (const double Y : { -GridTestHalfExtent, 0.0, 200.0, GridTestHalfExtent })
+			{
+				OutPositions.Add(FVector2D(X, Y));
+			}
+		}
+	}
+
+	FVector2D RandomGridTestPosition(FRandomStream& RandomStream)
+	{
+		const double Extent = GridTestHalfExtent + GridTestOutsideMargin;
+		return FVector2D(RandomStream.FRandRange(-Extent, Extent), RandomStream.FRandRange(-Extent, Extent));
+	}
+
+	// Nearest item to Center for which Filter returns true, within MaxDistance, found by testing every item
+	template<typename FilterType>
+	int32 FindNearestBruteForce(TConstArrayView<FVector2D> Positions, const FVector2D& Center, double MaxDistance, FilterType&& Filter)
+	{
+		int32 NearestIndex = INDEX_NONE;
+		double NearestDistanceSquared = MaxDistance * MaxDistance;
+		for (int32 i = 0; i < Positions.Num(); ++i)
+		{
+			const double DistanceSquared = FVector2D::DistSquared(Center, Positions[i]);
+			if (DistanceSquared <= NearestDistanceSquared && Filter(i))
+			{
+				NearestIndex = i;
+				NearestDistanceSquared = DistanceSquared;
+			}
+		}
+		return NearestIndex;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUniformGrid2DTest, "SpaceShooter.UniformGrid2D.MatchesBruteForce",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Checks every circle and nearest query of the enemy grid against the same query run over every item, with items and
+// queries inside the bounds, outside them and on cell edges
+bool FUniformGrid2DTest::RunTest(const FString& Parameters)
+{
+	FRandomStream RandomStream(2024);
+
+	TArray<FVector2D> Positions;
+	AddEdgePositions(Positions);
+	for (int32 i = 0; i < NumGridTestRandomItems; ++i)
+	{
+		Positions.Add(RandomGridTestPosition(RandomStream));
+	}
+
+	// Items of different sizes, so the grid has to widen its searches by the largest radius
+	TArray<float> Radii;
+	for (int32 i = 0; i < Positions.Num(); ++i)
+	{
+		Radii.Add(RandomStream.FRandRange(5.0f, 80.0f));
+	}
+
+	TArray<FVector2D> QueryPositions;
+	AddEdgePositions(QueryPositions);
+	for (int32 i = 0; i < NumGridTestRandomQueries; ++i)
+	{
+		QueryPositions.Add(RandomGridTestPosition(RandomStream));
+	}
+
+	FUniformGrid2D Grid;
+	Grid.Init(FBox2D(FVector2D(-GridTestHalfExtent), FVector2D(GridTestHalfExtent)), GridTestCellSize);
+	Grid.Build(Positions, Radii);
+	TestEqual(TEXT("Items in the grid"), Grid.GetNumItems(), Positions.Num());
+
+	auto AcceptAll = [](int32) { return true; };
+	auto AcceptEven = [](int32 ItemIndex) { return ItemIndex % 2 == 0; };
+
+	int32 NumMismatches = 0;
+	auto ReportMismatch = [this, &NumMismatches](const FString& Message)
+	{
+		if (++NumMismatches <= MaxGridTestMismatchesReported)
+		{
+			AddError(Message);
+		}
+	};
+
+	for (const FVector2D& QueryPosition : QueryPositions)
+	{
+		for (const float QueryRadius : { 0.0f, 30.0f, 150.0f })
+		{
+			TArray<int32> GridItems;
+			Grid.ForEachInRadius(QueryPosition, QueryRadius, [&GridItems](int32 ItemIndex) { GridItems.Add(ItemIndex); });
+			GridItems.Sort();
+
+			TArray<int32> BruteForceItems;
+			for (int32 i = 0; i < Positions.Num(); ++i)
+			{
+				const double MaxDistance = QueryRadius + Radii[i];
+				if (FVector2D::DistSquared(QueryPosition, Positions[i]) <= MaxDistance * MaxDistance)
+				{
+					BruteForceItems.Add(i);
+				}
+			}
+
+			if (GridItems != BruteForceItems)
+			{
+				ReportMismatch(FString::Printf(TEXT("ForEachInRadius(%s, %.0f) found %d items, brute force found %d"),
+					*QueryPosition.ToString(), QueryRadius, GridItems.Num(), BruteForceItems.Num()));
+			}
+		}
+
+		for (const double MaxDistance : { 50.0, 250.0, 5000.0 })
+		{
+			// Either of two items at the same distance is a correct answer, so the distances are compared
+			auto CheckNearest = [this, &Grid, &Positions, &QueryPosition, MaxDistance, &ReportMismatch](const TCHAR* FilterName, int32 GridIndex, int32 BruteForceIndex)
+			{
+				const bool bSameDistance = GridIndex != INDEX_NONE && BruteForceIndex != INDEX_NONE
+					&& FVector2D::DistSquared(QueryPosition, Positions[GridIndex]) == FVector2D::DistSquared(QueryPosition, Positions[BruteForceIndex]);
+				if (GridIndex != BruteForceIndex && !bSameDistance)
+				{
+					ReportMismatch(FString::Printf(TEXT("FindNearest(%s, %.0f, %s) returned item %d, brute force returned item %d"),
+						*QueryPosition.ToString(), MaxDistance, FilterName, GridIndex, BruteForceIndex));
+				}
+			};
+
+			CheckNearest(TEXT("all items"), Grid.FindNearest(QueryPosition, MaxDistance, AcceptAll), FindNearestBruteForce(Positions, QueryPosition, MaxDistance, AcceptAll));
+			CheckNearest(TEXT("even items"), Grid.FindNearest(QueryPosition, MaxDistance, AcceptEven), FindNearestBruteForce(Positions, QueryPosition, MaxDistance, AcceptEven));
+		}
+	}
+
+	TestEqual(TEXT("Grid queries that differ from brute force"), NumMismatches, 0);
+
+	// An empty grid finds nothing
+	Grid.Reset();
+	int32 NumFoundInEmptyGrid = 0;
+	Grid.ForEachInRadius(FVector2D::ZeroVector, 1000.0f, [&NumFoundInEmptyGrid](int32) { ++NumFoundInEmptyGrid; });
+	TestEqual(TEXT("Items found in an empty grid"), NumFoundInEmptyGrid, 0);
+	TestEqual(TEXT("Nearest item in an empty grid"), Grid.FindNearest(FVector2D::ZeroVector, 1000.0, AcceptAll), static_cast<int32>(INDEX_NONE));
+
+	return true;
+}
+#endif // WITH_DEV_AUTOMATION_TESTS
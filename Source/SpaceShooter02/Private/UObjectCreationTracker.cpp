@@ -0,0 +1,58 @@
+// Copyright 2024 Richard Skala
+
+#include "UObjectCreationTracker.h"
+
+int32 FUObjectCreationTracker::IgnoreDepth = 0;
+
+FUObjectCreationTracker::~FUObjectCreationTracker()
+{
+	Stop();
+}
+
+void FUObjectCreationTracker::Start()
+{
+	check(IsInGameThread());
+	if (!bTracking)
+	{
+		NumCreated = 0;
+		NumCreatedPerClass.Reset();
+		GUObjectArray.AddUObjectCreateListener(this);
+		bTracking = true;
+	}
+}
+
+void FUObjectCreationTracker::Stop()
+{
+	if (bTracking)
+	{
+		GUObjectArray.RemoveUObjectCreateListener(this);
+		bTracking = false;
+	}
+}
+
+void FUObjectCreationTracker::GetNumCreatedPerClass(TArray<TPair<FName, int32>>& OutNumCreatedPerClass) const
+{
+	OutNumCreatedPerClass = NumCreatedPerClass.Array();
+	OutNumCreatedPerClass.Sort([](const TPair<FName, int32>& A, const TPair<FName, int32>& B) { return A.Value > B.Value; });
+}
+
+void FUObjectCreationTracker::NotifyUObjectCreated(const UObjectBase* Object, int32 Index)
+{
+	if (IgnoreDepth > 0 && IsInGameThread())
+	{
+		return;
+	}
+
+	NumCreated.fetch_add(1, std::memory_order_relaxed);
+
+	// Objects can also be created by async loading. Only the game thread touches the per-class counts.
+	if (IsInGameThread() && Object != nullptr && Object->GetClass() != nullptr)
+	{
+		NumCreatedPerClass.FindOrAdd(Object->GetClass()->GetFName())++;
+	}
+}
+
+void FUObjectCreationTracker::OnUObjectArrayShutdown()
+{
+	Stop();
+}
@@ -0,0 +1,187 @@
+// Copyright 2024 Richard Skala
+
+#include "UniformGrid2D.h"
+
+#include "HAL/IConsoleManager.h"
+
+#include "SpaceShooterBenchmark.h"
+
+namespace
+{
+	// Keeps a badly sized grid from allocating huge cell arrays
+	static constexpr int32 MaxNumCellsPerAxis = 1024;
+}
+
+void FUniformGrid2D::Init(const FBox2D& InBounds, float InCellSize)
+{
+	if (!ensure(InBounds.bIsValid && InCellSize > 0.0f))
+	{
+		return;
+	}
+
+	Bounds = InBounds;
+	const FVector2D Size = Bounds.GetSize();
+	NumCellsX = FMath::Clamp(FMath::CeilToInt32(Size.X / InCellSize), 1, MaxNumCellsPerAxis);
+	NumCellsY = FMath::Clamp(FMath::CeilToInt32(Size.Y / InCellSize), 1, MaxNumCellsPerAxis);
+
+	// Cells are square. If an axis was clamped, grow the cells to still cover the bounds.
+	const double CellSize = FMath::Max3(static_cast<double>(InCellSize), Size.X / NumCellsX, Size.Y / NumCellsY);
+	InvCellSize = 1.0 / CellSize;
+
+	Reset();
+}
+
+void FUniformGrid2D::Reset()
+{
+	CellStarts.Reset();
+	CellStarts.SetNumZeroed(NumCellsX * NumCellsY + 1);
+	CellItems.Reset();
+	ItemCells.Reset();
+	ItemPositions.Reset();
+	ItemRadii.Reset();
+	MaxItemRadius = 0.0f;
+}
+
+void FUniformGrid2D::Build(TConstArrayView<FVector2D> Positions, TConstArrayView<float> Radii)
+{
+	if (!ensure(IsInitialized()) || !ensure(Positions.Num() == Radii.Num()))
+	{
+		return;
+	}
+
+	Reset();
+
+	const int32 NumItems = Positions.Num();
+	ItemPositions.Append(Positions.GetData(), NumItems);
+	ItemRadii.Append(Radii.GetData(), NumItems);
+
+	// Count the items in each cell. CellStarts[i + 1] holds the count of cell i for now.
+	ItemCells.SetNumUninitialized(NumItems);
+	for (int32 ItemIndex = 0; ItemIndex < NumItems; ++ItemIndex)
+	{
+		const int32 CellIndex = GetCellY(Positions[ItemIndex].Y) * NumCellsX + GetCellX(Positions[ItemIndex].X);
+		ItemCells[ItemIndex] = CellIndex;
+		++CellStarts[CellIndex + 1];
+		MaxItemRadius = FMath::Max(MaxItemRadius, Radii[ItemIndex]);
+	}
+
+	// Turn the counts into start offsets
+	for (int32 CellIndex = 1; CellIndex < CellStarts.Num(); ++CellIndex)
+	{
+		CellStarts[CellIndex] += CellStarts[CellIndex - 1];
+	}
+
+	// Place each item. Uses the start of the next cell as a write cursor, which ends up at this cell's start.
+	CellItems.SetNumUninitialized(NumItems);
+	for (int32 ItemIndex = NumItems - 1; ItemIndex >= 0; --ItemIndex)
+	{
+		CellItems[--CellStarts[ItemCells[ItemIndex] + 1]] = ItemIndex;
+	}
+
+	// Every cursor now holds the start of its own cell shifted by one slot. Shift them back.
+	for (int32 CellIndex = 0; CellIndex < CellStarts.Num() - 1; ++CellIndex)
+	{
+		CellStarts[CellIndex] = CellStarts[CellIndex + 1];
+	}
+	CellStarts.Last() = NumItems;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	static constexpr int32 NumBenchmarkQueries = 1000;
+	static constexpr float BenchmarkEnemyRadius = 50.0f;
+	static constexpr float BenchmarkCellSize = 200.0f;
+
+	// Radius of the circle queries, about the size of a projectile's sweep in one frame
+	static constexpr float BenchmarkQueryRadius = 100.0f;
+	static constexpr double BenchmarkNearestDistance = 2000.0;
+
+	// Builds a grid of random enemies over the arena and times its build, circle queries and nearest queries at 1k, 5k
+	// and 20k enemies, against the same queries run by brute force. Every grid result is checked against brute force.
+	void RunEnemyGridBenchmark()
+	{
+		FSpaceShooterBenchmark Benchmark;
+		FUniformGrid2D EnemyGrid;
+		EnemyGrid.Init(FSpaceShooterBenchmark::GetArenaBounds(), BenchmarkCellSize);
+
+		TArray<FVector2D> QueryPositions;
+		for (int32 i = 0; i < NumBenchmarkQueries; ++i)
+		{
+			QueryPositions.Add(Benchmark.RandomPosition());
+		}
+
+		for (const int32 NumEnemies : { 1000, 5000, 20000 })
+		{
+			TArray<FVector2D> Positions;
+			TArray<float> Radii;
+			for (int32 i = 0; i < NumEnemies; ++i)
+			{
+				Positions.Add(Benchmark.RandomPosition());
+				Radii.Add(BenchmarkEnemyRadius);
+			}
+
+			const double BuildMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([&EnemyGrid, &Positions, &Radii]()
+			{
+				EnemyGrid.Build(Positions, Radii);
+			});
+
+			TArray<int32> GridNumInRadius;
+			TArray<int32> GridNearest;
+			const double GridQueryMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([&EnemyGrid, &QueryPositions, &GridNumInRadius, &GridNearest]()
+			{
+				for (const FVector2D& QueryPosition : QueryPositions)
+				{
+					int32 NumInRadius = 0;
+					EnemyGrid.ForEachInRadius(QueryPosition, BenchmarkQueryRadius, [&NumInRadius](int32) { ++NumInRadius; });
+					GridNumInRadius.Add(NumInRadius);
+					GridNearest.Add(EnemyGrid.FindNearest(QueryPosition, BenchmarkNearestDistance, [](int32) { return true; }));
+				}
+			});
+
+			TArray<int32> BruteForceNumInRadius;
+			TArray<int32> BruteForceNearest;
+			const double BruteForceQueryMilliseconds = FSpaceShooterBenchmark::TimeMilliseconds([&Positions, &Radii, &QueryPositions, &BruteForceNumInRadius, &BruteForceNearest]()
+			{
+				for (const FVector2D& QueryPosition : QueryPositions)
+				{
+					int32 NumInRadius = 0;
+					int32 NearestIndex = INDEX_NONE;
+					double NearestDistanceSquared = BenchmarkNearestDistance * BenchmarkNearestDistance;
+					for (int32 i = 0; i < Positions.Num(); ++i)
+					{
+						const double DistanceSquared = FVector2D::DistSquared(QueryPosition, Positions[i]);
+						const double MaxInRadiusDistance = BenchmarkQueryRadius + Radii[i];
+						NumInRadius += DistanceSquared <= MaxInRadiusDistance * MaxInRadiusDistance ? 1 : 0;
+						if (DistanceSquared <= NearestDistanceSquared)
+						{
+							NearestIndex = i;
+							NearestDistanceSquared = DistanceSquared;
+						}
+					}
+					BruteForceNumInRadius.Add(NumInRadius);
+					BruteForceNearest.Add(NearestIndex);
+				}
+			});
+
+			// Nearest enemies are compared by distance, as both searches may pick either of two enemies at the same distance
+			int32 NumMismatches = 0;
+			for (int32 i = 0; i < NumBenchmarkQueries; ++i)
+			{
+				const bool bSameNearest = GridNearest[i] == BruteForceNearest[i]
+					|| (GridNearest[i] != INDEX_NONE && BruteForceNearest[i] != INDEX_NONE
+						&& FVector2D::DistSquared(QueryPositions[i], Positions[GridNearest[i]]) == FVector2D::DistSquared(QueryPositions[i], Positions[BruteForceNearest[i]]));
+				NumMismatches += GridNumInRadius[i] != BruteForceNumInRadius[i] || !bSameNearest ? 1 : 0;
+			}
+
+			UE_LOG(LogSpaceShooterBenchmark, Log, TEXT("%d enemies: grid build %.3f ms (%.1f ns per enemy), %d queries %.3f ms on the grid vs %.3f ms brute force, %d results differ from brute force"),
+				NumEnemies, BuildMilliseconds, BuildMilliseconds * 1.0e6 / NumEnemies, NumBenchmarkQueries, GridQueryMilliseconds, BruteForceQueryMilliseconds, NumMismatches);
+		}
+	}
+}
+
+static FAutoConsoleCommand BenchmarkEnemyGridCommand(
+	TEXT("SpaceShooter.BenchmarkEnemyGrid"),
+	TEXT("Times the enemy grid build, circle queries and nearest queries for 1000, 5000 and 20000 enemies, and checks them against brute force"),
+	FConsoleCommandDelegate::CreateStatic(&RunEnemyGridBenchmark));
+#endif // !UE_BUILD_SHIPPING
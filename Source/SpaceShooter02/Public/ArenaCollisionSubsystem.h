@@ -0,0 +1,64 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ArenaCollisionSubsystem.generated.h"
+
+// Result of a segment query against the arena
+struct FArenaHit
+{
+	// Index of the segment in a batched query
+	int32 SegmentIndex = INDEX_NONE;
+
+	// Fraction of the segment travelled before the hit (0.0 - 1.0)
+	float Time = 0.0f;
+
+	FVector ImpactPoint = FVector::ZeroVector;
+	FVector ImpactNormal = FVector::ZeroVector;
+};
+
+// Answers collision queries against the arena walls without going through the physics scene.
+// The level border boxes are cached once when the world begins play, and segments and points are tested against them
+// analytically on the XZ plane (the plane the game is played on).
+UCLASS()
+class SPACESHOOTER02_API UArenaCollisionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// UWorldSubsystem Begin
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// UWorldSubsystem End
+
+	// Caches the level border boxes. Called when the world begins play.
+	void CacheArenaGeometry();
+
+	// Whether the point is inside the arena bounds and outside every level border
+	bool IsPointInArena(const FVector& Point) const;
+
+	// Finds the earliest point where the segment enters a level border. Returns false if it does not hit one.
+	bool SegmentVsArena(const FVector& Start, const FVector& End, FArenaHit& OutHit) const;
+
+	// Batched SegmentVsArena. Appends a hit (with its SegmentIndex) for every segment that hits a level border.
+	// Starts and Ends must be the same length. Returns the number of hits.
+	int32 SegmentsVsArena(TConstArrayView<FVector> Starts, TConstArrayView<FVector> Ends, TArray<FArenaHit>& OutHits) const;
+
+	// Batched IsPointInArena. Appends the index of every point that is outside the arena. Returns the number of points outside.
+	int32 PointsOutsideArena(TConstArrayView<FVector> Points, TArray<int32>& OutPointIndices) const;
+
+	const FBox& GetArenaBounds() const { return ArenaBounds; }
+
+private:
+	// Slab test of a segment against a box on the XZ plane. Returns false if the segment misses the box.
+	static bool SegmentVsBox(const FVector& Start, const FVector& Delta, const FBox& Box, float& OutTime, FVector& OutNormal);
+
+private:
+	// World space bounds of every level border
+	TArray<FBox> BorderBoxes;
+
+	// Box enclosing every level border. The level bounding box if there are no level borders. Invalid if there is neither.
+	FBox ArenaBounds = FBox(ForceInit);
+};
@@ -0,0 +1,156 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "BulletPatternAsset.generated.h"
+
+UENUM(BlueprintType)
+enum class EBulletPatternShape : uint8
+{
+	// Bullets spread evenly around a full circle
+	Ring,
+
+	// Bullets fired one after another, each turned a little further than the last
+	Spiral,
+
+	// Bullets spread across an arc centered on the direction to the player
+	AimedBurst,
+};
+
+// One step of a bullet pattern, as authored. Steps are played one after another.
+USTRUCT(BlueprintType)
+struct FBulletPatternStep
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	EBulletPatternShape Shape = EBulletPatternShape::Ring;
+
+	// Ring: bullets per ring. Spiral: bullets per spiral. Aimed burst: bullets per burst.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "1"))
+	int32 NumBullets = 12;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	float BulletSpeed = 400.0f;
+
+	// Direction of the first bullet in degrees, clockwise from the top of the screen. Aimed bursts are relative to the
+	// direction to the player.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float AngleOffsetDegrees = 0.0f;
+
+	// Aimed burst: arc the bullets are spread across
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", ClampMax = "360", EditCondition = "Shape == EBulletPatternShape::AimedBurst"))
+	float SpreadDegrees = 30.0f;
+
+	// Ring: turn of each repetition from the last. Spiral: turn of each bullet from the last.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (EditCondition = "Shape != EBulletPatternShape::AimedBurst"))
+	float AngleStepDegrees = 15.0f;
+
+	// Spiral: time between consecutive bullets
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", EditCondition = "Shape == EBulletPatternShape::Spiral", Units = "Seconds"))
+	float BulletIntervalSeconds = 0.05f;
+
+	// Number of times this step is fired
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "1"))
+	int32 Repetitions = 1;
+
+	// Time between repetitions
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", Units = "Seconds"))
+	float RepeatIntervalSeconds = 0.5f;
+
+	// Time after the last bullet of this step before the next step starts
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", Units = "Seconds"))
+	float DelayAfterSeconds = 1.0f;
+};
+
+// One bullet of a compiled bullet pattern
+struct FBulletSpawnInstruction
+{
+	// Time since the start of the pattern
+	float TimeSeconds = 0.0f;
+
+	// Direction in radians, clockwise from the top of the screen, or from the direction to the player if aimed
+	float AngleRadians = 0.0f;
+
+	float Speed = 0.0f;
+	bool bAimed = false;
+};
+
+// Bullet pattern fired by enemies (see AEnemyShooter).
+// The authored steps are compiled into a flat table of spawn instructions (one per bullet, sorted by time) when the asset
+// is loaded or edited, so playing a pattern is a single cursor walking the table.
+UCLASS(BlueprintType)
+class SPACESHOOTER02_API UBulletPatternAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	// Rebuilds the instruction table from the steps
+	void CompilePattern();
+
+	TConstArrayView<FBulletSpawnInstruction> GetInstructions() const { return Instructions; }
+	float GetPatternDurationSeconds() const { return PatternDurationSeconds; }
+	bool IsLooping() const { return bLoop; }
+
+private:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	TArray<FBulletPatternStep> Steps;
+
+	// If true, the pattern starts over once its last step is done
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	bool bLoop = true;
+
+	// Compiled from Steps. Sorted by time.
+	TArray<FBulletSpawnInstruction> Instructions;
+
+	// Time from the start of the pattern until it starts over (if looping)
+	float PatternDurationSeconds = 0.0f;
+};
+
+// Playback state of a bullet pattern. Kept by each emitter, while the pattern asset is shared.
+struct FBulletPatternPlayer
+{
+	float TimeSeconds = 0.0f;
+	int32 NextInstructionIndex = 0;
+
+	void Reset()
+	{
+		TimeSeconds = 0.0f;
+		NextInstructionIndex = 0;
+	}
+
+	// Advances the pattern and calls Function(Instruction) for every bullet due this frame
+	template<typename FunctionType>
+	void Advance(const UBulletPatternAsset& Pattern, float DeltaTime, FunctionType&& Function)
+	{
+		const TConstArrayView<FBulletSpawnInstruction> Instructions = Pattern.GetInstructions();
+		if (Instructions.Num() == 0)
+		{
+			return;
+		}
+
+		TimeSeconds += DeltaTime;
+		for (;;)
+		{
+			while (NextInstructionIndex < Instructions.Num() && Instructions[NextInstructionIndex].TimeSeconds <= TimeSeconds)
+			{
+				Function(Instructions[NextInstructionIndex++]);
+			}
+
+			// Start over once every bullet was fired and the pattern's duration has passed
+			if (NextInstructionIndex < Instructions.Num() || !Pattern.IsLooping() || TimeSeconds < Pattern.GetPatternDurationSeconds())
+			{
+				break;
+			}
+			TimeSeconds -= Pattern.GetPatternDurationSeconds();
+			NextInstructionIndex = 0;
+		}
+	}
+};
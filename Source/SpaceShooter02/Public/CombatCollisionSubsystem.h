@@ -0,0 +1,168 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "EnemySteering.h"
+#include "ProjectileShapeKernels.h"
+#include "UniformGrid2D.h"
+
+#include "CombatCollisionSubsystem.generated.h"
+
+class AEnemyBase;
+class APlayerShipPawn;
+class AProjectileBase;
+class AProjectileManager;
+struct FEnemyFlockingSettings;
+
+// Enemy touched by a swept circle
+struct FEnemySweepHit
+{
+	// Index into the grid enemies
+	int32 EnemyIndex = INDEX_NONE;
+
+	// Fraction of the movement travelled before the hit (0.0 - 1.0)
+	float Time = 0.0f;
+};
+
+// Resolves projectile vs enemy hits without physics overlaps.
+// Once per frame, after every actor has moved, the collidable enemies are bucketed into a uniform grid over the arena.
+// Every projectile (pooled projectile actors and projectile managers) is then swept along this frame's movement against
+// the enemies' bounding boxes, and the resulting hit list is resolved in one pass, earliest hits first.
+// Projectiles are sorted into one batch per collision shape, and each batch is swept by a kernel specialized for its shape.
+// The dashing player ship is swept the same way, so neither fast projectiles nor dashes can pass through enemies.
+// The same grid answers the neighbour searches of enemy flocking, whose steering the enemies apply on the next frame.
+// Enemy bullets (projectile managers that target the player) are tested against the player ship only.
+// The grid cell size is read from the [/Script/SpaceShooter02.CombatCollisionSubsystem] section of DefaultGame.ini.
+UCLASS(config = Game)
+class SPACESHOOTER02_API UCombatCollisionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// UTickableWorldSubsystem Begin
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatCollisionSubsystem, STATGROUP_Tickables);
+	}
+	// UTickableWorldSubsystem End
+
+	// Projectile managers are queried along with the pooled projectiles
+	void RegisterProjectileManager(AProjectileManager* ProjectileManager);
+	void UnregisterProjectileManager(AProjectileManager* ProjectileManager);
+
+	// Player ship whose dash is swept against enemies
+	void SetPlayerShip(APlayerShipPawn* InPlayerShip) { PlayerShip = InPlayerShip; }
+
+	// Sweeps a circle from Start to End against the bounding boxes of the grid enemies. Appends a hit, with its time of
+	// impact, for every enemy it touches. Hits are not sorted. Returns the number of hits.
+	int32 SweepCircleVsEnemies(const FVector& Start, const FVector& End, float Radius, TArray<FEnemySweepHit>& OutHits) const;
+
+	// Nearest enemy to Position that is still active, within MaxDistance. Returns nullptr if there is none.
+	// Reads the grid built at the end of the last frame, so it can be called from any actor tick.
+	AEnemyBase* FindNearestEnemy(const FVector& Position, float MaxDistance) const;
+
+	// Batched FindNearestEnemy, run in parallel over the positions. OutEnemies must be the same length as Positions.
+	void FindNearestEnemies(TConstArrayView<FVector> Positions, float MaxDistance, TArrayView<AEnemyBase*> OutEnemies) const;
+
+	// Queued FindNearestEnemies, for callers that gather their query positions in a loop (e.g. a pool batch tick).
+	// Add every position, run the queries, then read each result with the index AddNearestEnemyQuery returned.
+	// Results are raw enemy pointers, so the caller resets the queries once it has read them.
+	void ResetNearestEnemyQueries();
+	int32 AddNearestEnemyQuery(const FVector& Position) { return NearestEnemyQueryPositions.Add(Position); }
+	int32 GetNumNearestEnemyQueries() const { return NearestEnemyQueryPositions.Num(); }
+	void RunNearestEnemyQueries(float MaxDistance);
+	AEnemyBase* GetNearestEnemyQueryResult(int32 QueryIndex) const { return NearestEnemyQueryResults[QueryIndex]; }
+
+	// Scratch arrays of the batched enemy steering. The caller resets them once the enemies have been written back.
+	FEnemySteeringArrays& GetEnemySteeringArrays() { return EnemySteering; }
+
+private:
+	// Buckets every collidable enemy into the grid
+	void RebuildEnemyGrid();
+
+	// Computes the flocking steering of every grid enemy whose class has flocking enabled
+	void UpdateEnemyFlocking();
+
+	// Sweeps every projectile against the grid, then resolves the hits
+	void ResolveProjectileHits();
+
+	// Sweeps the player ship against the grid while it is dashing, then resolves the hits
+	void ResolveDashHits();
+
+	// Tests every enemy bullet against the player ship in one pass, and resolves the hits
+	void ResolveEnemyBulletHits();
+
+	// Sorts every pooled and managed projectile into the batch of its collision shape
+	void GatherProjectileBatches();
+
+	// Appends a hit for every enemy touched by a projectile of the batch. Returns the number of hit tests run.
+	template<typename ShapeType>
+	int32 SweepProjectileBatch(const TProjectileBatch<ShapeType>& Batch);
+
+	// Calls Function(EnemyIndex, Time) for every grid enemy the swept shape touches. Returns the number of hit tests run.
+	template<typename ShapeType, typename FunctionType>
+	int32 ForEachEnemySweepHit(const ShapeType& Shape, const FVector2D& Start, const FVector2D& Delta, FunctionType&& Function) const;
+
+	// Sizes the grid to the arena. Returns false if the arena is not known yet.
+	bool InitEnemyGrid();
+
+private:
+	FUniformGrid2D EnemyGrid;
+
+	// Side of a grid cell (world units, at least 10). Should be a bit larger than an enemy.
+	UPROPERTY(Config)
+	float EnemyGridCellSize = 200.0f;
+
+	TArray<TWeakObjectPtr<AProjectileManager>> ProjectileManagers;
+
+	TWeakObjectPtr<APlayerShipPawn> PlayerShip;
+
+	// --- Scratch Arrays (kept to avoid reallocating every frame) ---
+
+	// Enemies in the grid. Grid item i is GridEnemies[i].
+	TArray<AEnemyBase*> GridEnemies;
+	TArray<FVector2D> EnemyPositions;
+	TArray<FVector2D> EnemyHalfExtents;
+	TArray<float> EnemyRadii;
+	TArray<FVector2D> EnemyVelocities;
+	TArray<const FEnemyFlockingSettings*> EnemyFlockingSettings;
+	TArray<FVector2D> EnemyFlockingSteering;
+
+	TArray<AProjectileBase*> PooledProjectiles;
+
+	// Projectiles simulated by one projectile manager. Projectile index FirstProjectileIndex + i is the manager's projectile i.
+	struct FManagedProjectileRange
+	{
+		AProjectileManager* ProjectileManager = nullptr;
+		int32 FirstProjectileIndex = 0;
+	};
+	TArray<FManagedProjectileRange> ManagedProjectileRanges;
+
+	// Projectiles of each collision shape. ProjectileIndices below the number of PooledProjectiles index PooledProjectiles.
+	// The rest belong to the projectile manager whose range they fall in.
+	TProjectileBatch<FCircleProjectileShape> CircleProjectiles;
+	TProjectileBatch<FOrientedBoxProjectileShape> OrientedBoxProjectiles;
+
+	// Projectile vs enemy hits found this frame. ProjectileIndex is indexed the same way as the batches' ProjectileIndices.
+	struct FProjectileHit
+	{
+		int32 ProjectileIndex = INDEX_NONE;
+		int32 EnemyIndex = INDEX_NONE;
+		float Time = 0.0f;
+	};
+	TArray<FProjectileHit> ProjectileHits;
+
+	// Hits of a single sweep
+	TArray<FEnemySweepHit> SweepHits;
+
+	// Queued nearest enemy queries. Result i is the nearest enemy to position i.
+	TArray<FVector> NearestEnemyQueryPositions;
+	TArray<AEnemyBase*> NearestEnemyQueryResults;
+
+	FEnemySteeringArrays EnemySteering;
+};
@@ -0,0 +1,120 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "EnemyArchetypeTable.generated.h"
+
+UENUM(BlueprintType)
+enum class EEnemyBehaviourKind : uint8
+{
+	// Steers straight at the target
+	Chase,
+
+	// Closes in to the orbit radius, then circles the target
+	Orbit,
+
+	// Chases the target, veering from one side to the other
+	ZigZag,
+
+	// Approaches the target, then charges along its heading in short bursts
+	DashAt,
+
+	NumBehaviourKinds UMETA(Hidden)
+};
+
+// How an enemy moves towards its target. Every enemy of a pool is moved by one loop per behaviour kind.
+USTRUCT(BlueprintType)
+struct FEnemyBehaviourSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	EEnemyBehaviourKind Kind = EEnemyBehaviourKind::Chase;
+
+	// How quickly the enemy can change direction. Zero turns instantly.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	float TurnRateDegreesPerSecond = 0.0f;
+
+	// Distance kept from the target while circling it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", EditCondition = "Kind == EEnemyBehaviourKind::Orbit"))
+	float OrbitRadius = 400.0f;
+
+	// Angle veered away from the target, to either side
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", ClampMax = "90", EditCondition = "Kind == EEnemyBehaviourKind::ZigZag"))
+	float ZigZagAngleDegrees = 45.0f;
+
+	// Time to veer to one side and back to the other
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", EditCondition = "Kind == EEnemyBehaviourKind::ZigZag", Units = "Seconds"))
+	float ZigZagPeriodSeconds = 1.0f;
+
+	// Move speed multiplier while charging
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", EditCondition = "Kind == EEnemyBehaviourKind::DashAt"))
+	float DashSpeedMultiplier = 4.0f;
+
+	// Time from the start of one charge to the start of the next
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", EditCondition = "Kind == EEnemyBehaviourKind::DashAt", Units = "Seconds"))
+	float DashIntervalSeconds = 2.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0", EditCondition = "Kind == EEnemyBehaviourKind::DashAt", Units = "Seconds"))
+	float DashDurationSeconds = 0.35f;
+};
+
+// One enemy type, as authored in an archetype table
+USTRUCT(BlueprintType)
+struct FEnemyArchetype
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	FName Name;
+
+	// Pooled actor the archetype is spawned as. Archetypes of the same class share its pool and its batch tick.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TSubclassOf<class AEnemyBase> EnemyClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	float MoveSpeed = 1000.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	FEnemyBehaviourSettings Behaviour;
+
+	// Number of projectile hits the enemy takes before it is destroyed. A dash always destroys it.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "1"))
+	int32 HitPoints = 1;
+
+	// Score for destroying the enemy, before the score multiplier
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	int32 ScoreValue = 1;
+
+	// Replaces the enemy class's sprite. Leave empty to keep it.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TObjectPtr<class UPaperSprite> Sprite;
+
+	// The archetype only spawns from this difficulty level on
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "1"))
+	int32 MinDifficultyLevel = 1;
+
+	// Chance of spawning, relative to the other archetypes that can spawn
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	float SpawnWeight = 1.0f;
+};
+
+// Enemy types the enemy pool controller spawns from. New enemy types are new rows rather than new enemy classes, so they
+// add no tick functions: enemies of every archetype sharing a class are moved together by that class's batch tick.
+UCLASS(BlueprintType)
+class SPACESHOOTER02_API UEnemyArchetypeTable : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	TConstArrayView<FEnemyArchetype> GetArchetypes() const { return Archetypes; }
+
+	// Picks an archetype that can spawn at the difficulty level, by spawn weight. Returns INDEX_NONE if there is none.
+	int32 PickRandomArchetype(int32 DifficultyLevel) const;
+
+private:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true, TitleProperty = "Name"))
+	TArray<FEnemyArchetype> Archetypes;
+};
@@ -5,17 +5,21 @@
 #include "CoreMinimal.h"
 //#include "GameFramework/Actor.h"
 
+#include "EnemyArchetypeTable.h"
+#include "EnemyFlocking.h"
+#include "EnemySteering.h"
 #include "PoolActor.h"
 
 #include "EnemyBase.generated.h"
 
 //DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FEnemyDeathDelegateSignature, FVector, EnemyDeathPosition, class UNiagaraSystem*, EnemyDeathEffect);
 //DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FEnemyDeathDelegateSignature, FVector, EnemyDeathPosition, class UNiagaraSystem*, EnemyDeathEffect);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(
 	FEnemyDeathDelegateSignature,
 	FVector, EnemyDeathPosition,
 	class UNiagaraSystem*, EnemyDeathEffect,
-	bool, bKilledFromBoost);
+	bool, bKilledFromBoost,
+	int32, EnemyScoreValue);
 
 UCLASS(Abstract)
 class SPACESHOOTER02_API AEnemyBase : public APoolActor
@@ -27,7 +31,7 @@ public:
 
 public:	
 	AEnemyBase();
-	virtual void Tick(float DeltaTime) override;
+	virtual FPoolActorBatchTickFunction GetPoolActorBatchTickFunction() const override { return &AEnemyBase::BatchTickEnemies; }
 	virtual void BeginDestroy() override;
 
 	// APoolActor / IPoolObject
@@ -35,15 +39,51 @@ public:
 	virtual void DeactivatePoolObject() override;
 	virtual bool EnableCollisionOnActivate() const override { return false; }
 
+	// Enemies swap in the sprite of their archetype whenever they are spawned, so they stay out of GC clusters
+	virtual bool CanBeInCluster() const override { return false; }
+
 	void DestroyEnemy(bool bDestroyedFromBoost = false);
-	void SetTarget(TSoftObjectPtr<AActor> InTargetActor);
+
+	// Removes hit points, and destroys the enemy once it has none left
+	void DamageEnemy(int32 Damage = 1);
+
+	// Takes on the movement, behaviour, hit points, score and look of an archetype. Called before the enemy is activated.
+	void ApplyArchetype(const FEnemyArchetype& Archetype);
+
+	// Index of the target registry snapshot to move towards. INDEX_NONE to move straight ahead.
+	void SetTarget(int32 InTargetIndex);
+
+	// Half size of the collision box's world space bounding box on the XZ plane (X, Z). Accounts for the enemy's rotation.
+	FVector2D GetCollisionHalfExtent() const;
+
+	// Activated enemies stay hidden and without collision until their spawn-in finishes.
+	// Whoever activates an enemy finishes its spawn-in once the spawn animation has played (see AEnemySpawner).
+	bool IsSpawning() const { return bIsSpawning; }
+	virtual void FinishSpawning();
+
+	// Finishes the spawn-in of every enemy in one pass
+	static void FinishSpawningEnemies(TConstArrayView<AEnemyBase*> Enemies);
+
+	// Flocking is computed by the combat collision subsystem from the enemy grid, and added to the steering next frame
+	const FEnemyFlockingSettings& GetFlockingSettings() const { return FlockingSettings; }
+	const FVector& GetMovementVelocity() const { return MovementVelocity; }
+	void SetFlockingSteering(const FVector& InFlockingSteering) { FlockingSteering = InFlockingSteering; }
 
 protected:
 	virtual void BeginPlay() override;
-	virtual FVector GetInactivePoolObjectPosition() const override;
 
 	virtual void MoveTowardsTarget(float DeltaTime);
-	virtual void OnSpawnDelayTimerElapsed();
+	static void BatchTickEnemies(TArrayView<APoolActor* const> PoolActors, float DeltaTime);
+
+	// Moves every active enemy of the pool towards its target. Runs the batched steering, or each enemy's own
+	// MoveTowardsTarget if SpaceShooter.BatchedEnemySteering is off.
+	static void SteerEnemies(TArrayView<APoolActor* const> PoolActors, float DeltaTime);
+
+private:
+	// Same movement as MoveTowardsTarget, for every enemy at once. Targets are read from the target registry, positions and
+	// facing angles are updated in contiguous arrays, and each enemy's transform is written back with a single move.
+	// Enemies are grouped by behaviour kind, so each behaviour runs as one loop without branching per enemy.
+	static void SteerEnemiesBatched(TArrayView<APoolActor* const> PoolActors, float DeltaTime, FEnemySteeringArrays& Steering);
 
 public:
 	//UPROPERTY(BlueprintAssignable)
@@ -67,16 +107,53 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float MoveSpeed = 1000.0f;
 
-	// By default, the enemy should move towards its target
+	// By default, the enemy should move towards its target. Index of the target's snapshot in the target registry.
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	TSoftObjectPtr<AActor> TargetActor;
+	int32 TargetIndex = INDEX_NONE;
 
 	// If true, enemy will rotate towards its target
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool bRotateToFaceTarget = true;
 
+	// How the enemy moves towards its target. Replaced by the archetype's behaviour when spawned from an archetype table.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	FEnemyBehaviourSettings BehaviourSettings;
+
+	// Seconds since the enemy finished spawning in. Drives the zig-zag and dash timings.
+	float BehaviourTimeSeconds = 0.0f;
+
+	// Side the enemy orbits or veers to first (+1 or -1). Picked at random when activated, so enemies do not move in lockstep.
+	float BehaviourSign = 1.0f;
+
+	// Separation, alignment and cohesion with nearby enemies. Off unless enabled for the enemy class.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	FEnemyFlockingSettings FlockingSettings;
+
+	// Movement of the last frame, in units per second
+	FVector MovementVelocity = FVector::ZeroVector;
+
+	// Added to the direction towards the target. Zero unless flocking is enabled.
+	FVector FlockingSteering = FVector::ZeroVector;
+
+	// --- Health / Score ---
+
+	// Number of projectile hits the enemy takes before it is destroyed
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin = "1"))
+	int32 MaxHitPoints = 1;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 HitPoints = 1;
+
+	// Score for destroying the enemy, before the score multiplier
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	int32 ScoreValue = 1;
+
 	// --- Effects ---
 
+	// Sprite of the enemy class, restored when an archetype without its own sprite reuses this enemy
+	UPROPERTY(Transient)
+	TObjectPtr<class UPaperSprite> DefaultSprite;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	TObjectPtr<class UNiagaraSystem> EnemyExplosionEffect;
 
@@ -84,10 +161,8 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	bool bIsSpawning = true;
 
-	UPROPERTY()
-	FTimerHandle SpawnDelayTimerHandle;
-
-	static const FVector InactivePosition;
+	// Publishes the target's position every frame
+	TWeakObjectPtr<class UTargetRegistrySubsystem> TargetRegistry;
 
 	// Debug
 	//UPROPERTY() FDateTime LastTimeActivated;
@@ -0,0 +1,42 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyBulletSubsystem.generated.h"
+
+class AProjectileBase;
+class AProjectileManager;
+
+// Simulates every bullet fired by enemies, separate from the player's projectiles.
+// Bullets of each class are simulated by one projectile manager (no actor per bullet), spawned on first use and kept for
+// the rest of the world, so a bullet is only a few array entries. The managers target the player, so the combat collision
+// subsystem tests their bullets against the player ship in a single pass instead of sweeping them against enemies.
+UCLASS()
+class SPACESHOOTER02_API UEnemyBulletSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// UWorldSubsystem Begin
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// UWorldSubsystem End
+
+	// Fires a bullet of the given class moving along Direction (a unit vector on the XZ plane) at Speed
+	void FireBullet(TSubclassOf<AProjectileBase> BulletClass, const FVector& Position, const FVector& Direction, float Speed, AActor* InOwner);
+
+	// Manager simulating the bullets of the given class. Spawned on first use, or ahead of it to avoid a hitch on the first shot.
+	AProjectileManager* GetOrCreateBulletManager(TSubclassOf<AProjectileBase> BulletClass);
+
+	// Removes every enemy bullet
+	void ResetEnemyBullets();
+
+	int32 GetNumEnemyBullets() const;
+
+private:
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<AProjectileBase>, TObjectPtr<AProjectileManager>> BulletManagers;
+
+	static constexpr int32 INITIAL_BULLET_CAPACITY = 2048;
+};
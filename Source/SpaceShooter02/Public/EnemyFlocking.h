@@ -0,0 +1,52 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnemyFlocking.generated.h"
+
+class FUniformGrid2D;
+
+// Flocking weights of an enemy class. Flocking bends an enemy's path to its target so swarms spread out instead of
+// collapsing into a single blob.
+USTRUCT(BlueprintType)
+struct FEnemyFlockingSettings
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	// If false, the enemy steers straight at its target. Flocking enemies still keep their distance from it.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bEnableFlocking = false;
+
+	// Enemies closer than this are aligned with and drawn towards
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float NeighbourRadius = 300.0f;
+
+	// Enemies closer than this are pushed away from, harder the closer they are
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float SeparationRadius = 150.0f;
+
+	// Weights relative to steering at the target, which has a weight of 1
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float SeparationWeight = 1.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float AlignmentWeight = 0.3f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float CohesionWeight = 0.2f;
+};
+
+// Separation, alignment and cohesion steering of the items of a uniform grid (the game is played on the XZ plane, so
+// world X maps to X and world Z maps to Y). Neighbours are found through the grid cells around each item.
+struct SPACESHOOTER02_API FEnemyFlocking
+{
+	// Computes the steering of every grid item with settings. Velocities, Settings and OutSteering are indexed like the
+	// grid items. Items without settings (nullptr) get no steering, but still count as neighbours of the others.
+	// Runs in parallel over the grid cells.
+	static void ComputeSteering(const FUniformGrid2D& Grid, TConstArrayView<FVector2D> Velocities, TConstArrayView<const FEnemyFlockingSettings*> Settings, TArrayView<FVector2D> OutSteering);
+
+	// Steering of a single grid item. Each term is at most 1 before its weight is applied.
+	static FVector2D ComputeItemSteering(const FUniformGrid2D& Grid, int32 ItemIndex, TConstArrayView<FVector2D> Velocities, const FEnemyFlockingSettings& Settings);
+};
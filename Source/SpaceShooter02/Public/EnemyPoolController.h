@@ -4,29 +4,37 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+
+#include "PoolGrowthSettings.h"
+
 #include "EnemyPoolController.generated.h"
 
-// Handles different pools of enemies
+// Configures one pool per enemy class. The pools themselves are owned by USpaceShooterPoolSubsystem.
+// Enemies are picked from the archetype table if there is one, and from the enemy classes otherwise.
 UCLASS(Blueprintable)
 class SPACESHOOTER02_API UEnemyPoolController : public UObject
 {
 	GENERATED_BODY()
 
 public:
-	virtual void BeginDestroy() override;
-
 	void InitEnemyPools();
-	void ResetEnemyPools();
-	class AEnemyBase* GetRandomEnemy();
+
+	// Acquires a random enemy. With an archetype table, only archetypes allowed at the difficulty level are picked, and
+	// the enemy is set up as its archetype.
+	class AEnemyBase* GetRandomEnemy(int32 DifficultyLevel = 1);
 
 private:
-	// List of enemy classes to create pools from
+	// Enemy types to spawn. Archetypes sharing an enemy class share its pool.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	TObjectPtr<class UEnemyArchetypeTable> ArchetypeTable;
+
+	// List of enemy classes to create pools from. Only used if there is no archetype table.
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	TArray<TSubclassOf<class AEnemyBase>> EnemyClasses;
-	
-	// List of enemy pool containers. Number of pools containers will be exactly the number of enemy classes.
-	UPROPERTY(VisibleInstanceOnly, BlueprintReadWrite, meta = (AllowPrivateAccess = true))
-	TArray<TObjectPtr<class UEnemyPoolContainer>> EnemyPoolContainers;
+
+	// How each enemy pool grows when it runs out, and when it shrinks back
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	FPoolGrowthSettings GrowthSettings;
 
 	static constexpr int32 MAX_ENEMIES_PER_POOL = 50;
 };
@@ -0,0 +1,43 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BulletPatternAsset.h"
+#include "EnemyBase.h"
+
+#include "EnemyShooter.generated.h"
+
+// Enemy that fires a bullet pattern while it moves towards its target.
+// The pattern is a shared UBulletPatternAsset played back from its compiled instruction table. Bullets are fired into the
+// enemy bullet subsystem's manager for the bullet class, so no actor is spawned per bullet.
+UCLASS(Abstract)
+class SPACESHOOTER02_API AEnemyShooter : public AEnemyBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual FPoolActorBatchTickFunction GetPoolActorBatchTickFunction() const override { return &AEnemyShooter::BatchTickShooterEnemies; }
+	virtual void ActivatePoolObject() override;
+
+protected:
+	virtual void BeginPlay() override;
+	static void BatchTickShooterEnemies(TArrayView<APoolActor* const> PoolActors, float DeltaTime);
+
+	// Fires every bullet of the pattern that is due this frame
+	void UpdateBulletPattern(float DeltaTime);
+
+private:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "EnemyShooter", meta = (AllowPrivateAccess = true))
+	TObjectPtr<class UBulletPatternAsset> BulletPattern;
+
+	// Projectile class the bullets look and collide like. Its speed is ignored, as every bullet's speed comes from the pattern.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "EnemyShooter", meta = (AllowPrivateAccess = true))
+	TSubclassOf<class AProjectileBase> BulletClass;
+
+	FBulletPatternPlayer BulletPatternPlayer;
+
+	// Simulates the bullets of BulletClass. Shared by every enemy firing that class, through the enemy bullet subsystem.
+	TWeakObjectPtr<class AProjectileManager> BulletManager;
+};
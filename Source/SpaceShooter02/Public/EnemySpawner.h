@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/RingBuffer.h"
 #include "GameFramework/Actor.h"
 #include "EnemySpawner.generated.h"
 
@@ -38,12 +39,18 @@ protected:
 	void OnGameStarted();
 
 	UFUNCTION()
-	void OnEnemyDeath(FVector EnemyDeathPosition, class UNiagaraSystem* EnemyDeathEffect, bool bKilledFromBoost);
+	void OnEnemyDeath(FVector EnemyDeathPosition, class UNiagaraSystem* EnemyDeathEffect, bool bKilledFromBoost, int32 EnemyScoreValue);
 
 	float GetTimeBetweenSpawns() const;
 
 	FVector GetRandomEnemySpawnPosition() const;
 
+	// Finishes the spawn-in of the enemy once its spawn animation has played for SpawnInDelaySeconds
+	void QueueSpawnIn(class AEnemyBase* Enemy, float SpawnInDelaySeconds);
+
+	// Finishes the spawn-in of every queued enemy whose spawn animation is over
+	void UpdateSpawnIns();
+
 #if WITH_EDITOR
 	virtual bool CanEditChange(const FProperty* InProperty) const override;
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -97,4 +104,23 @@ protected:
 	
 	// Last time an enemy was spawned
 	float TimeSinceLastEnemySpawned = 0.0f;
+
+private:
+	// Enemy waiting for its spawn animation to finish
+	struct FEnemySpawnIn
+	{
+		TWeakObjectPtr<class AEnemyBase> Enemy;
+
+		// Activation the spawn-in belongs to. The enemy may have been deactivated and reused since.
+		uint32 ActivationSerial = 0;
+
+		double FinishTimeSeconds = 0.0;
+	};
+
+	// Enemies still spawning in, ordered by the time their spawn-in finishes.
+	// Replaces a timer per enemy. Only the front of the queue is checked each frame.
+	TRingBuffer<FEnemySpawnIn> SpawnInQueue;
+
+	// Enemies whose spawn-in finished this frame. Kept to avoid reallocating every frame, and emptied after use.
+	TArray<class AEnemyBase*> FinishedSpawnInEnemies;
 };
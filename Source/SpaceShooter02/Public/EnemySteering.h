@@ -0,0 +1,58 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AEnemyBase;
+struct FEnemyBehaviourSettings;
+
+// Steering state of the enemies moved by one batched steering update. Index i of every array belongs to enemy i.
+// Owned by UCombatCollisionSubsystem, so the arrays keep their allocations from frame to frame. They hold raw enemy
+// pointers, so they are reset once the update has written the enemies back.
+struct FEnemySteeringArrays
+{
+	TArray<AEnemyBase*> Enemies;
+	TArray<FVector> Positions;
+	TArray<FVector> Directions;
+	TArray<float> Speeds;
+	TArray<FVector> FlockingSteerings;
+
+	// Behaviour state. Headings are last frame's movement directions.
+	TArray<const FEnemyBehaviourSettings*> Behaviours;
+	TArray<float> BehaviourTimes;
+	TArray<float> BehaviourSigns;
+	TArray<FVector> Headings;
+	TArray<FVector> ToTargets;
+	TArray<float> SpeedScales;
+	TArray<bool> bHasTarget;
+
+	// Indices of the enemies with a target, sorted by behaviour kind. Kind K owns KindOrder[KindStarts[K]..KindStarts[K + 1]).
+	TArray<int32> KindOrder;
+	TArray<int32> KindStarts;
+
+	// Pitch facing the movement direction, in degrees
+	TArray<float> FacingAngles;
+	TArray<bool> bFaceDirection;
+
+	void Reset()
+	{
+		Enemies.Reset();
+		Positions.Reset();
+		Directions.Reset();
+		Speeds.Reset();
+		FlockingSteerings.Reset();
+		Behaviours.Reset();
+		BehaviourTimes.Reset();
+		BehaviourSigns.Reset();
+		Headings.Reset();
+		ToTargets.Reset();
+		SpeedScales.Reset();
+		bHasTarget.Reset();
+		KindOrder.Reset();
+		KindStarts.Reset();
+		FacingAngles.Reset();
+		bFaceDirection.Reset();
+	}
+};
+
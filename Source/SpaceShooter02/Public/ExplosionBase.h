@@ -25,7 +25,6 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
-	virtual FVector GetInactivePoolObjectPosition() const override;
 
 	UFUNCTION()
 	void OnExplosionAnimationFinished();
@@ -36,6 +35,4 @@ protected:
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	TObjectPtr<class UPaperFlipbookComponent> ExplosionFlipbookComp;
-
-	static const FVector InactivePosition;
 };
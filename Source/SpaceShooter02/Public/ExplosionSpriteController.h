@@ -4,18 +4,19 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+
+#include "PoolGrowthSettings.h"
+
 #include "ExplosionSpriteController.generated.h"
 
+// Configures one pool per explosion sprite class. The pools themselves are owned by USpaceShooterPoolSubsystem.
 UCLASS(Blueprintable)
 class SPACESHOOTER02_API UExplosionSpriteController : public UObject
 {
 	GENERATED_BODY()
 
 public:
-	virtual void BeginDestroy() override;
-
 	void InitExplosionSpritePools();
-	void ResetExplosionSpritePools();
 	class AExplosionBase* GetRandomInactiveExplosionSprite();
 
 public:
@@ -26,7 +27,7 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	TArray<TSubclassOf<class AExplosionBase>> ExplosionSpriteClasses;
 
-	// List of explosion sprite pools. Number of pools will be exactly the number of explosion sprite classes.
+	// How each explosion sprite pool grows when it runs out, and when it shrinks back
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
-	TArray<TObjectPtr<class UExplosionSpritePoolContainer>> ExplosionSpritePoolContainers;
+	FPoolGrowthSettings GrowthSettings;
 };
@@ -0,0 +1,95 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ImpactEffectSubsystem.generated.h"
+
+class UNiagaraComponent;
+class UNiagaraSystem;
+
+// Fixed set of components that play one impact effect
+USTRUCT()
+struct FImpactEffectPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UNiagaraComponent>> Components;
+
+	// Next component to play. Components are used in order, so this is always the one that was played longest ago.
+	int32 NextComponentIndex = 0;
+};
+
+// Plays projectile impact effects from pre-allocated Niagara components instead of spawning a component per impact.
+// Impacts are queued during the frame and played once every actor has ticked. Impacts of the same effect close to an
+// impact already played this frame are merged into it, and at most MaxImpactEffectsPerFrame are played per frame.
+// Each effect has a fixed number of components. When they are all playing, the oldest one is restarted.
+// Limits are read from the [/Script/SpaceShooter02.ImpactEffectSubsystem] section of DefaultGame.ini.
+UCLASS(config = Game)
+class SPACESHOOTER02_API UImpactEffectSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// UTickableWorldSubsystem Begin
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(UImpactEffectSubsystem, STATGROUP_Tickables);
+	}
+	// UTickableWorldSubsystem End
+
+	// Allocates the components for the given effect up front. Pools are otherwise created on the first impact.
+	void CreateImpactEffectPool(UNiagaraSystem* ImpactEffect);
+
+	// Queues an impact effect to be played at the end of this frame
+	void SpawnImpactEffect(UNiagaraSystem* ImpactEffect, const FVector& Location, const FRotator& Rotation);
+
+private:
+	// Plays the queued impacts
+	void FlushImpactEffects();
+
+	// Plays the effect on the component that was played longest ago
+	void PlayImpactEffect(FImpactEffectPool& ImpactEffectPool, const FVector& Location, const FRotator& Rotation);
+
+	// Publishes the number of components allocated during the last second
+	void UpdateAllocationStats();
+
+private:
+	// Number of components allocated for each impact effect (at least 1)
+	UPROPERTY(Config)
+	int32 ImpactEffectPoolSize = 24;
+
+	// Most impact effects played in a single frame. Impacts past this are dropped.
+	UPROPERTY(Config)
+	int32 MaxImpactEffectsPerFrame = 6;
+
+	// Impacts of the same effect closer than this (world units) to one already played this frame are merged into it
+	UPROPERTY(Config)
+	float ImpactEffectMergeDistance = 40.0f;
+
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UNiagaraSystem>, FImpactEffectPool> ImpactEffectPools;
+
+	struct FImpactEffectRequest
+	{
+		UNiagaraSystem* ImpactEffect = nullptr;
+		FVector Location;
+		FRotator Rotation;
+	};
+
+	// Impacts queued this frame
+	TArray<FImpactEffectRequest> PendingImpactEffects;
+
+	// Impacts played this frame, used to merge nearby impacts
+	TArray<FImpactEffectRequest> PlayedImpactEffects;
+
+	// --- Allocation Stats ---
+
+	int32 NumAllocationsThisSecond = 0;
+	double AllocationStatsStartTimeSeconds = 0.0;
+};
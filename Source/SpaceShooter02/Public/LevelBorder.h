@@ -16,6 +16,9 @@ public:
 	ALevelBorder();
 	virtual void Tick(float DeltaTime) override;
 
+	// World space bounds of the border's collision box
+	FBox GetBorderBounds() const;
+
 protected:
 	virtual void BeginPlay() override;
 
@@ -15,7 +15,7 @@ class SPACESHOOTER02_API APickupItemBase : public APoolActor
 	
 public:	
 	APickupItemBase();
-	virtual void Tick(float DeltaTime) override;
+	virtual FPoolActorBatchTickFunction GetPoolActorBatchTickFunction() const override { return &APickupItemBase::BatchTickPickupItems; }
 	virtual void ActivatePoolObject() override;
 	virtual void DeactivatePoolObject() override;
 
@@ -23,15 +23,14 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
-	virtual FVector GetInactivePoolObjectPosition() const override;
-	virtual void UpdateLifetime(float DeltaTime) override;
 
 	virtual void UpdateMovement(float DeltaTime);
 	virtual void UpdateAttractionMovement(float DeltaTime);
 	virtual void UpdateNonAttractionMovement(float DeltaTime);
 	virtual void UpdateTargetAttraction(float DeltaTime);
+	static void BatchTickPickupItems(TArrayView<APoolActor* const> PoolActors, float DeltaTime);
 
-	virtual bool IsAttractingToTarget() const { return AttractionTargetActor != nullptr; }
+	virtual bool IsAttractingToTarget() const { return AttractionTargetIndex != INDEX_NONE; }
 
 	virtual void HandlePlayerPickup() {};
 
@@ -70,9 +69,9 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool bUseTargetAttraction = true;
 
-	// Target actor to be "pulled" towards
-	UPROPERTY(EditInstanceOnly, BlueprintReadWrite)
-	TObjectPtr<AActor> AttractionTargetActor;
+	// Target to be "pulled" towards. Index of the target's snapshot in the target registry.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 AttractionTargetIndex = INDEX_NONE;
 
 	// If the player is this close to a pickup item, start attraction
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
@@ -82,9 +81,9 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float AttractionMovementSpeed = 1750.0f;
 
-	// Used for easily getting the player.
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	TSoftObjectPtr<class APlayerShipPawn> PlayerShipPawn;
+	// Answers wall collision queries without physics traces
+	TWeakObjectPtr<class UArenaCollisionSubsystem> ArenaCollision;
 
-	static const FVector InactivePosition;
+	// Publishes the player ship's position every frame
+	TWeakObjectPtr<class UTargetRegistrySubsystem> TargetRegistry;
 };
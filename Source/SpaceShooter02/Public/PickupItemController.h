@@ -4,8 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+
+#include "PoolGrowthSettings.h"
+
 #include "PickupItemController.generated.h"
 
+// Configures the pickup item pools. The pools themselves are owned by USpaceShooterPoolSubsystem.
 UCLASS(Blueprintable)
 class SPACESHOOTER02_API UPickupItemController : public UObject
 {
@@ -13,18 +17,15 @@ class SPACESHOOTER02_API UPickupItemController : public UObject
 
 public:
 	void InitScoreMultiplierPool();
-	void ResetScoreMultiplierPool();
 	class APickupItemScoreMultiplier* GetInactiveScoreMultiplier();
 
-private:
-	class APickupItemScoreMultiplier* CreateAndAddNewScoreMultiplier();
-
 private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	TSubclassOf<class APickupItemScoreMultiplier> ScoreMultiplierClass;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = true))
-	TArray<TObjectPtr<class APickupItemScoreMultiplier>> ScoreMultiplierPool;
+	// How the score multiplier pool grows when it runs out, and when it shrinks back
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	FPoolGrowthSettings GrowthSettings;
 
 	static constexpr int32 MAX_SCORE_MULTIPLIERS = 100;
 };
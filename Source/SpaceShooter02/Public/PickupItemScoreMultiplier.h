@@ -14,7 +14,6 @@ class SPACESHOOTER02_API APickupItemScoreMultiplier : public APickupItemBase
 	GENERATED_BODY()
 
 protected:
-	virtual void UpdateLifetime(float DeltaTime) override;
 	virtual void HandlePlayerPickup() override;
 
 public:
@@ -44,6 +44,8 @@ public:
 
 	bool GetPlayerDead() const { return bPlayerDead; }
 
+	void SetPlayerInvincible(bool bInvincible) { bPlayerInvincible = bInvincible; }
+
 	void EnablePlayer();
 
 	bool IsPlayerDisabled() const { return IsHidden(); }
@@ -52,6 +54,15 @@ public:
 
 	FVector GetEnemySpawnSourcePosition() const;
 
+	// Dash collision is resolved by the combat collision subsystem, which sweeps the ship from its movement start location
+	bool IsDashing() const { return bIsDashing; }
+	const FVector& GetMovementStartLocation() const { return MovementStartLocation; }
+	float GetCollisionRadius() const;
+	void OnDashEnemyHit(class AEnemyBase* Enemy);
+
+	// Called by the combat collision subsystem when an enemy bullet touches the ship. Dashing ships are not harmed.
+	void OnEnemyBulletHit();
+
 	static FPlayerShipSpawnedDelegateSignature OnPlayerShipSpawned;
 	static FPlayerShipDestroyedDelegateSignature OnPlayerShipDestroyed;
 	static FPlayerPowerupTimerUpdatedDelegateSignature OnPlayerPowerupTimerUpdated;
@@ -120,17 +131,17 @@ protected:
 
 	void KillPlayer();
 
+	// Publishes the ship's position, velocity and alive flag to the target registry, for enemies and pickups to read
+	void PublishTargetSnapshot(const FVector& Velocity);
+
 	void SetMouseCursorVisiblityFromInput(APlayerController* const PlayerController, bool bCursorVisible);
 
 	void UpdateSatelliteWeaponRotation(float DeltaTime);
 	void UpdateSatelliteWeaponAimRotation(FRotator AimRotation);
 	void UpdateSatelliteWeaponAimRotation(FRotator AimRotation, class UPaperSpriteComponent* const SatelliteWeapon);
 
-	void FireProjectileFromSatelliteWeapon(UWorld* const World, const FActorSpawnParameters& ProjectileSpawnParameters);
-	void FireProjectileFromSatelliteWeapon(
-		UWorld* const World,
-		class UPaperSpriteComponent* const SatelliteWeapon,
-		const FActorSpawnParameters& ProjectileSpawnParameters);
+	// Appends the fire transform of every enabled satellite weapon
+	void GetSatelliteWeaponFireTransforms(TArray<FTransform>& OutFireTransforms) const;
 
 	void DisableSatelliteWeapons();
 	void DisableSatelliteWeapon(class UPaperSpriteComponent* const SatelliteWeapon);
@@ -308,6 +319,9 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "PlayerShipPawn|Movement & Aiming")
 	float DashMoveSpeedMultiplier = 2.0f;
 
+	// Ship location before this frame's movement
+	FVector MovementStartLocation = FVector::ZeroVector;
+
 	// --- Weapons and Projectiles ---
 
 	// Class of Projectile that will be fired
@@ -326,6 +340,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PlayerShipPawn|Weapons & Projectiles", meta = (Units = "Seconds"))
 	float TimeSinceLastShot;
 
+	// Fire transforms of the volley being fired (kept to avoid reallocating every shot)
+	TArray<FTransform> VolleyFireTransforms;
+	TArray<FTransform> HomingVolleyFireTransforms;
+
 	// How quickly the satellite weapon rotates around the player ship. In degrees per second.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PlayerShipPawn|Weapons & Projectiles")
 	float SatelliteWeaponRotationSpeed = 360.0f;
@@ -403,6 +421,10 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	int32 MaxPowerupLevels = 4;
 
+	// Powerup level from which the satellite weapons fire homing projectiles. 0 to never fire homing projectiles.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin = "0"))
+	int32 HomingPowerupLevel = 4;
+
 	// -------------------------------------------------------------------------------------
 	// Below stuff copied from SpaceShooterGameState. Probably should really be in a PlayerState.
 
@@ -433,6 +455,8 @@ protected:
 	UPROPERTY()
 	TWeakObjectPtr<class ASpaceShooterGameState> SpaceShooterGameState;
 
+	TWeakObjectPtr<class UTargetRegistrySubsystem> TargetRegistry;
+
 	// -------------------------------------------------------------------------------------
 	// Distance to offset in front of the player for the enemy spawn radius
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
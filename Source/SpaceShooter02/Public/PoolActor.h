@@ -9,6 +9,13 @@
 
 #include "PoolActor.generated.h"
 
+class APoolActor;
+class FPoolActorContainerBase;
+
+// Per-frame work for a batch of pooled actors of the same class. A pool calls this once per frame with all of its
+// active actors, so each class's per-frame work runs in one tight loop without a tick function per actor.
+using FPoolActorBatchTickFunction = void (*)(TArrayView<APoolActor* const> PoolActors, float DeltaTime);
+
 UCLASS(Abstract)
 class SPACESHOOTER02_API APoolActor : public AActor, public IPoolObject
 {
@@ -18,16 +25,37 @@ public:
 	APoolActor();
 	virtual void Tick(float DeltaTime) override;
 
+	// Pooled actors live as long as their pool, so they (and their components) can be grouped into a GC cluster.
+	// Classes that gain object references while in use must return false (see UPoolActorCluster).
+	virtual bool CanBeInCluster() const override { return true; }
+
 	// IPoolObject
 	virtual void ActivatePoolObject() override;
 	virtual void DeactivatePoolObject() override;
 	bool IsPoolObjectActive() const { return bIsPoolObjectActive; }
 
+	// Changes every time the actor is activated, so a cached reference can tell if the actor was reused since it was taken
+	uint32 GetPoolActivationSerial() const { return PoolActivationSerial; }
+
+	// Batched per-frame function of this class, or nullptr if it has no per-frame work. Queried once per pool, on the class default object.
+	virtual FPoolActorBatchTickFunction GetPoolActorBatchTickFunction() const { return nullptr; }
+
+	// Lifetime expiry is scheduled on the pool subsystem's timing wheel when the actor is activated
+	bool HasFiniteLifetime() const { return LifeTimeSeconds < MaxFiniteLifeTimeSeconds; }
+	float GetLifeTimeSeconds() const { return LifeTimeSeconds; }
+	float GetTimeAlive() const;
+
+	// Stops / restarts the lifetime countdown. The time spent paused does not count towards the lifetime.
+	void PauseLifetime();
+	void ResumeLifetime();
+	bool IsLifetimePaused() const { return LifetimePausedTimeSeconds >= 0.0; }
+
 protected:
 	virtual void BeginPlay() override;
-	virtual FVector GetInactivePoolObjectPosition() const override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-	virtual void UpdateLifetime(float DeltaTime);
+	// Called when the lifetime runs out. Deactivates the actor by default.
+	virtual void OnLifetimeExpired();
 
 protected:
 	// Whether this object is active and visible in the world
@@ -38,7 +66,53 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float LifeTimeSeconds = MAX_flt - 1.0f;
 
-	// How long this object has been alive / active
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
-	float TimeAlive = 0.0f;
+	// Lifetimes at or above this are treated as infinite and never scheduled
+	static constexpr float MaxFiniteLifeTimeSeconds = 1.0e6f;
+
+private:
+	// Schedules lifetime expiry from the time remaining
+	void ScheduleLifetimeExpiry();
+
+	// Queues the visibility / collision / tick change for the end of the frame. Applied immediately if there is no pool subsystem.
+	void QueuePoolObjectStateChange();
+
+	// Brings the actor's visibility, collision and tick in line with bIsPoolObjectActive. Does nothing if they already match.
+	void ApplyPoolObjectState();
+
+	// Called by the owning pool when it takes over (or hands back) ticking this actor
+	void SetTickedByPool(bool bInTickedByPool);
+
+private:
+	// Pool that owns this actor. Kept in sync on activate / deactivate.
+	FPoolActorContainerBase* OwningPool = nullptr;
+
+	// Index of this actor in the owning pool's active list (if active) or free list (if inactive)
+	int32 PoolSlotIndex = INDEX_NONE;
+
+	// Set by the owning pool on activation. Lower values were activated earlier.
+	uint32 PoolActivationSerial = 0;
+
+	// Subsystem that batches this actor's state changes
+	TWeakObjectPtr<class USpaceShooterPoolSubsystem> PoolSubsystem;
+
+	// Active state last applied to the actor's visibility, collision and tick. Spawned actors start visible and collidable.
+	bool bPoolObjectStateApplied = true;
+
+	// Whether this actor is in the pool subsystem's state change queue
+	bool bPoolObjectStateChangeQueued = false;
+
+	// Whether the owning pool ticks this actor. If so, the actor's own tick function stays disabled.
+	bool bTickedByPool = false;
+
+	// World time the actor was activated, pushed forward by any time spent paused
+	double LifetimeStartTimeSeconds = 0.0;
+
+	// World time the lifetime was paused. Negative if not paused.
+	double LifetimePausedTimeSeconds = -1.0;
+
+	// Incremented whenever a scheduled expiry becomes invalid (deactivation, pause). Expiries of older generations are ignored.
+	uint32 LifetimeGeneration = 0;
+
+	friend class FPoolActorContainerBase;
+	friend class USpaceShooterPoolSubsystem;
 };
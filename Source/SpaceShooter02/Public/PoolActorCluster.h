@@ -0,0 +1,46 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "PoolActorCluster.generated.h"
+
+class APoolActor;
+
+// Root of a garbage collection cluster holding pooled actors and their components.
+// Pooled actors live as long as their pool, so once they are clustered the garbage collector only checks the root each
+// pass instead of marking and traversing every actor and component. Works like the engine's level actor clusters,
+// which only cover actors placed in a level and never runtime spawned ones.
+// A cluster only knows the references its objects had when it was created. Objects referenced later from inside the
+// cluster are not kept alive by it, so pooled classes that gain object references while in use (a target, an instigator,
+// a swapped sprite) return false from CanBeInCluster and are left out. Run SpaceShooter.VerifyPoolActorCluster to have
+// the garbage collector check the cluster's assumptions (gc.VerifyAssumptions).
+UCLASS()
+class SPACESHOOTER02_API UPoolActorCluster : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// UObject Begin
+	virtual bool CanBeClusterRoot() const override { return true; }
+	// UObject End
+
+	// Creates the cluster from the given actors that can be in a cluster. Must only be called once per cluster object.
+	void CreatePoolActorCluster(TArrayView<APoolActor* const> InPoolActors);
+
+	// Releases every actor from the cluster, so they are garbage collected individually again
+	void DissolvePoolActorCluster();
+
+	bool IsClustered() const { return bClustered; }
+	int32 GetNumClusteredPoolActors() const { return PoolActors.Num(); }
+
+	// Whether clusters can be created at all. The engine only creates clusters in cooked builds.
+	static bool CanCreatePoolActorClusters();
+
+private:
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<APoolActor>> PoolActors;
+
+	bool bClustered = false;
+};
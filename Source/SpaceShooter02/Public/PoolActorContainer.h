@@ -0,0 +1,236 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/RingBuffer.h"
+#include "Engine/EngineBaseTypes.h"
+
+#include "PoolActor.h"
+#include "PoolGrowthSettings.h"
+
+// Creates a single actor and adds it to the pool. Returns the new actor, or nullptr if spawning failed.
+DECLARE_DELEGATE_RetVal(APoolActor*, FCreatePoolActorDelegate);
+
+// Single tick function that ticks every active actor of a pool (see FPoolActorContainerBase::EnablePoolTick)
+struct FPoolActorTickFunction : public FTickFunction
+{
+	class FPoolActorContainerBase* Pool = nullptr;
+
+	// FTickFunction Begin
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+	// FTickFunction End
+};
+
+// Base container for a pool of APoolActors.
+// Keeps a dense list of active actors and a free list (stack) of inactive actors. Every APoolActor stores its own
+// slot index into whichever list it currently lives in, so acquiring and releasing an actor is O(1) no matter how
+// many actors are in the pool or how many of them are in use.
+// APoolActor::ActivatePoolObject / DeactivatePoolObject keep the lists in sync, so callers never move actors manually.
+// When the free list runs dry the pool grows according to its FPoolGrowthSettings, and it shrinks back to its startup
+// size after staying nearly empty for a while (see UpdateShrink).
+class SPACESHOOTER02_API FPoolActorContainerBase
+{
+public:
+	FPoolActorContainerBase() = default;
+	virtual ~FPoolActorContainerBase() = default;
+
+	// Pools hand out pointers to themselves (APoolActor::OwningPool), so they must never be copied or moved
+	FPoolActorContainerBase(const FPoolActorContainerBase&) = delete;
+	FPoolActorContainerBase& operator=(const FPoolActorContainerBase&) = delete;
+
+	// Sets up the pool. PoolOwner is the UObject holding this pool and is used for deferred growth.
+	void InitPool(UObject* InPoolOwner, FName InPoolName, const FPoolGrowthSettings& InGrowthSettings, FCreatePoolActorDelegate InCreatePoolActor);
+
+	// Ticks every active actor of the pool from one tick function, through the given batched tick function, instead of
+	// through each actor's own tick function. If the function is null the class has no per-frame work and nothing ticks.
+	// Must be called before any actor is added.
+	void EnablePoolTick(UWorld* World, FPoolActorBatchTickFunction InBatchTickFunction);
+
+	// Size the pool was created with. The pool never shrinks below this.
+	void SetStartupPoolSize(int32 InStartupPoolSize) { StartupPoolSize = InStartupPoolSize; }
+
+	// Adds a newly created actor to this pool. Inactive actors are pushed onto the free list.
+	void AddPoolActor(APoolActor* PoolActor);
+
+	// Removes an actor from this pool (e.g. when it is destroyed)
+	void RemovePoolActor(APoolActor* PoolActor);
+
+	// Deactivates up to MaxNumToReset active actors (all of them by default) and returns how many were deactivated.
+	// Inactive actors are not touched.
+	int32 ResetPool(int32 MaxNumToReset = MAX_int32);
+
+	// Detaches every actor from this pool and unregisters the pool tick. Must be called from the owning UObject's BeginDestroy.
+	void Empty();
+
+	int32 GetNumActive() const { return ActivePoolActors.Num(); }
+	int32 GetNumFree() const { return FreePoolActors.Num(); }
+	int32 GetNum() const { return ActivePoolActors.Num() + FreePoolActors.Num(); }
+	bool HasFreePoolActor() const { return FreePoolActors.Num() > 0; }
+
+	// Appends every actor in this pool, active or not
+	void GetAllPoolActors(TArray<APoolActor*>& OutPoolActors) const;
+
+	// Name used to identify this pool in logs and in the pool profile
+	FName GetPoolName() const { return PoolName; }
+
+	// Returns a unique name for the next actor spawned into this pool (e.g. Projectiles_12).
+	// Passing an already unique name to SpawnActor saves the engine from searching for a free name on every spawn.
+	FName MakeSpawnName() { return FName(PoolName, NAME_EXTERNAL_TO_INTERNAL(++NumSpawnNames)); }
+
+	// Destroys free actors down to the startup size once the pool has stayed at or below its low-water mark
+	// for ShrinkDelaySeconds. Called periodically while no game is running.
+	void UpdateShrink(double CurrentTimeSeconds);
+
+	// --- Occupancy Telemetry (per run) ---
+
+	int32 GetPeakNumActive() const { return PeakNumActive; }
+	int32 GetNumMisses() const { return NumMisses; }
+	int32 GetNumGrowEvents() const { return NumGrowEvents; }
+
+	// Must be called from the owning UObject's AddReferencedObjects so the pooled actors are kept alive
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+protected:
+	// Returns the inactive actor on top of the free list, or nullptr if every actor is in use.
+	// The actor stays on the free list until ActivatePoolObject is called on it.
+	APoolActor* AcquireInternal() const;
+
+	// Returns up to Num distinct inactive actors from the top of the free list (fewer if the free list is shorter).
+	// The actors stay on the free list until ActivatePoolObject is called on them.
+	TConstArrayView<TObjectPtr<APoolActor>> AcquireMultipleInternal(int32 Num) const;
+
+	// Same as AcquireInternal, but grows the pool (or recycles the oldest active actor) if every actor is in use
+	APoolActor* AcquireOrGrowInternal();
+
+	const TArray<TObjectPtr<APoolActor>>& GetActivePoolActorsInternal() const { return ActivePoolActors; }
+
+private:
+	// Activation of an actor, as recorded in ActivationOrder
+	struct FActivationRecord
+	{
+		TWeakObjectPtr<APoolActor> PoolActor;
+		uint32 ActivationSerial = 0;
+	};
+
+	// Called by APoolActor when it is activated / deactivated
+	void OnPoolActorActivated(APoolActor* PoolActor);
+	void OnPoolActorDeactivated(APoolActor* PoolActor);
+
+	// Removes the actor at the given slot by swapping in the last actor (and fixing up that actor's slot index)
+	static void RemoveAtSlot(TArray<TObjectPtr<APoolActor>>& PoolActorList, int32 SlotIndex);
+
+	// Number of actors to add for the next grow event, according to the growth policy
+	int32 GetGrowAmount() const;
+
+	// Deactivates the active actor that was activated longest ago and returns it. Amortized O(1).
+	APoolActor* RecycleOldestActive();
+
+	// Records the activation of an actor in the activation order (CapAndRecycleOldest pools only)
+	void RecordActivation(APoolActor* PoolActor);
+
+	// Whether the recorded actor is still active in this pool from that activation (it may have been deactivated or reused since)
+	bool IsActivationCurrent(const FActivationRecord& Record) const;
+
+	// Creates the actors left over from a deferred grow event
+	void CreatePendingPoolActors();
+
+	// Called by the pool tick function
+	void TickActivePoolActors(float DeltaTime);
+
+private:
+	// Dense list of every active actor in this pool
+	TArray<TObjectPtr<APoolActor>> ActivePoolActors;
+
+	// Every inactive actor in this pool. The actor at the end of the list is the next one handed out.
+	TArray<TObjectPtr<APoolActor>> FreePoolActors;
+
+	FName PoolName = NAME_None;
+
+	// UObject that holds this pool
+	TWeakObjectPtr<UObject> PoolOwner;
+
+	FPoolGrowthSettings GrowthSettings;
+
+	FCreatePoolActorDelegate CreatePoolActor;
+
+	int32 StartupPoolSize = 0;
+
+	// Actors still to be created from a deferred grow event
+	int32 NumPendingPoolActors = 0;
+
+	// Time the pool dropped to its low-water mark. Negative if the pool is above it.
+	double LowWaterStartTimeSeconds = -1.0;
+
+	// Incremented on every activation. Used to find the oldest active actor.
+	uint32 LastActivationSerial = 0;
+
+	// Activations in order, oldest first (CapAndRecycleOldest pools only). Records that are no longer current are
+	// skipped when looking up the oldest active actor, and compacted away once they outnumber the active actors.
+	TRingBuffer<FActivationRecord> ActivationOrder;
+
+	// Number of names handed out by MakeSpawnName
+	int32 NumSpawnNames = 0;
+
+	// Highest number of simultaneously active actors this run
+	int32 PeakNumActive = 0;
+
+	// Number of times an actor was requested while every actor was in use
+	int32 NumMisses = 0;
+
+	// Number of times the pool was grown at runtime
+	int32 NumGrowEvents = 0;
+
+	// --- Pool Tick ---
+
+	FPoolActorTickFunction PoolTickFunction;
+
+	// Whether the pool (rather than each actor) is responsible for ticking its actors
+	bool bPoolTickEnabled = false;
+
+	// Per-frame work of the pooled class. Null if there is none, or if the actors tick themselves.
+	FPoolActorBatchTickFunction BatchTickFunction = nullptr;
+
+	// Active actors being ticked this frame. Copied from ActivePoolActors, as ticking can activate / deactivate actors.
+	TArray<APoolActor*> TickingPoolActors;
+
+	friend class APoolActor;
+	friend struct FPoolActorTickFunction;
+};
+
+// Typed pool of APoolActors
+template<typename PoolActorType>
+class TPoolActorContainer : public FPoolActorContainerBase
+{
+	static_assert(TIsDerivedFrom<PoolActorType, APoolActor>::Value, "TPoolActorContainer can only hold APoolActor subclasses");
+
+public:
+	// Returns an inactive actor, or nullptr if every actor is in use. O(1).
+	PoolActorType* Acquire() const { return static_cast<PoolActorType*>(AcquireInternal()); }
+
+	// Appends up to Num distinct inactive actors, without growing the pool. Returns the number appended. O(Num).
+	int32 AcquireMultiple(int32 Num, TArray<PoolActorType*>& OutPoolActors) const
+	{
+		const TConstArrayView<TObjectPtr<APoolActor>> FreeActors = AcquireMultipleInternal(Num);
+		for (APoolActor* PoolActor : FreeActors)
+		{
+			OutPoolActors.Add(static_cast<PoolActorType*>(PoolActor));
+		}
+		return FreeActors.Num();
+	}
+
+	// Returns an inactive actor, growing the pool according to its growth policy if every actor is in use
+	PoolActorType* AcquireOrGrow() { return static_cast<PoolActorType*>(AcquireOrGrowInternal()); }
+
+	// Calls the given function on every active actor. Actors must not be activated / deactivated from inside the function.
+	template<typename FunctionType>
+	void ForEachActive(FunctionType&& Function) const
+	{
+		for (APoolActor* PoolActor : GetActivePoolActorsInternal())
+		{
+			Function(static_cast<PoolActorType*>(PoolActor));
+		}
+	}
+};
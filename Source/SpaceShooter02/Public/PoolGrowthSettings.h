@@ -0,0 +1,51 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PoolGrowthSettings.generated.h"
+
+// How a pool grows when an actor is requested and every actor is in use
+UENUM(BlueprintType)
+enum class EPoolGrowthPolicy : uint8
+{
+	FixedChunk, // Grow by ChunkSize actors
+	Geometric, // Grow by GrowthFactor * current pool size
+	CapAndRecycleOldest, // Grow by ChunkSize actors up to MaxPoolSize, then recycle the oldest active actor
+	NumPoolGrowthPolicies UMETA(Hidden)
+};
+
+USTRUCT(BlueprintType)
+struct FPoolGrowthSettings
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EPoolGrowthPolicy GrowthPolicy = EPoolGrowthPolicy::FixedChunk;
+
+	// Number of actors added per grow event (FixedChunk and CapAndRecycleOldest)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1", UIMin = "1"))
+	int32 ChunkSize = 16;
+
+	// Fraction of the current pool size added per grow event (Geometric)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.01", UIMin = "0.01"))
+	float GrowthFactor = 0.5f;
+
+	// The pool never grows beyond this size (CapAndRecycleOldest)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1", UIMin = "1"))
+	int32 MaxPoolSize = 1000;
+
+	// If true, only the actor needed right away is spawned on a miss. The rest of the chunk is spawned next frame.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bDeferGrowth = true;
+
+	// After a reset, the pool shrinks back to its startup size once its active count has stayed at or below this
+	// fraction of the pool size for ShrinkDelaySeconds
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "1.0"))
+	float LowWaterMarkFraction = 0.25f;
+
+	// Seconds the pool must stay below the low-water mark before shrinking. Zero or less disables shrinking.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ShrinkDelaySeconds = 30.0f;
+};
@@ -0,0 +1,94 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class APoolActor;
+
+// Hierarchical timing wheel used to expire pooled actors when their lifetime runs out.
+// Scheduling is O(1) and advancing costs O(1) per expiring entry, instead of every active actor accumulating its time
+// alive every frame. Time is quantized into ticks of TickSeconds. Level 0 holds the next 64 ticks, and each higher level
+// holds 64 slots of 64x the span of the level below. Entries are cascaded down one level when their slot comes up.
+// Entries are never removed early. Instead each entry carries a generation, and the owner ignores entries whose
+// generation no longer matches the actor's (e.g. the actor was deactivated or its lifetime was paused).
+class SPACESHOOTER02_API FPoolLifetimeWheel
+{
+public:
+	explicit FPoolLifetimeWheel(double InTickSeconds = 1.0 / 60.0);
+
+	// Starts the wheel at the given time. Must be called before anything is scheduled.
+	void Start(double CurrentTimeSeconds);
+
+	// Schedules PoolActor to expire at ExpiryTimeSeconds. Expiry times in the past expire on the next advance.
+	void Schedule(APoolActor* PoolActor, uint32 Generation, double ExpiryTimeSeconds);
+
+	// Advances the wheel to CurrentTimeSeconds and calls OnExpired(PoolActor, Generation) for every entry that expired
+	// and whose actor is still alive. OnExpired may schedule new entries.
+	template<typename FunctionType>
+	void Advance(double CurrentTimeSeconds, FunctionType&& OnExpired)
+	{
+		const uint64 TargetTick = TimeToTick(CurrentTimeSeconds);
+		while (CurrentTick < TargetTick)
+		{
+			StepTick();
+
+			// Swap the slot out, so entries scheduled from OnExpired never land in the list being iterated
+			Exchange(ExpiringEntries, Slots[0][CurrentTick & SlotMask]);
+			for (const FEntry& Entry : ExpiringEntries)
+			{
+				if (APoolActor* PoolActor = Entry.PoolActor.Get())
+				{
+					OnExpired(PoolActor, Entry.Generation);
+				}
+			}
+			NumEntries -= ExpiringEntries.Num();
+			ExpiringEntries.Reset();
+		}
+	}
+
+	// Drops every scheduled entry
+	void Reset();
+
+	// Number of scheduled entries, including stale ones that have not come up yet
+	int32 GetNum() const { return NumEntries; }
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<APoolActor> PoolActor;
+		uint32 Generation = 0;
+		uint64 ExpiryTick = 0;
+	};
+
+	static constexpr int32 NumLevels = 3;
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 NumSlots = 1 << SlotBits;
+	static constexpr uint64 SlotMask = NumSlots - 1;
+
+	uint64 TimeToTick(double TimeSeconds) const;
+
+	// Places the entry in the slot matching its distance from the current tick
+	void Insert(FEntry&& Entry);
+
+	// Moves the current tick forward by one, cascading higher level slots down when their span begins
+	void StepTick();
+
+	// Re-inserts every entry of the given slot list
+	void Cascade(TArray<FEntry>& SlotEntries);
+
+private:
+	TArray<FEntry> Slots[NumLevels][NumSlots];
+
+	// Entries too far in the future for the top level. Re-inserted every time the top level wraps around.
+	TArray<FEntry> OverflowEntries;
+
+	// Scratch lists, kept to avoid reallocating while advancing
+	TArray<FEntry> ExpiringEntries;
+	TArray<FEntry> CascadingEntries;
+
+	double TickSeconds = 1.0 / 60.0;
+	double StartTimeSeconds = 0.0;
+	uint64 CurrentTick = 0;
+	int32 NumEntries = 0;
+};
@@ -23,7 +23,4 @@ public:
 	virtual void DeactivatePoolObject() = 0;
 	virtual bool IsPoolObjectActive() const = 0;
 	virtual bool EnableCollisionOnActivate() const { return true; }
-
-protected:
-	virtual FVector GetInactivePoolObjectPosition() const = 0;
 };
@@ -0,0 +1,90 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "UObject/NoExportTypes.h"
+#include "PoolPrewarmScheduler.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FPoolPrewarmProgressDelegateSignature, float, Percent);
+
+// Spreads the creation of pooled actors over several frames, spending at most FrameBudgetMs per frame.
+// Pools queue their initial actors here instead of spawning them all in BeginPlay. Call Flush() to finish synchronously
+// (e.g. when the player starts a game before pre-warming is done).
+UCLASS()
+class SPACESHOOTER02_API UPoolPrewarmScheduler : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// FTickableGameObject Begin
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(UPoolPrewarmScheduler, STATGROUP_Tickables);
+	}
+	virtual bool IsTickableWhenPaused() const { return false; }
+	virtual bool IsTickableInEditor() const { return false; }
+	// FTickableGameObject End
+
+	// Queues NumPoolActors calls of CreatePoolActor. Each call must create and add exactly one actor to its pool.
+	void AddPrewarmRequest(FName PoolName, int32 NumPoolActors, FSimpleDelegate CreatePoolActor);
+
+	// Creates every remaining queued actor immediately
+	void Flush();
+
+	bool IsPrewarming() const { return NumPoolActorsCreated < NumPoolActorsRequested; }
+
+	// Fraction of queued actors that have been created (0.0 - 1.0)
+	float GetProgress() const;
+
+	void SetFrameBudgetMs(float InFrameBudgetMs) { FrameBudgetMs = FMath::Max(InFrameBudgetMs, MinFrameBudgetMs); }
+
+	// Number of frames pre-warming has been spread over, and the most time spent in one of them (including a Flush)
+	int32 GetNumPrewarmFrames() const { return NumPrewarmFrames; }
+	double GetWorstFrameMs() const { return WorstFrameMs; }
+
+private:
+	// Creates the next queued actor. Returns false if there is nothing left to create.
+	bool CreateNextPoolActor();
+
+	void OnPrewarmFinished();
+
+public:
+	static FPoolPrewarmProgressDelegateSignature OnPoolPrewarmProgress; // Delegate called each frame pre-warming makes progress
+
+private:
+	struct FPoolPrewarmRequest
+	{
+		FName PoolName;
+		int32 NumRemaining = 0;
+		FSimpleDelegate CreatePoolActor;
+	};
+
+	// Queued requests. Processed in order.
+	TArray<FPoolPrewarmRequest> PrewarmRequests;
+
+	// Index of the request currently being processed
+	int32 CurrentRequestIndex = 0;
+
+	int32 NumPoolActorsRequested = 0;
+	int32 NumPoolActorsCreated = 0;
+
+	// Max time to spend creating actors each frame. At least one actor is always created per frame.
+	// Set by the pool subsystem from ASpaceShooterGameState::PoolPrewarmFrameBudgetMs.
+	float FrameBudgetMs = 2.0f;
+
+	static constexpr float MinFrameBudgetMs = 0.1f;
+
+	// --- Profiling ---
+
+	// Number of frames that pre-warming has been spread over
+	int32 NumPrewarmFrames = 0;
+
+	// Most time spent pre-warming in a single frame (including a Flush)
+	double WorstFrameMs = 0.0;
+};
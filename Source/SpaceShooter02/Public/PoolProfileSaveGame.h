@@ -0,0 +1,51 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SaveGame.h"
+#include "PoolProfileSaveGame.generated.h"
+
+// Occupancy numbers recorded for a single object pool during one run
+USTRUCT(BlueprintType)
+struct FPoolProfileData
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+	FString ToString() const;
+
+public:
+	// Total number of actors in the pool at the time the profile was recorded
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 PoolSize = 0;
+
+	// Highest number of simultaneously active actors
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 PeakNumActive = 0;
+
+	// Number of times an actor was requested while every actor was in use
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumMisses = 0;
+
+	// Number of times the pool was grown at runtime
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumGrowEvents = 0;
+};
+
+// Pool occupancy profile saved next to the regular save game. Used to size each object pool at startup.
+UCLASS()
+class SPACESHOOTER02_API UPoolProfileSaveGame : public USaveGame
+{
+	GENERATED_BODY()
+
+public:
+	void RecordPoolProfile(const class FPoolActorContainerBase& Pool);
+	const FPoolProfileData* FindPoolProfile(FName PoolName) const { return PoolProfiles.Find(PoolName); }
+	const TMap<FName, FPoolProfileData>& GetPoolProfiles() const { return PoolProfiles; }
+
+private:
+	// Occupancy data of the last run, keyed by pool name
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	TMap<FName, FPoolProfileData> PoolProfiles;
+};
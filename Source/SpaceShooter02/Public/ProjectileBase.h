@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 
 #include "PoolActor.h"
+#include "ProjectileModifiers.h"
+#include "ProjectileShapeKernels.h"
 
 #include "ProjectileBase.generated.h"
 
@@ -18,28 +20,54 @@ public:
 	
 public:	
 	AProjectileBase();
-	virtual void Tick(float DeltaTime) override;
+	virtual FPoolActorBatchTickFunction GetPoolActorBatchTickFunction() const override { return &AProjectileBase::BatchTickProjectiles; }
+	virtual void ActivatePoolObject() override;
+
+	// Projectiles get a new instigator every time they are fired (and homing projectiles a new target), so they stay out of GC clusters
+	virtual bool CanBeInCluster() const override { return false; }
+
+	// Projectile settings, also read from the class default object by AProjectileManager
+	float GetMoveSpeed() const { return MoveSpeed; }
+	float GetDamage() const { return Damage; }
+	class UNiagaraSystem* GetProjectileImpactEffect() const { return ProjectileImpactEffect; }
+	class UPaperSprite* GetProjectileSprite() const;
+	class UMaterialInterface* GetProjectileSpriteMaterial() const;
+	FLinearColor GetProjectileSpriteColor() const;
+	FTransform GetProjectileSpriteRelativeTransform() const;
+	int32 GetRicochetCount() const { return RicochetCount; }
+	int32 GetPierceCount() const { return PierceCount; }
+
+	// Radius of a circle enclosing the collision shape on the XZ plane, relative to the projectile's scale
+	float GetCollisionRadius() const;
+
+	// Half size of the collision shape on the XZ plane before rotation (X across the projectile, Y along its movement),
+	// relative to the projectile's scale
+	FVector2D GetCollisionHalfExtent() const;
+
+	// Shape kernel used to sweep projectiles of this class against enemies
+	virtual EProjectileShape GetProjectileShape() const; // PURE_VIRTUAL(GetProjectileShape, ;)
+
+	// Location at the start of this frame's movement. Hits are tested along the path from here to the current location.
+	const FVector& GetMovementStartLocation() const { return MovementStartLocation; }
+
+	// Called by the combat collision subsystem when this projectile touches an enemy
+	virtual void OnEnemyHit(class AEnemyBase* Enemy);
 
 protected:
 	virtual void BeginPlay() override;
 	virtual void BeginDestroy() override;
 
-	virtual FVector GetInactivePoolObjectPosition() const override;
 
 	void CreateProjectileDefaultSubobjects(); // Should be called in the constructor of any subclass. Will create all the proper default subobjects.
 	virtual TSubclassOf<class UShapeComponent> GetCollisionVolumeComponentClass() const; // PURE_VIRTUAL(GetCollisionVolumeComponentClass, ;)
 	virtual const TCHAR* GetDefaultSpritePath() const; // PURE_VIRTUAL(GetDefaultSpritePath, ;)
 
 	virtual void UpdateMovement(float DeltaTime);
+	static void BatchTickProjectiles(TArrayView<APoolActor* const> PoolActors, float DeltaTime);
+
+	// Uses up a pierce after hitting an enemy. Deactivates this projectile and returns false if it has none left.
+	bool ConsumeEnemyPierce();
 
-	UFUNCTION()
-	virtual void OnCollisionOverlap(
-		UPrimitiveComponent* OverlappedComponent,
-		AActor* OtherActor,
-		UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex,
-		bool bFromSweep,
-		const FHitResult& SweepResult);
 
 private:
 	void CreateCollisionVolumeComponent(TSubclassOf<UShapeComponent> CollisionVolumeClass);
@@ -72,10 +100,28 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProjectileBase|Behavior", meta = (ClampMin = "0"))
 	float Damage = 100.0f;
 
+	// Number of walls this projectile bounces off before it is destroyed by one
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProjectileBase|Behavior", meta = (ClampMin = "0", ClampMax = "127"))
+	int32 RicochetCount = 0;
+
+	// Number of enemies this projectile passes through before it is spent. -1 to pass through every enemy.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProjectileBase|Behavior", meta = (ClampMin = "-1", ClampMax = "127"))
+	int32 PierceCount = -1;
+
+	// Bounces and pierces left. Reset from RicochetCount and PierceCount on activation.
+	FProjectileModifierCounters ModifierCounters;
+
+	// Answers wall collision queries without physics traces
+	TWeakObjectPtr<class UArenaCollisionSubsystem> ArenaCollision;
+
+	// Plays the impact effect from a pool of components
+	TWeakObjectPtr<class UImpactEffectSubsystem> ImpactEffects;
+
+	// Location before this frame's movement. Set to the spawn location on activation.
+	FVector MovementStartLocation = FVector::ZeroVector;
+
 	// NOTE: This is just temporary. This MUST be moved into a ProjectileController once pooling is implemented!
 	// Each Projectile should NOT be carrying a hard reference to an asset like this!
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	TObjectPtr<class UNiagaraSystem> ProjectileImpactEffect;
-
-	static const FVector InactivePosition;
 };
@@ -15,18 +15,12 @@ class SPACESHOOTER02_API AProjectileCircular : public AProjectileBase
 public:	
 	AProjectileCircular();
 	virtual void Tick(float DeltaTime) override;
+	virtual void OnEnemyHit(class AEnemyBase* Enemy) override;
+	virtual EProjectileShape GetProjectileShape() const override { return EProjectileShape::Circle; }
 
 protected:
 	virtual void BeginPlay() override;
 
 	virtual TSubclassOf<class UShapeComponent> GetCollisionVolumeComponentClass() const override;
 	virtual const TCHAR* GetDefaultSpritePath() const override;
-
-	virtual void OnCollisionOverlap(
-		UPrimitiveComponent* OverlappedComponent,
-		AActor* OtherActor,
-		UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex,
-		bool bFromSweep,
-		const FHitResult& SweepResult) override;
 };
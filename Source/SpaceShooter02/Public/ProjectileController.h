@@ -4,8 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+
+#include "PoolGrowthSettings.h"
+
 #include "ProjectileController.generated.h"
 
+// Configures the projectile pool. The pool itself is owned by USpaceShooterPoolSubsystem.
+// If bUseProjectileManager is set, projectiles are simulated by an AProjectileManager instead of pooled actors.
 UCLASS(Abstract, Blueprintable)
 class SPACESHOOTER02_API UProjectileController : public UObject
 {
@@ -14,18 +19,45 @@ class SPACESHOOTER02_API UProjectileController : public UObject
 public:
 	void InitProjectilePool();
 	void ResetProjectilePool();
-	class AProjectileBase* GetInactiveProjectile();
+
+	// Fires one projectile per transform. The projectiles are acquired from the pool together, set up, then activated
+	// together. Returns the number of projectiles fired.
+	int32 FireVolley(TConstArrayView<FTransform> FireTransforms, APawn* InInstigator);
+
+	// Fires one homing projectile per transform, the same way as FireVolley. Homing projectiles are always pooled actors.
+	// Fires regular projectiles if there is no homing projectile class.
+	int32 FireHomingVolley(TConstArrayView<FTransform> FireTransforms, APawn* InInstigator);
 
 private:
-	class AProjectileBase* CreateAndAddNewProjectile();
+	class AProjectileBase* GetInactiveProjectile(TSubclassOf<class AProjectileBase> Class);
+
+	// Fires projectiles of the given class from its pool, bypassing the projectile manager
+	bool FirePooledProjectile(TSubclassOf<class AProjectileBase> Class, const FVector& Position, const FRotator& Rotation, APawn* InInstigator);
+	int32 FirePooledVolley(TSubclassOf<class AProjectileBase> Class, TConstArrayView<FTransform> FireTransforms, APawn* InInstigator);
 
 private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	TSubclassOf<class AProjectileBase> ProjectileClass;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = true))
-	TArray<TObjectPtr<class AProjectileBase>> ProjectilePool;
+	// Projectile fired by FireHomingVolley (e.g. by the player ship's satellite weapons at the highest powerup levels). Optional.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	TSubclassOf<class AProjectileBase> HomingProjectileClass;
+
+	// How the projectile pools grow when they run out, and when they shrink back
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	FPoolGrowthSettings GrowthSettings;
+
+	// If true, every projectile is simulated by a single projectile manager instead of one pooled actor each
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	bool bUseProjectileManager = false;
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	TObjectPtr<class AProjectileManager> ProjectileManager;
+
+	// Projectiles of the volley being fired (kept to avoid reallocating every volley)
+	TArray<class APoolActor*> VolleyProjectiles;
 
 private:
 	static constexpr int32 MAX_PROJECTILES = 500;
+	static constexpr int32 MAX_HOMING_PROJECTILES = 200;
 };
@@ -0,0 +1,58 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProjectileCircular.h"
+#include "ProjectileHoming.generated.h"
+
+// Circular projectile that steers towards the nearest enemy.
+// The target is cached and only searched for again once it is destroyed (or was never found, after a short delay). Every projectile of the
+// pool that needs a new target is batched into a single parallel query against the combat collision subsystem's enemy grid.
+UCLASS(Blueprintable)
+class SPACESHOOTER02_API AProjectileHoming : public AProjectileCircular
+{
+	GENERATED_BODY()
+
+public:
+	AProjectileHoming();
+	virtual FPoolActorBatchTickFunction GetPoolActorBatchTickFunction() const override { return &AProjectileHoming::BatchTickHomingProjectiles; }
+	virtual void ActivatePoolObject() override;
+	virtual void OnEnemyHit(class AEnemyBase* Enemy) override;
+
+protected:
+	virtual void BeginPlay() override;
+	static void BatchTickHomingProjectiles(TArrayView<APoolActor* const> PoolActors, float DeltaTime);
+
+private:
+	// Whether the cached target is still the enemy that was targeted (i.e. has not been destroyed or reused by its pool)
+	bool HasValidHomingTarget() const;
+	void SetHomingTarget(class AEnemyBase* Enemy);
+
+	// Turns towards the target, no faster than the turn rate
+	void SteerTowardsHomingTarget(float DeltaTime);
+
+private:
+	// How quickly this projectile turns towards its target (degrees per second)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProjectileHoming|Behavior", meta = (ClampMin = "0", AllowPrivateAccess = true))
+	float TurnRateDegreesPerSecond = 360.0f;
+
+	// Enemies further away than this are not targeted
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ProjectileHoming|Behavior", meta = (ClampMin = "0", AllowPrivateAccess = true))
+	float HomingSearchRadius = 2000.0f;
+
+	UPROPERTY(Transient)
+	TObjectPtr<class AEnemyBase> HomingTarget;
+
+	// Activation serial of the target when it was targeted
+	uint32 HomingTargetSerial = 0;
+
+	// Time until the next target search, after a search that found nothing
+	float RetargetDelaySeconds = 0.0f;
+
+	// Index of this projectile's queued nearest enemy query during a batch tick, or INDEX_NONE
+	int32 RetargetQueryIndex = INDEX_NONE;
+
+	// Finds the nearest enemies for every projectile that needs a new target
+	TWeakObjectPtr<class UCombatCollisionSubsystem> CombatCollision;
+};
@@ -0,0 +1,159 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "ProjectileModifiers.h"
+#include "ProjectileShapeKernels.h"
+
+#include "ProjectileManager.generated.h"
+
+// What the projectiles of a projectile manager hit
+enum class EProjectileManagerTarget : uint8
+{
+	// Fired by the player. Swept against the enemies.
+	Enemies,
+
+	// Fired by enemies. Tested against the player ship.
+	Player,
+};
+
+// Simulates every projectile of one projectile class without an actor per projectile.
+// Projectile state is stored in structure-of-arrays form (one array per field) and advanced in one loop per frame.
+// All projectiles are drawn as instances of a single grouped sprite component. The projectile class's default object
+// provides the speed, sprite, collision size, lifetime, ricochet and pierce counts, and impact effect.
+// Enemy hits are resolved by the combat collision subsystem, which queries every registered manager's projectiles.
+UCLASS(NotBlueprintable)
+class SPACESHOOTER02_API AProjectileManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	DECLARE_LOG_CATEGORY_CLASS(LogProjectileManager, Log, All)
+
+public:
+	AProjectileManager();
+	virtual void Tick(float DeltaTime) override;
+
+	// Reads the settings of the given projectile class and reserves space for InitialCapacity projectiles
+	void InitProjectileManager(TSubclassOf<class AProjectileBase> InProjectileClass, int32 InitialCapacity, EProjectileManagerTarget InTarget = EProjectileManagerTarget::Enemies);
+
+	// Adds a projectile moving along Direction (a unit vector on the XZ plane) at Speed, instead of the class's speed
+	void FireProjectile(const FVector& Position, const FVector& Direction, float Speed, AActor* InOwner);
+
+	// Adds one projectile per transform
+	void FireVolley(TConstArrayView<FTransform> FireTransforms, AActor* InOwner);
+
+	// Spends the projectile. It is removed on the next update.
+	void ExpireProjectile(int32 ProjectileIndex) { Projectiles.RemainingLifetimes[ProjectileIndex] = 0.0f; }
+
+	// Called by the combat collision subsystem when projectile ProjectileIndex touches an enemy. Destroys the enemy, and
+	// spends the projectile unless it can pierce it.
+	void OnProjectileHitEnemy(int32 ProjectileIndex, class AEnemyBase* Enemy);
+
+	// Removes every projectile
+	void ResetProjectiles();
+
+	int32 GetNumProjectiles() const { return Projectiles.Num(); }
+	TConstArrayView<FVector> GetProjectilePositions() const { return Projectiles.Positions; }
+	TConstArrayView<FVector> GetProjectilePreviousPositions() const { return Projectiles.PreviousPositions; }
+	TConstArrayView<FVector> GetProjectileDirections() const { return Projectiles.Directions; }
+
+	// Collision settings of the projectile class
+	EProjectileManagerTarget GetTarget() const { return Target; }
+	EProjectileShape GetProjectileShape() const { return ProjectileShape; }
+	float GetCollisionRadius() const { return CollisionRadius; }
+	FVector2D GetCollisionHalfExtent() const { return CollisionHalfExtent; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	// Moves every projectile and counts down its lifetime
+	void UpdateMovement(float DeltaTime);
+
+	// Bounces projectiles that hit a level border this frame off it, or expires them if they have no bounces left.
+	// Projectiles that somehow left the arena are expired as well.
+	void UpdateArenaCollision();
+
+	// Removes every projectile whose lifetime ran out
+	void RemoveExpiredProjectiles();
+
+	// Writes every projectile's transform to its sprite instance
+	void UpdateSpriteInstances();
+
+private:
+	// Projectile state. Index i of every array belongs to projectile i. Sprite instance i draws projectile i.
+	struct FProjectileArrays
+	{
+		TArray<FVector> Positions;
+
+		// Positions at the start of the frame. Projectile movement this frame is the segment from here to Positions.
+		TArray<FVector> PreviousPositions;
+
+		TArray<FVector> Directions;
+		TArray<FQuat> Rotations;
+		TArray<float> Speeds;
+		TArray<float> RemainingLifetimes;
+		TArray<FProjectileModifierCounters> ModifierCounters;
+		TArray<TWeakObjectPtr<AActor>> Owners;
+
+		int32 Num() const { return Positions.Num(); }
+		void Reserve(int32 Number);
+		void Add(const FVector& Position, const FVector& Direction, const FQuat& Rotation, float Speed, float Lifetime, FProjectileModifierCounters Counters, AActor* Owner);
+
+		// Removes the projectile at the given index by moving the last projectile into its place
+		void RemoveAtSwap(int32 Index);
+		void Reset();
+	};
+
+	FProjectileArrays Projectiles;
+
+	// Draws every projectile
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	TObjectPtr<class UPaperGroupedSpriteComponent> GroupedSpriteComp;
+
+	// Class the projectile settings are read from
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	TSubclassOf<class AProjectileBase> ProjectileClass;
+
+	// --- Projectile Class Settings ---
+
+	UPROPERTY(Transient)
+	TObjectPtr<class UPaperSprite> ProjectileSprite;
+
+	UPROPERTY(Transient)
+	TObjectPtr<class UNiagaraSystem> ProjectileImpactEffect;
+
+	// Transform of the sprite relative to the projectile
+	FTransform SpriteRelativeTransform;
+	FLinearColor SpriteColor = FLinearColor::White;
+
+	float MoveSpeed = 0.0f;
+	float CollisionRadius = 0.0f;
+	FVector2D CollisionHalfExtent = FVector2D::ZeroVector;
+	EProjectileShape ProjectileShape = EProjectileShape::Circle;
+	float LifeTimeSeconds = 0.0f;
+
+	// Bounces and pierces every projectile starts with
+	FProjectileModifierCounters InitialModifierCounters;
+
+	EProjectileManagerTarget Target = EProjectileManagerTarget::Enemies;
+
+	// Answers wall collision queries for every projectile in one batch
+	TWeakObjectPtr<class UArenaCollisionSubsystem> ArenaCollision;
+
+	// Plays the impact effect from a pool of components
+	TWeakObjectPtr<class UImpactEffectSubsystem> ImpactEffects;
+
+	// --- Scratch Arrays (kept to avoid reallocating every frame) ---
+
+	TArray<struct FArenaHit> ArenaHits;
+	TArray<int32> OutsideArenaIndices;
+
+	// Number of sprite instances that currently draw a projectile. Instances past the projectile count are collapsed.
+	int32 NumVisibleSpriteInstances = 0;
+};
@@ -0,0 +1,88 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Ricochet and pierce counters of one projectile, packed into two bytes so they can sit next to the rest of the
+// projectile's state (e.g. as one more array of AProjectileManager's structure-of-arrays)
+struct FProjectileModifierCounters
+{
+	// Number of walls the projectile can still bounce off
+	uint16 RemainingBounces : 7;
+
+	// Number of enemies the projectile can still pass through
+	uint16 RemainingPierces : 7;
+
+	// If set, the projectile passes through every enemy and RemainingPierces is ignored
+	uint16 bPiercesEveryEnemy : 1;
+
+	// Largest number of bounces or pierces that fits in the counters
+	static constexpr int32 MaxCount = 127;
+
+	FProjectileModifierCounters()
+		: RemainingBounces(0)
+		, RemainingPierces(0)
+		, bPiercesEveryEnemy(0)
+	{
+	}
+
+	// A negative NumPierces passes through every enemy
+	FProjectileModifierCounters(int32 NumBounces, int32 NumPierces)
+		: RemainingBounces(FMath::Clamp(NumBounces, 0, MaxCount))
+		, RemainingPierces(FMath::Clamp(NumPierces, 0, MaxCount))
+		, bPiercesEveryEnemy(NumPierces < 0 ? 1 : 0)
+	{
+	}
+
+	// Uses up a bounce. Returns false if there are none left, in which case the projectile stops at the wall.
+	bool ConsumeBounce()
+	{
+		if (RemainingBounces == 0)
+		{
+			return false;
+		}
+		--RemainingBounces;
+		return true;
+	}
+
+	// Uses up a pierce. Returns false if there are none left, in which case the projectile is spent on the enemy it hit.
+	bool ConsumePierce()
+	{
+		if (bPiercesEveryEnemy)
+		{
+			return true;
+		}
+		if (RemainingPierces == 0)
+		{
+			return false;
+		}
+		--RemainingPierces;
+		return true;
+	}
+};
+static_assert(sizeof(FProjectileModifierCounters) == sizeof(uint16), "Projectile modifier counters should stay packed");
+
+// Bounces projectiles off walls using the analytic wall normals of UArenaCollisionSubsystem, on the XZ plane
+struct FProjectileRicochet
+{
+	// Distance a bounced projectile is moved off the wall, so its next movement does not hit the same wall at time 0
+	static constexpr float WallSeparation = 0.1f;
+
+	// Reflects a movement that hit a wall. The remaining distance of the movement is travelled along the reflected direction.
+	// Updates the direction and the rotation (whose "up" is the direction) and returns the new end of the movement.
+	static FVector Bounce(const FVector& ImpactPoint, const FVector& ImpactNormal, float RemainingDistance, FVector& InOutDirection, FQuat& InOutRotation)
+	{
+		const FVector OldDirection = InOutDirection;
+		InOutDirection = FMath::GetReflectionVector(OldDirection, ImpactNormal);
+
+		// Turn about the world Y axis (the axis facing the camera), so the rotation stays on the plane even when the
+		// projectile is sent straight back
+		const double TurnAngle = FMath::Atan2(
+			OldDirection.Z * InOutDirection.X - OldDirection.X * InOutDirection.Z,
+			OldDirection.X * InOutDirection.X + OldDirection.Z * InOutDirection.Z);
+		InOutRotation = FQuat(FVector::YAxisVector, TurnAngle) * InOutRotation;
+
+		return ImpactPoint + ImpactNormal * WallSeparation + InOutDirection * RemainingDistance;
+	}
+};
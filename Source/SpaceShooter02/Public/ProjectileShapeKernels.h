@@ -0,0 +1,82 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "SweptCollision2D.h"
+
+// Collision shape of a projectile class
+enum class EProjectileShape : uint8
+{
+	Circle,
+	OrientedBox,
+};
+
+// Shape kernels used to sweep projectiles against enemy bounding boxes.
+// Every kernel has the same interface, so batch loops are written once as templates over the shape type and each batch
+// runs a single kernel without virtual calls or per-projectile shape branches.
+
+// Circle of a fixed radius
+struct FCircleProjectileShape
+{
+	float Radius = 0.0f;
+
+	// Half size of the shape's axis-aligned bounding box
+	FVector2D GetBoundsExtent() const { return FVector2D(Radius); }
+
+	bool SweepVsBox(const FVector2D& Start, const FVector2D& Delta, const FVector2D& BoxCenter, const FVector2D& BoxHalfExtent, float& OutTime) const
+	{
+		return FSweptCollision2D::SweptCircleVsBox(Start, Delta, Radius, BoxCenter, BoxHalfExtent, OutTime);
+	}
+};
+
+// Box rotated to face Forward (a unit vector). HalfExtent.X is across Forward and HalfExtent.Y is along it.
+struct FOrientedBoxProjectileShape
+{
+	FVector2D Forward = FVector2D(0.0, 1.0);
+	FVector2D HalfExtent = FVector2D::ZeroVector;
+
+	// Half size of the shape's axis-aligned bounding box
+	FVector2D GetBoundsExtent() const
+	{
+		return FVector2D(
+			HalfExtent.X * FMath::Abs(Forward.Y) + HalfExtent.Y * FMath::Abs(Forward.X),
+			HalfExtent.X * FMath::Abs(Forward.X) + HalfExtent.Y * FMath::Abs(Forward.Y));
+	}
+
+	bool SweepVsBox(const FVector2D& Start, const FVector2D& Delta, const FVector2D& BoxCenter, const FVector2D& BoxHalfExtent, float& OutTime) const
+	{
+		return FSweptCollision2D::SweptOrientedBoxVsBox(Start, Delta, Forward, HalfExtent, BoxCenter, BoxHalfExtent, OutTime);
+	}
+};
+
+// Projectiles of one shape, in structure-of-arrays form. Index i of every array belongs to projectile i.
+template<typename ShapeType>
+struct TProjectileBatch
+{
+	TArray<ShapeType> Shapes;
+	TArray<FVector2D> Starts;
+	TArray<FVector2D> Deltas;
+
+	// Caller-defined index of each projectile (e.g. into a list of projectile actors)
+	TArray<int32> ProjectileIndices;
+
+	int32 Num() const { return Shapes.Num(); }
+
+	void Add(const ShapeType& Shape, const FVector2D& Start, const FVector2D& End, int32 ProjectileIndex)
+	{
+		Shapes.Add(Shape);
+		Starts.Add(Start);
+		Deltas.Add(End - Start);
+		ProjectileIndices.Add(ProjectileIndex);
+	}
+
+	void Reset()
+	{
+		Shapes.Reset();
+		Starts.Reset();
+		Deltas.Reset();
+		ProjectileIndices.Reset();
+	}
+};
@@ -0,0 +1,42 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+SPACESHOOTER02_API DECLARE_LOG_CATEGORY_EXTERN(LogSpaceShooterBenchmark, Log, All);
+
+// Shared setup of the SpaceShooter.Benchmark* console commands.
+// Every benchmark draws from the same fixed seed, so runs are comparable, and scatters its items over an area sized
+// like the game's arena. Results are logged to LogSpaceShooterBenchmark.
+class SPACESHOOTER02_API FSpaceShooterBenchmark
+{
+public:
+	FSpaceShooterBenchmark();
+
+	// Area sized like the game's arena, on the XZ plane (world X maps to X and world Z maps to Y)
+	static FBox2D GetArenaBounds();
+
+	FRandomStream& GetRandomStream() { return RandomStream; }
+
+	// Random position within the bounds
+	FVector2D RandomPosition() { return RandomPosition(GetArenaBounds()); }
+	FVector2D RandomPosition(const FBox2D& Bounds);
+
+	// Random unit direction on the XZ plane
+	FVector2D RandomDirection();
+
+	// Calls Function once and returns how long it took (milliseconds)
+	template<typename FunctionType>
+	static double TimeMilliseconds(FunctionType&& Function)
+	{
+		const double StartTimeSeconds = FPlatformTime::Seconds();
+		Function();
+		return (FPlatformTime::Seconds() - StartTimeSeconds) * 1000.0;
+	}
+
+private:
+	FRandomStream RandomStream;
+};
+#endif // !UE_BUILD_SHIPPING
@@ -74,6 +74,17 @@ public:
 
 	FString GetGameVersionString() const;
 
+	// --- Pool Profile ---
+
+	// Returns the size a pool should be created with: the profiled peak occupancy plus headroom, or DefaultPoolSize if the pool has no profile
+	int32 GetProfiledPoolSize(FName PoolName, int32 DefaultPoolSize) const;
+
+	// Records the occupancy of a pool for the current run (does NOT save)
+	void RecordPoolProfile(const class FPoolActorContainerBase& Pool);
+
+	// Writes the pool profile to disk
+	void SavePoolProfile();
+
 protected:
 	virtual void Init() override;
 	virtual void OnStart() override;
@@ -111,6 +122,20 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	TObjectPtr<class USpaceShooterSaveGame> SpaceShooterSaveGame;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	FString PoolProfileSaveSlotName = "PoolProfile";
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	TObjectPtr<class UPoolProfileSaveGame> PoolProfileSaveGame;
+
+	// Extra capacity added on top of each pool's profiled peak occupancy (0.25 = 25%)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true, ClampMin = "0.0", UIMin = "0.0"))
+	float PoolSizeHeadroom = 0.25f;
+
+	// Profiled pools are never created smaller than this
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true, ClampMin = "1", UIMin = "1"))
+	int32 MinProfiledPoolSize = 8;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	TArray<TObjectPtr<class UPaperSprite>> ShipSprites;
 
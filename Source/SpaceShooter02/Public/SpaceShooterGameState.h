@@ -63,8 +63,13 @@ public:
 	// --- Difficulty Scaling ---
 
 	float GetTimeBetweenSpawns() const { return CurrentTimeBetweenSpawns; }
+	int32 GetDifficultyLevel() const { return CurrentDifficultyLevel; }
 
-	void FireProjectile(FVector ProjectilePosition, FRotator ProjectileRotation, APawn* InInstigator);
+	// Fires one projectile per transform, e.g. from every fire point of the player ship on one trigger pull
+	void FireVolley(TConstArrayView<FTransform> FireTransforms, APawn* InInstigator);
+
+	// Fires one homing projectile per transform
+	void FireHomingVolley(TConstArrayView<FTransform> FireTransforms, APawn* InInstigator);
 
 protected:
 	virtual void BeginPlay() override;
@@ -74,7 +79,7 @@ protected:
 	UFUNCTION()
 	void OnPlayerShipDestroyed();
 	UFUNCTION()
-	void OnEnemyDeath(FVector EnemyDeathPosition, class UNiagaraSystem* EnemyDeathEffect, bool bKilledFromBoost);
+	void OnEnemyDeath(FVector EnemyDeathPosition, class UNiagaraSystem* EnemyDeathEffect, bool bKilledFromBoost, int32 EnemyScoreValue);
 	UFUNCTION()
 	void OnScoreMultiplierPickedUp(int32 ScoreMultiplierValue);
 
@@ -151,10 +156,6 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
 	int32 CurrentScoreMultiplier = 1;
 
-	// Enemy score value -- TODO: Move to enemy class or data object
-	UPROPERTY(EditAnywhere, BlueprintReadOnly)
-	int32 EnemyScoreValue = 1; // first implementation: all enemies have a score value of 1
-
 	// The player's high score at the start of a game
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
 	int32 PlayerHighScore = 0;
@@ -231,6 +232,12 @@ protected:
 
 	// ----------------------------------------------------------
 
+	// --- Pool Pre-warming ---
+
+	// Max time per frame spent creating pooled actors while the menus are showing
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin = "0.1", UIMin = "0.1"))
+	float PoolPrewarmFrameBudgetMs = 2.0f;
+
 	// --- Projectile Controller ---
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
@@ -0,0 +1,205 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "PoolActorContainer.h"
+#include "PoolGrowthSettings.h"
+#include "PoolLifetimeWheel.h"
+#include "UObjectCreationTracker.h"
+
+#include "SpaceShooterPoolSubsystem.generated.h"
+
+// Owns every object pool in the world, keyed by pooled actor class.
+// Gameplay code acquires any pooled actor through AcquirePoolActor, so every pooled type shares the same free-list
+// acquisition, profile-based sizing, pre-warming, growth and shrink behaviour.
+// Settings are read from the [/Script/SpaceShooter02.SpaceShooterPoolSubsystem] section of DefaultGame.ini.
+UCLASS(config = Game)
+class SPACESHOOTER02_API USpaceShooterPoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// UTickableWorldSubsystem Begin
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(USpaceShooterPoolSubsystem, STATGROUP_Tickables);
+	}
+	// UTickableWorldSubsystem End
+
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+	// Creates the pool for the given class. The pool size comes from the pool profile (or DefaultPoolSize) and the
+	// actors are created over several frames by the pre-warm scheduler. Does nothing if the pool already exists.
+	void CreatePool(TSubclassOf<APoolActor> PoolActorClass, int32 DefaultPoolSize, const FPoolGrowthSettings& GrowthSettings);
+
+	// Returns an inactive actor of the given class, growing its pool if needed. The pool must have been created.
+	APoolActor* AcquirePoolActor(TSubclassOf<APoolActor> PoolActorClass);
+
+	template<typename PoolActorType>
+	PoolActorType* AcquirePoolActor(TSubclassOf<PoolActorType> PoolActorClass)
+	{
+		return Cast<PoolActorType>(AcquirePoolActor(TSubclassOf<APoolActor>(PoolActorClass)));
+	}
+
+	// Appends up to Num distinct inactive actors of the given class in one go, e.g. for every projectile of a volley.
+	// Does not grow the pool. If fewer than Num are returned, acquire (and activate) the rest one at a time with AcquirePoolActor.
+	int32 AcquirePoolActors(TSubclassOf<APoolActor> PoolActorClass, int32 Num, TArray<APoolActor*>& OutPoolActors);
+
+	// Deactivates every active actor in the given class's pool
+	void ResetPool(TSubclassOf<APoolActor> PoolActorClass);
+
+	// Starts deactivating every active actor in every pool, spread evenly over DurationSeconds and capped by TeardownFrameBudgetMs
+	// per frame. FinishAmortizedReset must be called once the duration has passed.
+	void BeginAmortizedReset(float DurationSeconds);
+
+	// Deactivates whatever the amortized reset has not reached yet (including actors activated since it began) and ends it
+	void FinishAmortizedReset();
+
+	bool IsAmortizedResetInProgress() const { return bAmortizedResetInProgress; }
+
+	// Max time per frame spent deactivating pooled actors during an amortized reset
+	float GetTeardownFrameBudgetMs() const;
+
+	// Appends every active actor of PoolActorType (or any subclass of it), across every pool
+	template<typename PoolActorType>
+	void GetActivePoolActors(TArray<PoolActorType*>& OutPoolActors) const
+	{
+		for (const TPair<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>>& PoolPair : Pools)
+		{
+			if (PoolPair.Key->IsChildOf(PoolActorType::StaticClass()))
+			{
+				PoolPair.Value->ForEachActive([&OutPoolActors](APoolActor* PoolActor)
+				{
+					OutPoolActors.Add(static_cast<PoolActorType*>(PoolActor));
+				});
+			}
+		}
+	}
+
+	// Calls Function(PoolActorClass, Pool) for every pool of PoolActorType (or any subclass of it). Lets callers read the
+	// class defaults once per pool rather than once per actor.
+	template<typename PoolActorType, typename FunctionType>
+	void ForEachPool(FunctionType&& Function) const
+	{
+		for (const TPair<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>>& PoolPair : Pools)
+		{
+			if (PoolPair.Key->IsChildOf(PoolActorType::StaticClass()))
+			{
+				Function(PoolPair.Key, *PoolPair.Value);
+			}
+		}
+	}
+
+	FPoolActorContainerBase* FindPool(TSubclassOf<APoolActor> PoolActorClass) const;
+
+	// Creates every actor still waiting to be pre-warmed
+	void FlushPrewarm();
+	void SetPrewarmFrameBudgetMs(float InPrewarmFrameBudgetMs);
+
+	// While enabled, idle pools shrink back to their startup size. Enable only while no game is running.
+	void SetPoolShrinkEnabled(bool bInPoolShrinkEnabled);
+
+	// Logs the stats of every pool and writes them to the pool profile
+	void RecordPoolProfiles();
+
+	// Queues a pooled actor's visibility / collision / tick change. Every queued change is applied once, after all actors have ticked.
+	void QueuePoolObjectStateChange(APoolActor* PoolActor);
+
+	// Applies every queued state change now
+	void FlushPoolObjectStateChanges();
+
+	// Groups every pooled actor into one GC cluster, so garbage collection stops traversing them individually.
+	// Call once the pools are filled (e.g. at game start). Actors created later are not in the cluster.
+	void ClusterPoolActors();
+
+	// Releases the pooled actors from their GC cluster. Must be called before pooled actors are destroyed (e.g. before the pools shrink).
+	void DissolvePoolActorCluster();
+
+	// Starts / stops counting the UObjects created during gameplay. Steady-state gameplay should create none.
+	// Actors created by pool growth are not counted. While counting, the first frame that creates a UObject logs a
+	// warning naming the classes created. Stopping logs the count, the number of frames that created UObjects and the
+	// classes that were created. Does nothing in shipping builds.
+	void BeginGameplayObjectCreationTracking();
+	void EndGameplayObjectCreationTracking();
+
+#if !UE_BUILD_SHIPPING
+	bool IsTrackingGameplayObjectCreation() const { return GameplayObjectCreationTracker.IsTracking(); }
+
+	// Frames checked since tracking started, and how many of them created a UObject
+	int32 GetNumGameplayFramesTracked() const { return NumGameplayFramesTracked; }
+	int32 GetNumGameplayFramesCreatingObjects() const { return NumGameplayFramesCreatingObjects; }
+#endif
+
+	// Deactivates the actor at ExpiryTimeSeconds (world time), unless it is deactivated or paused before then
+	void ScheduleLifetimeExpiry(APoolActor* PoolActor, double ExpiryTimeSeconds);
+
+private:
+	APoolActor* CreateAndAddPoolActor(TSubclassOf<APoolActor> PoolActorClass);
+
+	void UpdateAmortizedReset(float DeltaTime);
+	void UpdatePoolShrink(float DeltaTime);
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaTime);
+
+	// Checks whether any UObject was created since the last frame while gameplay object creation is tracked
+	void CheckGameplayObjectCreation();
+
+private:
+	// Every pool, keyed by pooled actor class. Pools are heap allocated because pooled actors point back at them.
+	TMap<TSubclassOf<APoolActor>, TUniquePtr<TPoolActorContainer<APoolActor>>> Pools;
+
+	// Spreads the creation of every pool's actors over several frames
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	TObjectPtr<class UPoolPrewarmScheduler> PrewarmScheduler;
+
+	// How often idle pools are checked for shrinking (seconds)
+	UPROPERTY(Config)
+	float PoolShrinkCheckInterval = 1.0f;
+
+	bool bPoolShrinkEnabled = false;
+	float TimeSinceLastShrinkCheck = 0.0f;
+
+	// Max time per frame spent deactivating pooled actors during an amortized reset
+	UPROPERTY(Config)
+	float TeardownFrameBudgetMs = 1.0f;
+
+	bool bAmortizedResetInProgress = false;
+	float AmortizedResetTimeRemaining = 0.0f;
+
+	// GC cluster holding the pooled actors during gameplay
+	UPROPERTY(Transient)
+	TObjectPtr<class UPoolActorCluster> PoolActorCluster;
+
+	// Whether pooled actors are grouped into a GC cluster during gameplay (cooked builds only)
+	UPROPERTY(Config)
+	bool bClusterPoolActors = true;
+
+	// Whether UObjects created during gameplay are counted and logged at game end (non-shipping builds only)
+	UPROPERTY(Config)
+	bool bTrackGameplayObjectCreation = true;
+
+#if !UE_BUILD_SHIPPING
+	FUObjectCreationTracker GameplayObjectCreationTracker;
+	double GameplayObjectCreationTrackingStartTimeSeconds = 0.0;
+
+	// Number of UObjects created as of the last frame checked
+	int32 LastNumGameplayObjectsCreated = 0;
+	int32 NumGameplayFramesTracked = 0;
+	int32 NumGameplayFramesCreatingObjects = 0;
+#endif
+
+	// Expires pooled actors when their lifetime runs out
+	FPoolLifetimeWheel LifetimeWheel;
+
+	// Pooled actors that were activated or deactivated this frame
+	TArray<TWeakObjectPtr<APoolActor>> PendingPoolObjectStateChanges;
+
+	FDelegateHandle WorldPostActorTickHandle;
+};
@@ -19,11 +19,12 @@ public:
 	virtual void ActivatePoolObject() override;
 	virtual void DeactivatePoolObject() override;
 
+	// Length of the spawn animation in seconds. Zero if there is no flipbook.
+	float GetSpawnAnimLength() const;
+
 protected:
 	virtual void BeginPlay() override;
 
-	virtual FVector GetInactivePoolObjectPosition() const override;
-
 	UFUNCTION()
 	void OnSpawnAnimationFinished();
 
@@ -33,6 +34,4 @@ protected:
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	TObjectPtr<class UPaperFlipbookComponent> SpawnAnimFlipbookComp;
-
-	static const FVector InactivePosition;
 };
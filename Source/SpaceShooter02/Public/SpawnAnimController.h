@@ -4,8 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+
+#include "PoolGrowthSettings.h"
+
 #include "SpawnAnimController.generated.h"
 
+// Configures one pool per spawn anim class. The pools themselves are owned by USpaceShooterPoolSubsystem.
 UCLASS(Abstract, Blueprintable)
 class SPACESHOOTER02_API USpawnAnimController : public UObject
 {
@@ -13,20 +17,17 @@ class SPACESHOOTER02_API USpawnAnimController : public UObject
 
 public:
 	void InitSpawnAnimPool();
-	void ResetSpawnAnimPool();
 	class ASpawnAnimBase* GetInactiveSpawnAnim();
 
-private:
-	class ASpawnAnimBase* CreateAndAddNewSpawnAnim(TSubclassOf<class ASpawnAnimBase> SpawnAnimClass);
-
 private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	TArray<TSubclassOf<class ASpawnAnimBase>> SpawnAnimClasses;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = true))
-	TArray<TObjectPtr<class ASpawnAnimBase>> SpawnAnimPool;
+	// How each spawn anim pool grows when it runs out, and when it shrinks back
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
+	FPoolGrowthSettings GrowthSettings;
 
 private:
+	// Total number of spawn anims, split evenly between the spawn anim classes
 	static constexpr int32 MAX_SPAWN_ANIMS = 200;
 };
-
@@ -0,0 +1,22 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Continuous collision tests on a 2D plane (the game is played on the XZ plane, so world X maps to X and world Z maps to Y).
+// Shapes are tested over their whole movement for the frame, so fast movers can not skip past small targets on a long frame.
+// Times are fractions of the movement (0.0 - 1.0).
+struct SPACESHOOTER02_API FSweptCollision2D
+{
+	// Circle moving from Start by Delta against a static axis-aligned box. Reports the earliest time the circle touches the box.
+	// A circle that already overlaps the box at Start hits at time 0.
+	static bool SweptCircleVsBox(const FVector2D& Start, const FVector2D& Delta, float Radius, const FVector2D& BoxCenter, const FVector2D& BoxHalfExtent, float& OutTime);
+
+	// Box moving from Start by Delta against a static axis-aligned box. The moving box is rotated to face Forward (a unit
+	// vector). Its HalfExtent.X is across Forward and HalfExtent.Y is along it. Reports the earliest time the boxes touch.
+	static bool SweptOrientedBoxVsBox(const FVector2D& Start, const FVector2D& Delta, const FVector2D& Forward, const FVector2D& HalfExtent, const FVector2D& BoxCenter, const FVector2D& BoxHalfExtent, float& OutTime);
+
+	// Point moving from Start by Delta against a static circle. Reports the earliest time the point enters the circle.
+	static bool SegmentVsCircle(const FVector2D& Start, const FVector2D& Delta, const FVector2D& Center, float Radius, float& OutTime);
+};
@@ -0,0 +1,50 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TargetRegistrySubsystem.generated.h"
+
+// State of a target, as published by its owner once per frame
+struct FTargetSnapshot
+{
+	FVector Position = FVector::ZeroVector;
+
+	// Movement over the last frame, in units per second
+	FVector Velocity = FVector::ZeroVector;
+
+	bool bAlive = false;
+};
+
+// Publishes the state of everything enemies and pickups move towards, so they can read it by index.
+// Each target's owner writes its snapshot once per frame. Readers keep the target's index instead of a pointer to the
+// actor, so following a target is an array read rather than an object pointer resolution and a virtual location query.
+// Readers that tick before the owner see the snapshot of the previous frame.
+UCLASS()
+class SPACESHOOTER02_API UTargetRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// UWorldSubsystem Begin
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// UWorldSubsystem End
+
+	// Adds a target and returns its index. The target is not alive until its first snapshot is published.
+	int32 RegisterTarget();
+
+	void PublishTarget(int32 TargetIndex, const FVector& Position, const FVector& Velocity, bool bAlive);
+
+	// Snapshot of the target at the index. Returns nullptr if the index is not a registered target.
+	const FTargetSnapshot* GetTarget(int32 TargetIndex) const { return Targets.IsValidIndex(TargetIndex) ? &Targets[TargetIndex] : nullptr; }
+
+	int32 GetNumTargets() const { return Targets.Num(); }
+
+	// The player ship's target is registered when the subsystem is created, so it can be handed out before the ship begins play
+	static constexpr int32 PLAYER_TARGET_INDEX = 0;
+
+private:
+	TArray<FTargetSnapshot> Targets;
+};
@@ -0,0 +1,50 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/UObjectArray.h"
+
+#include <atomic>
+
+// Counts the UObjects created between Start and Stop, to verify that a stretch of gameplay creates no UObjects (and
+// therefore no UObject garbage). Objects created on the game thread are also counted per class, to find the source.
+// Objects created on the game thread inside an FIgnoreScope (e.g. by designed pool growth) are not counted by any tracker.
+class SPACESHOOTER02_API FUObjectCreationTracker : public FUObjectArray::FUObjectCreateListener
+{
+public:
+	struct FIgnoreScope
+	{
+		FIgnoreScope() { check(IsInGameThread()); ++IgnoreDepth; }
+		~FIgnoreScope() { --IgnoreDepth; }
+	};
+
+	FUObjectCreationTracker() = default;
+	virtual ~FUObjectCreationTracker();
+
+	FUObjectCreationTracker(const FUObjectCreationTracker&) = delete;
+	FUObjectCreationTracker& operator=(const FUObjectCreationTracker&) = delete;
+
+	void Start();
+	void Stop();
+	bool IsTracking() const { return bTracking; }
+
+	// Number of UObjects created since Start
+	int32 GetNumCreated() const { return NumCreated.load(std::memory_order_relaxed); }
+
+	// Number of UObjects created on the game thread since Start, per class, sorted from most to least created
+	void GetNumCreatedPerClass(TArray<TPair<FName, int32>>& OutNumCreatedPerClass) const;
+
+	// FUObjectCreateListener Begin
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override;
+	virtual void OnUObjectArrayShutdown() override;
+	// FUObjectCreateListener End
+
+private:
+	std::atomic<int32> NumCreated = 0;
+	TMap<FName, int32> NumCreatedPerClass;
+	bool bTracking = false;
+
+	// Number of FIgnoreScopes open on the game thread
+	static int32 IgnoreDepth;
+};
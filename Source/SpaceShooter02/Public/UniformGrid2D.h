@@ -0,0 +1,171 @@
+// Copyright 2024 Richard Skala
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Uniform grid over a 2D area, rebuilt from scratch from a list of circles (position + radius).
+// Items are bucketed by the cell containing their center using a counting sort, so a rebuild is O(items + cells) and
+// allocates nothing once the arrays have grown. Positions outside the bounds are clamped into the edge cells, so every
+// item can still be found. The game is played on the XZ plane, so world X maps to grid X and world Z maps to grid Y.
+class SPACESHOOTER02_API FUniformGrid2D
+{
+public:
+	// Sets the covered area and cell size. Clears the grid.
+	void Init(const FBox2D& InBounds, float InCellSize);
+	bool IsInitialized() const { return NumCellsX > 0 && NumCellsY > 0; }
+
+	// Rebuilds the grid from the given circles. Item indices used by queries are indices into these arrays.
+	void Build(TConstArrayView<FVector2D> Positions, TConstArrayView<float> Radii);
+
+	// Removes every item
+	void Reset();
+
+	int32 GetNumItems() const { return ItemPositions.Num(); }
+	const FVector2D& GetItemPosition(int32 ItemIndex) const { return ItemPositions[ItemIndex]; }
+	float GetItemRadius(int32 ItemIndex) const { return ItemRadii[ItemIndex]; }
+
+	// Cells are indexed row by row. Each item is in exactly one cell, so cells can be processed in parallel.
+	int32 GetNumCells() const { return NumCellsX * NumCellsY; }
+	TConstArrayView<int32> GetCellItems(int32 CellIndex) const
+	{
+		return MakeArrayView(CellItems.GetData() + CellStarts[CellIndex], CellStarts[CellIndex + 1] - CellStarts[CellIndex]);
+	}
+
+	// Calls Function(ItemIndex) for every item whose circle overlaps the given circle
+	template<typename FunctionType>
+	void ForEachInRadius(const FVector2D& Center, float Radius, FunctionType&& Function) const
+	{
+		const FVector2D RadiusExtent(Radius);
+		ForEachCandidateInBox(FBox2D(Center - RadiusExtent, Center + RadiusExtent), [this, &Center, Radius, &Function](int32 ItemIndex)
+		{
+			const double MaxDistance = Radius + ItemRadii[ItemIndex];
+			if (FVector2D::DistSquared(Center, ItemPositions[ItemIndex]) <= MaxDistance * MaxDistance)
+			{
+				Function(ItemIndex);
+			}
+		});
+	}
+
+	// Calls Function(ItemIndex) for every item in the cells the box touches. Items are not tested against the box, so the
+	// caller is expected to run its own narrowphase test (e.g. a swept shape, whose bounding box is passed in).
+	template<typename FunctionType>
+	void ForEachCandidateInBox(const FBox2D& Box, FunctionType&& Function) const
+	{
+		if (ItemPositions.Num() == 0)
+		{
+			return;
+		}
+
+		// Items are only stored in the cell of their center, so widen the search by the largest item radius
+		const int32 MinCellX = GetCellX(Box.Min.X - MaxItemRadius);
+		const int32 MaxCellX = GetCellX(Box.Max.X + MaxItemRadius);
+		const int32 MinCellY = GetCellY(Box.Min.Y - MaxItemRadius);
+		const int32 MaxCellY = GetCellY(Box.Max.Y + MaxItemRadius);
+
+		for (int32 CellY = MinCellY; CellY <= MaxCellY; ++CellY)
+		{
+			for (int32 CellX = MinCellX; CellX <= MaxCellX; ++CellX)
+			{
+				const int32 CellIndex = CellY * NumCellsX + CellX;
+				for (int32 i = CellStarts[CellIndex]; i < CellStarts[CellIndex + 1]; ++i)
+				{
+					Function(CellItems[i]);
+				}
+			}
+		}
+	}
+
+	// Returns the item whose position is nearest to Center, within MaxDistance, for which Filter(ItemIndex) returns true.
+	// Returns INDEX_NONE if there is none. Searches rings of cells outwards from the center's cell, and stops as soon as no
+	// unvisited cell can hold a nearer item. Does not modify the grid, so it is safe to call from several threads at once.
+	template<typename FilterType>
+	int32 FindNearest(const FVector2D& Center, double MaxDistance, FilterType&& Filter) const
+	{
+		if (ItemPositions.Num() == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		const double CellSize = 1.0 / InvCellSize;
+		const int32 CenterCellX = GetCellX(Center.X);
+		const int32 CenterCellY = GetCellY(Center.Y);
+		const int32 MaxRing = FMath::Min(FMath::Max(NumCellsX, NumCellsY), FMath::CeilToInt32(MaxDistance * InvCellSize) + 1);
+
+		int32 NearestItemIndex = INDEX_NONE;
+		double NearestDistanceSquared = MaxDistance * MaxDistance;
+		auto VisitCell = [&](int32 CellX, int32 CellY)
+		{
+			const int32 CellIndex = CellY * NumCellsX + CellX;
+			for (int32 i = CellStarts[CellIndex]; i < CellStarts[CellIndex + 1]; ++i)
+			{
+				const int32 ItemIndex = CellItems[i];
+				const double DistanceSquared = FVector2D::DistSquared(Center, ItemPositions[ItemIndex]);
+				if (DistanceSquared <= NearestDistanceSquared && Filter(ItemIndex))
+				{
+					NearestItemIndex = ItemIndex;
+					NearestDistanceSquared = DistanceSquared;
+				}
+			}
+		};
+
+		for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+		{
+			// Every cell of this ring is at least (Ring - 1) cells away from the center
+			if (NearestItemIndex != INDEX_NONE && FMath::Square((Ring - 1) * CellSize) > NearestDistanceSquared)
+			{
+				break;
+			}
+
+			const int32 MinCellX = CenterCellX - Ring;
+			const int32 MaxCellX = CenterCellX + Ring;
+			const int32 MinCellY = CenterCellY - Ring;
+			const int32 MaxCellY = CenterCellY + Ring;
+			for (int32 CellY = FMath::Max(MinCellY, 0); CellY <= FMath::Min(MaxCellY, NumCellsY - 1); ++CellY)
+			{
+				if (CellY == MinCellY || CellY == MaxCellY)
+				{
+					// Top and bottom rows of the ring
+					for (int32 CellX = FMath::Max(MinCellX, 0); CellX <= FMath::Min(MaxCellX, NumCellsX - 1); ++CellX)
+					{
+						VisitCell(CellX, CellY);
+					}
+				}
+				else
+				{
+					// Rows in between only touch the ring at its left and right columns
+					if (MinCellX >= 0)
+					{
+						VisitCell(MinCellX, CellY);
+					}
+					if (MaxCellX < NumCellsX)
+					{
+						VisitCell(MaxCellX, CellY);
+					}
+				}
+			}
+		}
+		return NearestItemIndex;
+	}
+
+private:
+	int32 GetCellX(double X) const { return FMath::Clamp(FMath::FloorToInt32((X - Bounds.Min.X) * InvCellSize), 0, NumCellsX - 1); }
+	int32 GetCellY(double Y) const { return FMath::Clamp(FMath::FloorToInt32((Y - Bounds.Min.Y) * InvCellSize), 0, NumCellsY - 1); }
+
+private:
+	FBox2D Bounds = FBox2D(ForceInit);
+	double InvCellSize = 0.0;
+	int32 NumCellsX = 0;
+	int32 NumCellsY = 0;
+
+	// CellItems[CellStarts[i], CellStarts[i + 1]) are the items in cell i. Has one more entry than there are cells.
+	TArray<int32> CellStarts;
+	TArray<int32> CellItems;
+
+	// Cell of each item. Only used while building.
+	TArray<int32> ItemCells;
+
+	TArray<FVector2D> ItemPositions;
+	TArray<float> ItemRadii;
+	float MaxItemRadius = 0.0f;
+};
@@ -4,3 +4,5 @@
 
 #include "CoreMinimal.h"
 
+// Stat group for gameplay systems. View in-game with "stat SpaceShooter".
+DECLARE_STATS_GROUP(TEXT("SpaceShooter"), STATGROUP_SpaceShooter, STATCAT_Advanced);